@@ -56,6 +56,7 @@
 */
 #include "wiringPi.h"
 #include "ewrte.h"
+#include "ew_bsp_event.h"
 
 /*
    Create a static variable to keep the global instance (autoobject) of the
@@ -78,18 +79,31 @@
 #define BUTTON_GPIO 3
 
 
+/*
+   Interrupt handler of the hardware button. The handler is called by wiringPi
+   within its own thread - therefore the GUI application is not accessed here.
+   Instead, the GUI thread is woken up to evaluate the new button state within
+   DeviceDriver_ProcessData().
+*/
+static void ButtonInterruptHandler( void )
+{
+  EwBspEventTrigger();
+}
+
+
 #endif
 
 
 /*******************************************************************************
 * FUNCTION:
-*   DeviceDriver_Initialize
+*   DeviceDriver_InitializeHardware
 *
 * DESCRIPTION:
-*   The function DeviceDriver_Initialize() initializes the module and prepares all
-*   necessary things to access or communicate with the real device.
-*   The function has to be called from your main module, after the initialization
-*   of your GUI application.
+*   The function DeviceDriver_InitializeHardware() prepares the real device
+*   without accessing the GUI application (e.g. the setup of the GPIOs).
+*   The function is executed by a worker thread concurrently to the
+*   initialization of the display and the Graphics Engine. It has finished,
+*   before DeviceDriver_Initialize() is called.
 *
 * ARGUMENTS:
 *   None
@@ -98,11 +112,12 @@
 *   None
 *
 *******************************************************************************/
-void DeviceDriver_Initialize( void )
+void DeviceDriver_InitializeHardware( void )
 {
   /*
-     You can implement here the necessary code to initialize your particular
-     hardware, to open needed devices, to open communication channels, etc.
+     You can implement here the time consuming initialization of your
+     particular hardware, that does not need the GUI application, e.g. to
+     open devices or to load firmware.
   */
 
 #ifdef _ApplicationDeviceClass_
@@ -117,6 +132,41 @@ void DeviceDriver_Initialize( void )
   pinMode( BUTTON_GPIO, INPUT );
   pullUpDnControl( BUTTON_GPIO, PUD_UP );
 
+  /* Resume the GUI thread whenever the button is pressed or released */
+  wiringPiISR( BUTTON_GPIO, INT_EDGE_BOTH, ButtonInterruptHandler );
+
+#endif
+
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DeviceDriver_Initialize
+*
+* DESCRIPTION:
+*   The function DeviceDriver_Initialize() initializes the module and prepares all
+*   necessary things to access or communicate with the real device.
+*   The function has to be called from your main module, after the initialization
+*   of your GUI application. The hardware is already prepared by the function
+*   DeviceDriver_InitializeHardware().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DeviceDriver_Initialize( void )
+{
+  /*
+     You can implement here the necessary code to initialize your particular
+     hardware, to open needed devices, to open communication channels, etc.
+  */
+
+#ifdef _ApplicationDeviceClass_
+
   /*
      Get access to the counterpart of this device driver: get access to the
      device class that is created as autoobject within your Embedded Wizard
@@ -44,6 +44,27 @@
 #endif
 
 
+/*******************************************************************************
+* FUNCTION:
+*   DeviceDriver_InitializeHardware
+*
+* DESCRIPTION:
+*   The function DeviceDriver_InitializeHardware() prepares the real device
+*   without accessing the GUI application (e.g. the setup of the GPIOs).
+*   The function is executed by a worker thread concurrently to the
+*   initialization of the display and the Graphics Engine. It has finished,
+*   before DeviceDriver_Initialize() is called.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DeviceDriver_InitializeHardware( void );
+
+
 /*******************************************************************************
 * FUNCTION:
 *   DeviceDriver_Initialize
@@ -52,7 +73,8 @@
 *   The function DeviceDriver_Initialize() initializes the module and prepares all
 *   necessary things to access or communicate with the real device.
 *   The function has to be called from your main module, after the initialization
-*   of your GUI application.
+*   of your GUI application. The hardware is already prepared by the function
+*   DeviceDriver_InitializeHardware().
 *
 * ARGUMENTS:
 *   None
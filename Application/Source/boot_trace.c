@@ -0,0 +1,481 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template records the startup of the application - from the start of
+*   the process until the first frame of the UI is on the screen. Each phase
+*   of the initialization is recorded with its thread, begin and end. With the
+*   first page flip, the phases are written as Chrome trace events (JSON) to
+*   the file EW_BOOT_TRACE_FILE and printed as table. All times are given in
+*   microseconds since the boot of the system (CLOCK_BOOTTIME).
+*
+*   Phases without dependencies to the Graphics Engine (e.g. the setup of the
+*   GPIOs or the prefetch of the resources) are started as boot tasks on own
+*   worker threads. They run concurrently to the initialization of the display
+*   and the Graphics Engine until they are joined by BootTaskWait(). The
+*   waiting time is recorded as separate phase - it belongs to the critical
+*   path to the first frame.
+*
+*   The boot trace is selected by EW_BOOT_TRACE or at runtime by the
+*   environment variable EW_BOOT_TRACE ("off" or "on"). The boot tasks run
+*   concurrently in any case.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "boot_trace.h"
+
+#ifndef EW_BOOT_TRACE
+  #define EW_BOOT_TRACE               1
+#endif
+
+#ifndef EW_BOOT_TRACE_FILE
+  #define EW_BOOT_TRACE_FILE          "/tmp/ew_boot_trace.json"
+#endif
+
+/* maximum number of recorded phases and concurrent boot tasks */
+#define NO_OF_PHASES                  64
+#define NO_OF_TASKS                   8
+
+typedef struct
+{
+  const char*   Name;
+  int           Thread;    /* id of the recording thread */
+  int64_t       Begin;     /* time in us since boot */
+  atomic_llong  End;       /* 0 as long as the phase is running */
+} XBootPhase;
+
+typedef struct
+{
+  const char*   Name;
+  XBootTaskProc Proc;
+  pthread_t     Thread;
+  int           Joinable;  /* the task runs on its own thread */
+  char          WaitName[ 48 ];
+} XBootTask;
+
+/* the phases are recorded by the boot tasks too - a phase is published by
+   incrementing NoOfPhases under the lock, after its fields are written */
+static int             Enabled  = 0;
+static atomic_int      Finished;
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+static XBootPhase      Phases[ NO_OF_PHASES ];
+static unsigned int    NoOfPhases;
+static XBootTask       Tasks[ NO_OF_TASKS ];
+static int             NoOfTasks   = 0;
+static int64_t         ExecTime    = 0;  /* start of the process in us since boot */
+static int64_t         ClockOffset = 0;  /* CLOCK_BOOTTIME - CLOCK_MONOTONIC in us */
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the current time of the given clock in microseconds
+ */
+static int64_t GetTime( clockid_t aClock )
+{
+  struct timespec ts;
+
+  clock_gettime( aClock, &ts );
+
+  return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/*
+ * helper function to get the id of the calling thread as shown by ps or top
+ */
+static int GetThread( void )
+{
+  return (int)syscall( SYS_gettid );
+}
+
+
+/*
+ * helper function to get the start of the process in us since boot - the
+ * kernel provides it in clock ticks (field 22 of /proc/self/stat)
+ */
+static int64_t GetExecTime( void )
+{
+  char                buf[ 512 ];
+  char*               p;
+  unsigned long long  ticks = 0;
+  FILE*               file  = fopen( "/proc/self/stat", "r" );
+  size_t              size  = 0;
+
+  if ( file )
+  {
+    size = fread( buf, 1, sizeof( buf ) - 1, file );
+    fclose( file );
+  }
+
+  buf[ size ] = 0;
+
+  /* the name of the command may contain spaces - skip it */
+  p = strrchr( buf, ')' );
+
+  if ( !p || ( sscanf( p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u "
+       "%*d %*d %*d %*d %*d %*d %llu", &ticks ) != 1 ))
+    return GetTime( CLOCK_BOOTTIME );
+
+  return (int64_t)( ticks * 1000000ULL / sysconf( _SC_CLK_TCK ));
+}
+
+
+/*
+ * helper function to record a phase - aEnd is 0 as long as the phase is
+ * running. Returns the handle of the phase or 0 if it is not recorded
+ */
+static int AddPhase( const char* aName, int64_t aBegin, int64_t aEnd )
+{
+  XBootPhase* phase;
+  int         handle = 0;
+
+  pthread_mutex_lock( &Lock );
+
+  /* the storage is exhausted - the further phases are not recorded */
+  if ( !atomic_load( &Finished ) && ( NoOfPhases < NO_OF_PHASES ))
+  {
+    phase         = &Phases[ NoOfPhases ];
+    phase->Name   = aName;
+    phase->Thread = GetThread();
+    phase->Begin  = aBegin;
+    atomic_store( &phase->End, aEnd );
+    handle        = ++NoOfPhases;
+  }
+
+  pthread_mutex_unlock( &Lock );
+
+  return handle;
+}
+
+
+/*
+ * thread function of a boot task
+ */
+static void* TaskThread( void* aArg )
+{
+  XBootTask* task  = (XBootTask*)aArg;
+  int        phase = BootTraceBegin( task->Name );
+
+  task->Proc();
+  BootTraceEnd( phase );
+
+  return NULL;
+}
+
+
+/*
+ * helper function to write the recorded phases as Chrome trace events - the
+ * file can be opened by chrome://tracing or Perfetto
+ */
+static void WriteTrace( unsigned int aCount )
+{
+  FILE*        file = fopen( EW_BOOT_TRACE_FILE, "w" );
+  XBootPhase*  phase;
+  int64_t      end;
+  int          pid  = getpid();
+  unsigned int i;
+  int          ok;
+
+  if ( !file )
+  {
+    EwPrint( "BootTrace: Cannot create %s!\n", EW_BOOT_TRACE_FILE );
+    return;
+  }
+
+  ok = fprintf( file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+    "{\"name\":\"Exec\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%d,\"tid\":%d,\"ts\":%lld}",
+    pid, pid, (long long)ExecTime ) > 0;
+
+  /* phases, that are still running, are left out */
+  for ( i = 0; ok && ( i < aCount ); i++ )
+  {
+    phase = &Phases[ i ];
+    end   = atomic_load( &phase->End );
+
+    if ( end )
+      ok = fprintf( file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+        "\"ts\":%lld,\"dur\":%lld}", phase->Name, pid, phase->Thread,
+        (long long)phase->Begin, (long long)( end - phase->Begin )) > 0;
+  }
+
+  ok = ok && ( fprintf( file, "\n]}\n" ) > 0 );
+
+  if (( fclose( file ) != 0 ) || !ok )
+    EwPrint( "BootTrace: Cannot write %s!\n", EW_BOOT_TRACE_FILE );
+  else
+    EwPrint( "BootTrace: %u phases written to %s\n", aCount, EW_BOOT_TRACE_FILE );
+}
+
+
+/*
+ * helper function to print the recorded phases relative to the start of the
+ * process - the phases of the main thread form the critical path
+ */
+static void PrintTrace( unsigned int aCount, int64_t aFirstFlip )
+{
+  XBootPhase*  phase;
+  int64_t      end;
+  int          pid = getpid();
+  unsigned int i;
+
+  EwPrint( "Boot trace: first flip %u ms after boot, %u ms after exec\n",
+    (unsigned int)( aFirstFlip / 1000 ), (unsigned int)(( aFirstFlip - ExecTime ) / 1000 ));
+  EwPrint( "  %-32s %8s %10s %10s\n", "Phase", "Thread", "Begin [us]", "Time [us]" );
+
+  for ( i = 0; i < aCount; i++ )
+  {
+    phase = &Phases[ i ];
+    end   = atomic_load( &phase->End );
+
+    if ( phase->Thread == pid )
+      EwPrint( "  %-32s %8s ", phase->Name, "main" );
+    else
+      EwPrint( "  %-32s %8d ", phase->Name, phase->Thread );
+
+    if ( end )
+      EwPrint( "%10u %10u\n", (unsigned int)( phase->Begin - ExecTime ),
+        (unsigned int)( end - phase->Begin ));
+    else
+      EwPrint( "%10u    running\n", (unsigned int)( phase->Begin - ExecTime ));
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceInit
+*
+* DESCRIPTION:
+*   The function BootTraceInit starts the recording of the boot trace. The
+*   start of the process is taken from the kernel. The function has to be
+*   called at the very beginning of main().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceInit( void )
+{
+  int64_t now = GetTime( CLOCK_BOOTTIME );
+
+  Enabled = EwGetEnvSwitch( "EW_BOOT_TRACE", EW_BOOT_TRACE );
+
+  NoOfTasks   = 0;
+  NoOfPhases  = 0;
+  ClockOffset = now - GetTime( CLOCK_MONOTONIC );
+  ExecTime    = GetExecTime();
+  atomic_store( &Finished, 0 );
+
+  /* loading and relocation of the executable and its libraries */
+  AddPhase( "Load", ExecTime, now );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceBegin
+*
+* DESCRIPTION:
+*   The function BootTraceBegin records the begin of a phase within the
+*   calling thread. The function can be called by any thread.
+*
+* ARGUMENTS:
+*   aName - Name of the phase. The string has to remain valid until the boot
+*     trace is written.
+*
+* RETURN VALUE:
+*   Returns the handle of the phase to pass to BootTraceEnd() or 0 if the
+*   phase is not recorded.
+*
+*******************************************************************************/
+int BootTraceBegin( const char* aName )
+{
+  if ( !Enabled || atomic_load( &Finished ))
+    return 0;
+
+  return AddPhase( aName, GetTime( CLOCK_BOOTTIME ), 0 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceEnd
+*
+* DESCRIPTION:
+*   The function BootTraceEnd records the end of a phase started by the
+*   function BootTraceBegin().
+*
+* ARGUMENTS:
+*   aPhase - Handle of the phase returned by BootTraceBegin().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceEnd( int aPhase )
+{
+  if (( aPhase > 0 ) && ( aPhase <= NO_OF_PHASES ))
+    atomic_store( &Phases[ aPhase - 1 ].End, GetTime( CLOCK_BOOTTIME ));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceFirstFlip
+*
+* DESCRIPTION:
+*   The function BootTraceFirstFlip has to be called when a frame of the UI is
+*   on the screen. The first call completes the boot trace - the recorded
+*   phases are written and printed. Further calls are ignored.
+*
+* ARGUMENTS:
+*   aTime - Time of the vertical blank, the frame was shown with, in
+*     microseconds (CLOCK_MONOTONIC).
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceFirstFlip( long long aTime )
+{
+  unsigned int count;
+  int64_t      flip = aTime + ClockOffset;
+
+  if ( !Enabled || atomic_load( &Finished ))
+    return;
+
+  AddPhase( "First flip", flip, flip );
+
+  /* the phases, that begin from now, are not recorded anymore - the recorded
+     ones are not modified except their end */
+  pthread_mutex_lock( &Lock );
+  atomic_store( &Finished, 1 );
+  count = NoOfPhases;
+  pthread_mutex_unlock( &Lock );
+
+  WriteTrace( count );
+  PrintTrace( count, flip );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTaskStart
+*
+* DESCRIPTION:
+*   The function BootTaskStart executes the given function on a new worker
+*   thread and records it as phase. If no thread can be created, the function
+*   is executed immediately.
+*
+* ARGUMENTS:
+*   aName - Name of the task. The string has to remain valid until the boot
+*     trace is written.
+*   aProc - Function to execute.
+*
+* RETURN VALUE:
+*   Returns the handle of the task to pass to BootTaskWait().
+*
+*******************************************************************************/
+int BootTaskStart( const char* aName, XBootTaskProc aProc )
+{
+  XBootTask* task;
+  int        phase;
+
+  /* too many tasks - the further ones are executed sequentially */
+  if ( NoOfTasks >= NO_OF_TASKS )
+  {
+    phase = BootTraceBegin( aName );
+    aProc();
+    BootTraceEnd( phase );
+    return 0;
+  }
+
+  task       = &Tasks[ NoOfTasks++ ];
+  task->Name = aName;
+  task->Proc = aProc;
+
+  snprintf( task->WaitName, sizeof( task->WaitName ), "Wait for %s", aName );
+
+  task->Joinable = !pthread_create( &task->Thread, NULL, TaskThread, task );
+
+  if ( !task->Joinable )
+    TaskThread( task );
+
+  return NoOfTasks;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTaskWait
+*
+* DESCRIPTION:
+*   The function BootTaskWait waits until the given task has finished. The
+*   waiting time is recorded as phase.
+*
+* ARGUMENTS:
+*   aTask - Handle of the task returned by BootTaskStart().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTaskWait( int aTask )
+{
+  XBootTask* task;
+  int        phase;
+
+  if (( aTask <= 0 ) || ( aTask > NoOfTasks ) || !Tasks[ aTask - 1 ].Joinable )
+    return;
+
+  task  = &Tasks[ aTask - 1 ];
+  phase = BootTraceBegin( task->WaitName );
+
+  pthread_join( task->Thread, NULL );
+  task->Joinable = 0;
+
+  BootTraceEnd( phase );
+}
+
+
+/* msy */
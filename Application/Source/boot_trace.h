@@ -0,0 +1,204 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template records the startup of the application - from the start of
+*   the process until the first frame of the UI is on the screen. Each phase
+*   of the initialization is recorded with its thread, begin and end. With the
+*   first page flip, the phases are written as Chrome trace events (JSON) to
+*   the file EW_BOOT_TRACE_FILE and printed as table. All times are given in
+*   microseconds since the boot of the system (CLOCK_BOOTTIME).
+*
+*   Phases without dependencies to the Graphics Engine (e.g. the setup of the
+*   GPIOs or the prefetch of the resources) are started as boot tasks on own
+*   worker threads. They run concurrently to the initialization of the display
+*   and the Graphics Engine until they are joined by BootTaskWait(). The
+*   waiting time is recorded as separate phase - it belongs to the critical
+*   path to the first frame.
+*
+*   The boot trace is selected by EW_BOOT_TRACE or at runtime by the
+*   environment variable EW_BOOT_TRACE ("off" or "on"). The boot tasks run
+*   concurrently in any case.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/* function executed by a boot task */
+typedef void (*XBootTaskProc)( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceInit
+*
+* DESCRIPTION:
+*   The function BootTraceInit starts the recording of the boot trace. The
+*   start of the process is taken from the kernel. The function has to be
+*   called at the very beginning of main().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceBegin
+*
+* DESCRIPTION:
+*   The function BootTraceBegin records the begin of a phase within the
+*   calling thread. The function can be called by any thread.
+*
+* ARGUMENTS:
+*   aName - Name of the phase. The string has to remain valid until the boot
+*     trace is written.
+*
+* RETURN VALUE:
+*   Returns the handle of the phase to pass to BootTraceEnd() or 0 if the
+*   phase is not recorded.
+*
+*******************************************************************************/
+int BootTraceBegin
+(
+  const char*                 aName
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceEnd
+*
+* DESCRIPTION:
+*   The function BootTraceEnd records the end of a phase started by the
+*   function BootTraceBegin().
+*
+* ARGUMENTS:
+*   aPhase - Handle of the phase returned by BootTraceBegin().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceEnd
+(
+  int                         aPhase
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTraceFirstFlip
+*
+* DESCRIPTION:
+*   The function BootTraceFirstFlip has to be called when a frame of the UI is
+*   on the screen. The first call completes the boot trace - the recorded
+*   phases are written and printed. Further calls are ignored.
+*
+* ARGUMENTS:
+*   aTime - Time of the vertical blank, the frame was shown with, in
+*     microseconds (CLOCK_MONOTONIC).
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTraceFirstFlip
+(
+  long long                   aTime
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTaskStart
+*
+* DESCRIPTION:
+*   The function BootTaskStart executes the given function on a new worker
+*   thread and records it as phase. If no thread can be created, the function
+*   is executed immediately.
+*
+* ARGUMENTS:
+*   aName - Name of the task. The string has to remain valid until the boot
+*     trace is written.
+*   aProc - Function to execute.
+*
+* RETURN VALUE:
+*   Returns the handle of the task to pass to BootTaskWait().
+*
+*******************************************************************************/
+int BootTaskStart
+(
+  const char*                 aName,
+  XBootTaskProc               aProc
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   BootTaskWait
+*
+* DESCRIPTION:
+*   The function BootTaskWait waits until the given task has finished. The
+*   waiting time is recorded as phase.
+*
+* ARGUMENTS:
+*   aTask - Handle of the task returned by BootTaskStart().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void BootTaskWait
+(
+  int                         aTask
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* BOOT_TRACE_H */
+
+
+/* msy */
@@ -31,6 +31,16 @@
 #define EWCONFIG_H
 
 
+/* ******************************************************************************
+   The following flags can be overridden at runtime by the environment variable
+   of the same name set to "off" or "on" (see EwGetEnvSwitch()), so they can be
+   changed in the field without rebuilding the application: EW_SHADER_CACHE,
+   EW_GPU_BATCHING, EW_TEXTURE_ATLAS, EW_OPAQUE_BITMAPS, EW_OCCLUSION_CULLING,
+   EW_OVERDRAW_HEATMAP, EW_FRAME_CLOCK, EW_QUALITY_CONTROL and EW_BOOT_TRACE.
+   EW_HEAP_CHECK_MODE is overridden by the environment variable EW_HEAP_CHECK
+   set to "off", "sampled" or "full".
+   **************************************************************************** */
+
 /* ******************************************************************************
    Following macros configure the application.
 
@@ -40,12 +50,39 @@
 
    EW_USE_TERMINAL_INPUT - Flag to switch on/off the support of keyboard events
    received from a connected serial terminal.
+
+   EW_TOUCH_PREDICTION_HORIZON - Maximum time in milliseconds, the position of a
+   moving finger is extrapolated ahead to the time the next frame appears on the
+   display. The prediction compensates the latency between touch controller and
+   display while dragging or scrolling. Set to 0 to disable the prediction.
+
+   EW_BACKGROUND_CLASS - Optional name of a Core::Root derived class of the GUI
+   application, that contains the static background (e.g. wallpaper and gauge
+   backgrounds). The background is drawn into its own layer, which is shown by
+   the primary plane of the display below the UI. The UI is shown by an overlay
+   plane with transparency and its updates do not redraw the background. If no
+   suitable plane is available, the background is drawn below the UI within
+   the same framebuffer.
+
+   EW_DISPLAY_CLASSES - Optional list of Core::Root derived classes of the GUI
+   application, that are shown on the additional displays (e.g. an instrument
+   cluster beside the center display). The classes are given by EW_CLASS() and
+   separated by comma - the first class is shown on the second display and so
+   on. Each display gets its own root object in the size of the display and
+   its own viewport. The keyboard and touch events are passed to the first
+   display, which shows the application class.
    **************************************************************************** */
 #define PLATFORM_STRING       "RasPi-4B (OpenGL ES 2.0/EGL/DRM)"
 #define EW_FRAME_BUFFER_COLOR_FORMAT_STRING  "RGBA8888"
 
 #define EW_USE_TERMINAL_INPUT 1
 
+#define EW_TOUCH_PREDICTION_HORIZON 20
+
+// #define EW_BACKGROUND_CLASS   ApplicationBackground
+
+// #define EW_DISPLAY_CLASSES    EW_CLASS( ApplicationCluster )
+
 
 /* ******************************************************************************
    Following macros configure the display integration and the framebuffer access
@@ -70,6 +107,108 @@
    set 1, the Mosaic will redraw the entire content of the off-screen buffer
    each time something changes in its area. The explicit clear may improve
    the overall performance depending on the GPU hardware.
+
+   EW_USE_BUFFER_AGE - Flag to switch on/off the damage tracking. If this option
+   is set 1 and the EGL driver supports EGL_EXT_buffer_age, only the areas that
+   have changed since the back buffer was shown last time are redrawn instead
+   of the entire screen. The damage is passed to EGL via EGL_KHR_partial_update
+   and EGL_KHR_swap_buffers_with_damage, if available. Otherwise, or if the
+   screen is rotated, EW_PERFORM_FULLSCREEN_UPDATE is used.
+
+   EW_FRAME_DEADLINE_OFFSET - Time in milliseconds before the vertical blank, at
+   which the drawing of the next frame starts. Changes caused by input events,
+   device drivers, timers and signals arriving before this deadline are drawn
+   together within one frame and at most one frame is drawn per vertical
+   blank. The offset should cover the time needed to draw a frame. An offset
+   equal to the frame period draws the changes as soon as possible.
+
+   EW_USE_ATOMIC_MODESETTING - Flag to switch on/off the atomic modesetting of
+   the DRM display. If this option is set 1 and the DRM driver supports it, the
+   UI plane and the hardware overlay planes (see GfxSystemShowOverlay()) are
+   committed together within one atomic commit. Otherwise, the legacy API is
+   used and no overlays are available.
+
+   EW_RENDER_SCALE - Resolution in percent of the display size (25 .. 100), the
+   UI is rendered with. The display controller scales the framebuffer up to
+   the display, thereby the fill rate of the GPU drops with the square of the
+   scale. The scale can be overridden by the environment variable
+   EW_RENDER_SCALE and changed at runtime by EwSetRenderScale(). The scaling
+   needs atomic modesetting.
+
+   EW_SPLASH_FILE - Name of the boot splash image. The image is shown through a
+   DRM dumb buffer immediately after the display has been opened - before EGL
+   and the Graphics Engine are initialized - and is replaced by the first
+   frame of the UI. On a clean shutdown, the final frame is stored as image
+   for the next start. The name can be overridden by the environment variable
+   EW_SPLASH_FILE. An empty name disables the boot splash.
+
+   EW_SHADER_CACHE - Flag to switch on/off the shader cache. If this option is
+   set 1 and the driver supports GL_OES_get_program_binary, the binaries of the
+   linked shader programs are stored in EW_SHADER_CACHE_DIR and loaded instead
+   of compiling the shaders on the next start (see shader_cache.h).
+
+   EW_SHADER_CACHE_DIR - Directory of the program binaries. The directory is
+   created, if necessary - its parent directory has to exist.
+
+   EW_GPU_BATCHING - Flag to switch on/off the batching of the draw calls. If
+   this option is set 1, compatible drawing tasks are moved together and
+   consecutive draw calls with the same OpenGL state are submitted as one draw
+   call (see gpu_batch.h).
+
+   EW_GPU_BATCH_REPORT_FRAMES - Number of frames, after which the average
+   number of draw calls and state changes per frame is printed. Set to 0 to
+   print the statistic only on shutdown.
+
+   EW_TEXTURE_ATLAS - Flag to switch on/off the texture atlas. If this option
+   is set 1, the small bitmap resources are packed into shared textures (see
+   texture_atlas.h), so the draw calls of different icons can be batched.
+
+   EW_ATLAS_MAX_BITMAP_SIZE - Maximum width and height in pixel of a bitmap
+   resource, that is packed into the texture atlas.
+
+   EW_ATLAS_PAGE_SIZE - Width and height in pixel of an atlas page. The size
+   has to be supported as texture size by the GPU.
+
+   EW_ATLAS_MAX_PAGES - Maximum number of atlas pages. If all pages are full,
+   the least recently used page is evicted and its bitmaps get their own
+   textures.
+
+   EW_OPAQUE_BITMAPS - Flag to switch on/off the RGB565 format for opaque
+   bitmaps. If this option is set 1, bitmap resources with entirely opaque
+   frames are stored in the RGB565 format and drawn without blending (see
+   opaque_bitmap.h).
+
+   EW_OCCLUSION_CULLING - Flag to switch on/off the occlusion culling. If this
+   option is set 1, the drawing tasks hidden by opaque tasks in front of them
+   are removed or clipped, before they are executed (see occlusion.h).
+
+   EW_OCCLUSION_REPORT_FRAMES - Number of frames, after which the average
+   number of hidden tasks and the overdraw per frame is printed. Set to 0 to
+   print the statistic only on shutdown.
+
+   EW_OVERDRAW_HEATMAP - Flag to switch on/off the overdraw heatmap. If this
+   option is set 1, the number of layers drawn per pixel is shown as heatmap
+   instead of the UI and the average overdraw factor is evaluated (see
+   overdraw_heatmap.h). The heatmap can be toggled at runtime by SIGUSR2.
+
+   EW_OVERDRAW_HEATMAP_REPORT_FRAMES - Number of frames drawn as heatmap, after
+   which the average overdraw factor is printed. Set to 0 to print the factor
+   only on shutdown.
+
+   EW_FRAME_CLOCK - Flag to switch on/off the frame clock. If this option is
+   set 1, the timers and animations are driven by the predicted presentation
+   time of the frame instead of the wall time (see frame_clock.h). Thereby
+   every frame advances the animations by exactly one frame period.
+
+   EW_QUALITY_CONTROL - Flag to switch on/off the adaptive quality control. If
+   this option is set 1 and frames miss their vertical blank repeatedly, the
+   render resolution, the filtering of warped bitmaps, the update rate of the
+   additional displays and finally the frame rate are lowered step by step
+   (see quality_control.h). Every transition is reported.
+
+   EW_QUALITY_HEADROOM - Percentage of the frame budget, below which the frames
+   have to stay for EW_QUALITY_RECOVERY_FRAMES frames in a row, before the
+   quality is raised again.
    **************************************************************************** */
 #define FRAME_BUFFER_WIDTH              800
 #define FRAME_BUFFER_HEIGHT             480
@@ -81,6 +220,41 @@
 
 #define EW_PERFORM_FULLOFFSCREENBUFFER_UPDATE 1
 
+#define EW_USE_BUFFER_AGE               1
+
+#define EW_FRAME_DEADLINE_OFFSET        8
+
+#define EW_USE_ATOMIC_MODESETTING       1
+
+#define EW_RENDER_SCALE                 100
+
+#define EW_SPLASH_FILE                  "/var/lib/embedded-wizard/splash.raw"
+
+#define EW_SHADER_CACHE                 1
+#define EW_SHADER_CACHE_DIR             "/var/cache/embedded-wizard"
+
+#define EW_GPU_BATCHING                 1
+#define EW_GPU_BATCH_REPORT_FRAMES      600
+
+#define EW_TEXTURE_ATLAS                1
+#define EW_ATLAS_MAX_BITMAP_SIZE        64
+#define EW_ATLAS_PAGE_SIZE              1024
+#define EW_ATLAS_MAX_PAGES              4
+
+#define EW_OPAQUE_BITMAPS               1
+
+#define EW_OCCLUSION_CULLING            1
+#define EW_OCCLUSION_REPORT_FRAMES      600
+
+#define EW_OVERDRAW_HEATMAP             0
+#define EW_OVERDRAW_HEATMAP_REPORT_FRAMES 60
+
+#define EW_FRAME_CLOCK                  1
+
+#define EW_QUALITY_CONTROL              1
+#define EW_QUALITY_HEADROOM             60
+#define EW_QUALITY_RECOVERY_FRAMES      120
+
 /* ******************************************************************************
    Following macros configure the memory area used for the Embedded Wizard heap
    manager. Optionally, an additional extra memory pool can be defined.
@@ -100,6 +274,25 @@
 
    EW_EXTRA_POOL_SECTION, EW_EXTRA_POOL_ADDRESS and EW_EXTRA_POOL_SIZE - These
    macros are used to define a second (additional) memory pool.
+
+   EW_GC_IDLE_THRESHOLD - Amount of heap memory in bytes allocated since the last
+   garbage collection, that lets the Garbage Collector run in the idle time of
+   the GUI thread, if the expected pause fits before the next deadline.
+
+   EW_GC_PRESSURE_THRESHOLD - Percentage of free heap memory below which the
+   Garbage Collector is started immediately, even within an animation.
+
+   EW_GC_PRESSURE_MIN_GARBAGE - Amount of heap memory in bytes allocated since
+   the last garbage collection, that is required for a collection under memory
+   pressure. If such a collection frees less memory, the required amount is
+   doubled, so a large live set does not cause a collection after every frame.
+
+   EW_GC_QUIET_TIME - Time in milliseconds without any activity, after which the
+   pending garbage is collected regardless of the amount and the idle time.
+
+   EW_GC_MAX_INTERVAL - Time in milliseconds, after which the pending garbage is
+   collected at the latest, if the memory pressure is unknown (without memory
+   pools).
    **************************************************************************** */
 #define EW_MEMORY_POOL_SECTION
 #define EW_MEMORY_POOL_SIZE      ( 8 * 1024 * 1024 )
@@ -107,12 +300,43 @@
 #define EW_EXTRA_POOL_ADDR       0
 #define EW_EXTRA_POOL_SIZE       0
 
+#define EW_GC_IDLE_THRESHOLD     ( 64 * 1024 )
+#define EW_GC_PRESSURE_THRESHOLD 20
+#define EW_GC_PRESSURE_MIN_GARBAGE ( 16 * 1024 )
+#define EW_GC_QUIET_TIME         250
+#define EW_GC_MAX_INTERVAL       5000
+
 
 /* ******************************************************************************
    Following macros configure advance aspects of an Embedded Wizard application
    used for profiling, tracing or optimization purpose. In order to enable the
    functionality uncomment the respective macro definition below.
 
+   EW_FRAME_PROFILER_FRAMES - Number of recent frames recorded by the frame
+   profiler. For every frame the duration of the single phases of the main loop
+   is measured. The statistic is printed on shutdown and the recorded frames are
+   written to the file EW_FRAME_PROFILER_FILE when the process receives SIGUSR1.
+   The overhead is low enough to keep the profiler enabled in production builds.
+   Set to 0 to disable the frame profiler.
+
+   EW_FRAME_PROFILER_FILE - Path of the binary file written on SIGUSR1.
+
+   EW_BOOT_TRACE - Flag to switch on/off the boot trace. If this option is set
+   1, the phases of the startup - from the start of the process until the first
+   frame is on the screen - are recorded with their threads and printed on the
+   first page flip (see boot_trace.h).
+
+   EW_BOOT_TRACE_FILE - Path of the JSON file with the recorded phases in the
+   Chrome trace event format (chrome://tracing or Perfetto).
+
+   EW_HEAP_CHECK_MODE - Verification of the heap integrity after the frames:
+   0 = off, 1 = sampled (every EW_HEAP_CHECK_INTERVAL-th frame), 2 = full (every
+   frame). A found corruption is reported with the frame number and the recent
+   allocations.
+
+   EW_HEAP_CHECK_INTERVAL - Number of frames between two heap verifications in
+   the sampled mode.
+
    EW_PRINT_MEMORY_USAGE - If this macro is defined, a statistic information is
    printed reporting the amount of memory allocated by Chora objects, strings and
    resources. Additionally, the current total memory allocation and the maximum
@@ -153,6 +377,15 @@
    the function EwSetStackBaseAddress() to inform the Garbage Collector about the
    memory area occupied by the CPU stack.
    **************************************************************************** */
+#define EW_FRAME_PROFILER_FRAMES      512
+#define EW_FRAME_PROFILER_FILE        "/tmp/ew_frame_profile.bin"
+
+#define EW_BOOT_TRACE                 1
+#define EW_BOOT_TRACE_FILE            "/tmp/ew_boot_trace.json"
+
+#define EW_HEAP_CHECK_MODE            1
+#define EW_HEAP_CHECK_INTERVAL        60
+
 // #define EW_PRINT_MEMORY_USAGE
 // #define EW_DUMP_HEAP
 
@@ -65,6 +65,9 @@
 *
 *******************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "ewconfig.h"
@@ -75,8 +78,21 @@
 #include "ew_bsp_display.h"
 #include "ew_bsp_touch.h"
 #include "ew_bsp_console.h"
+#include "ew_bsp_event.h"
 
 #include "DeviceDriver.h"
+#include "boot_trace.h"
+#include "frame_clock.h"
+#include "frame_profiler.h"
+#include "gc_scheduler.h"
+#include "gpu_batch.h"
+#include "heap_check.h"
+#include "occlusion.h"
+#include "opaque_bitmap.h"
+#include "overdraw_heatmap.h"
+#include "quality_control.h"
+#include "shader_cache.h"
+#include "texture_atlas.h"
 
 
 /* memory pool */
@@ -93,29 +109,98 @@
   #define EW_EXTRA_POOL_ADDR EwExtraMemory
 #endif
 
+/* on failure, EwInit() continues with joining the started boot tasks */
 #define CHECK_HANDLE( handle ) \
   if ( !handle )               \
   {                            \
     EwPrint( "[failed]\n" );   \
-    return 0;                  \
+    goto failed;               \
   }                            \
   else                         \
     EwPrint( "[OK]\n" );
 
+/* measure the duration of the single phases of the main loop */
+#if EW_FRAME_PROFILER_FRAMES > 0
+  #define PROFILE_BEGIN()       FrameProfilerBegin()
+  #define PROFILE_MARK( phase ) FrameProfilerMark( phase )
+  #define PROFILE_END()         FrameProfilerEnd()
+#else
+  #define PROFILE_BEGIN()
+  #define PROFILE_MARK( phase )
+  #define PROFILE_END()
+#endif
+
+/* the phases of the initialization are recorded by the boot trace - each
+   phase ends with the begin of the next one */
+#define BOOT_PHASE( name )      BootTraceEnd( bootPhase ), bootPhase = BootTraceBegin( name )
+
+/* the damage tracking is available for not rotated screens only */
+#if ( EW_USE_BUFFER_AGE == 1 ) && ( EW_ROTATION == 0 )
+  #define DAMAGE_HISTORY_SIZE 4
+#endif
+
+/* maximum number of displays - each display shows its own root object */
+#define MAX_NO_OF_DISPLAYS    4
+
+typedef struct
+{
+  void*       Surface;
+  int32_t     Framebuffer;
+  int32_t     Width;
+  int32_t     Height;
+  XPoint      Size;        /* size of the root object */
+  CoreRoot    RootObject;
+  XViewport*  Viewport;
+  #ifdef DAMAGE_HISTORY_SIZE
+    XRect     Damage;                               /* changes of the current frame */
+    XRect     DamageHistory[ DAMAGE_HISTORY_SIZE ]; /* changes of the recent frames */
+  #endif
+} XDisplay;
+
 /* helper functions used within this module */
-static void EwUpdate( XViewport* aViewport, CoreRoot aApplication );
-static void ViewportProc( XViewport* aViewport, unsigned long aHandle,
+static int  EwDoesNeedUpdate( void );
+static void EwUpdate( XDisplay* aDisplay );
+static void EwResetViewport( XDisplay* aDisplay );
+static void EwUpdateDisplays( void );
+static void EwPrefetchResources( void );
+#ifdef DAMAGE_HISTORY_SIZE
+  static void  EwUpdateDamage( XDisplay* aDisplay );
+  static XRect EwScaleArea( XDisplay* aDisplay, XRect aArea );
+#endif
+#ifdef EW_BACKGROUND_CLASS
+  static void EwUpdateBackground( void );
+  static void EwDrawBackground( GraphicsCanvas aCanvas, XRect aArea );
+  static void BackgroundProc( XViewport* viewport, unsigned long aHandle,
+    void* aDisplay1, void* aDisplay2, void* aDisplay3, XRect aArea );
+#endif
+static void ViewportProc( XViewport* viewport, unsigned long aHandle,
   void* aDisplay1, void* aDisplay2, void* aDisplay3, XRect aArea );
 static XEnum EwGetKeyCommand( void );
 
 
 static void*      EglDisplay  = 0;
-static void*      EglSurface  = 0;
-static int32_t    Framebuffer = 0xFFFFFFFF;
-static int32_t    Width       = -1;
-static int32_t    Height      = -1;
-static CoreRoot   RootObject;
-static XViewport* Viewport;
+static XDisplay   Displays[ MAX_NO_OF_DISPLAYS ];
+static int        NoOfDisplays   = 0;
+static int        RenderScale    = 100;  /* render resolution in percent */
+static uint32_t   NoOfFrames     = 0;  /* number of drawn frames */
+static int        PendingChanges = 0;  /* changes to draw with the next frame */
+static int        PrefetchTask   = 0;  /* boot task reading the executable */
+
+/* root classes of the additional displays */
+#ifdef EW_DISPLAY_CLASSES
+  static const XClass DisplayClasses[] = { EW_DISPLAY_CLASSES };
+#endif
+
+#ifdef EW_BACKGROUND_CLASS
+  static CoreRoot   BackgroundObject;
+  static XViewport* BackgroundViewport    = 0;  /* viewport of the background layer */
+  static void*      BackgroundSurface     = 0;
+  static int32_t    BackgroundFramebuffer = 0xFFFFFFFF;
+#endif
+
+#ifdef DAMAGE_HISTORY_SIZE
+  static int      UseBufferAge = 0;
+#endif
 
 
 /*******************************************************************************
@@ -138,52 +223,206 @@ static XViewport* Viewport;
 *******************************************************************************/
 int EwInit( void )
 {
+  XDisplay* display   = &Displays[ 0 ];
+  int       bootPhase = 0;
+  int       gpioTask   = 0;
+  int       shaderTask = 0;
+  int       width;
+  int       height;
+  int       i;
+
+  /* initialize the event handling used to suspend the GUI thread */
+  BOOT_PHASE( "Event loop" );
+  EwPrint( "Initialize Event Loop...                     " );
+  CHECK_HANDLE( EwBspEventInit());
+
+  #if EW_USE_TERMINAL_INPUT == 1
+    /* resume the GUI thread when a key is received from the console */
+    EwBspEventAddSource( 0 );
+  #endif
+
+  /* the hardware and the page cache are prepared by worker threads, while
+     the display and the Graphics Engine are initialized */
+  gpioTask     = BootTaskStart( "GPIO setup", DeviceDriver_InitializeHardware );
+  PrefetchTask = BootTaskStart( "Resource prefetch", EwPrefetchResources );
+  shaderTask   = BootTaskStart( "Shader cache", ShaderCacheInit );
+
+  /* collect the draw calls of the OpenGL adaptation - from the creation of
+     the OpenGL context on */
+  GpuBatchInit();
+
+  /* pack the small bitmap resources into shared textures */
+  TextureAtlasInit();
+  OpaqueBitmapInit();
+  OcclusionInit();
+  OverdrawHeatmapInit();
+
   /* initialize display */
+  BOOT_PHASE( "Display" );
   EwPrint( "Initialize Display...                        " );
-  CHECK_HANDLE( EwBspDisplayInit( &EglDisplay, &EglSurface, &Framebuffer, &Width, &Height ));
+  CHECK_HANDLE( EwBspDisplayInit( &EglDisplay, &display->Surface, &display->Framebuffer,
+    &display->Width, &display->Height ));
+
+  /* the UI may be rendered at reduced resolution - the touch events are
+     reported in the coordinates of the display, not of the framebuffer */
+  if ( !EwBspDisplayGetSize( 0, &width, &height ))
+  {
+    width  = display->Width;
+    height = display->Height;
+  }
+
+  RenderScale = ( display->Width * 100 + width / 2 ) / width;
 
-  /* initialize touchscreen */
+  /* initialize touchscreen - the touch events belong to the first display */
+  BOOT_PHASE( "Touch driver" );
   EwPrint( "Initialize Touch Driver...                   " );
-  EwBspTouchInit( EwScreenSize.X, EwScreenSize.Y, Width, Height );
+  EwBspTouchInit( EwScreenSize.X, EwScreenSize.Y, width, height );
   EwPrint( "[OK]\n" );
 
+  /* select the heap verification - the allocations are recorded from now */
+  BOOT_PHASE( "Memory manager" );
+  HeapCheckInit();
+
   #if EW_MEMORY_POOL_SIZE > 0
-    /* initialize heap manager */
+    /* initialize heap manager and provide its memory to EwAlloc() */
     EwPrint( "Initialize Memory Manager...                 " );
     EwInitHeap( 0 );
     EwAddHeapMemoryPool( (void*)EW_MEMORY_POOL_ADDR, EW_MEMORY_POOL_SIZE );
+    HeapCheckAddPool( (void*)EW_MEMORY_POOL_ADDR, EW_MEMORY_POOL_SIZE );
 
     #if EW_EXTRA_POOL_SIZE > 0
       EwAddHeapMemoryPool( (void*)EW_EXTRA_POOL_ADDR, EW_EXTRA_POOL_SIZE );
+      HeapCheckAddPool( (void*)EW_EXTRA_POOL_ADDR, EW_EXTRA_POOL_SIZE );
     #endif
 
     EwPrint( "[OK]\n" );
   #endif
 
-  /* initialize the Graphics Engine and Runtime Environment */
+  /* initialize the Graphics Engine and Runtime Environment - its shader
+     programs are taken from the cache */
+  BOOT_PHASE( "Graphics Engine" );
+  BootTaskWait( shaderTask );
   EwPrint( "Initialize Graphics Engine...                " );
   CHECK_HANDLE( EwInitGraphicsEngine( 0 ));
 
+  #ifdef DAMAGE_HISTORY_SIZE
+    /* redraw only the damaged areas if the display knows the age of its back
+       buffers - the Mosaic has to report just the areas changed since the
+       previous frame, the older changes are tracked by EwUpdateDamage() */
+    if ( EwBspDisplayGetBufferAge( EglDisplay, display->Surface ) >= 0 )
+    {
+      UseBufferAge                 = 1;
+      EwFullScreenUpdate           = 0;
+      EwPreserveFramebufferContent = 1;
+    }
+  #endif
+
+  /* collect the garbage preferably in the idle time of the GUI thread */
+  GcSchedulerInit();
+
+  /* drive the timers and animations by the presentation time of the frames */
+  FrameClockInit();
+
+  /* lower the rendering quality, if the frames miss their vertical blank */
+  QualityControlInit( RenderScale );
+
   /* create the applications root object ... */
+  BOOT_PHASE( "Root object" );
   EwPrint( "Create Embedded Wizard Root Object...        " );
-  RootObject = (CoreRoot)EwNewObjectIndirect( EwApplicationClass, 0 );
-  CHECK_HANDLE( RootObject );
+  display->RootObject = (CoreRoot)EwNewObjectIndirect( EwApplicationClass, 0 );
+  CHECK_HANDLE( display->RootObject );
 
-  EwLockObject( RootObject );
-  CoreRoot__Initialize( RootObject, EwScreenSize );
+  EwLockObject( display->RootObject );
+  display->Size = EwScreenSize;
+  CoreRoot__Initialize( display->RootObject, display->Size );
 
   /* create Embedded Wizard viewport object to provide uniform access to the framebuffer */
+  BOOT_PHASE( "Viewport" );
   EwPrint( "Create Embedded Wizard Viewport...           " );
-  Viewport = EwInitViewport( EwScreenSize, EwNewRect( 0, 0, Width, Height ),
-    EW_ROTATION, 255, &Framebuffer, EglDisplay, EglSurface, ViewportProc );
-  CHECK_HANDLE( Viewport );
+  display->Viewport = EwInitViewport( display->Size, EwNewRect( 0, 0, display->Width,
+    display->Height ), EW_ROTATION, 255, &display->Framebuffer, EglDisplay,
+    display->Surface, ViewportProc );
+  CHECK_HANDLE( display->Viewport );
+
+  NoOfDisplays = 1;
+
+  #ifdef EW_DISPLAY_CLASSES
+    /* each additional display shows its own root object in the size of the
+       display - it is updated by its own viewport with own damage tracking */
+    BOOT_PHASE( "Additional displays" );
+    for ( i = 1; ( i < EwBspDisplayGetNoOfDisplays()) && ( i < MAX_NO_OF_DISPLAYS ) &&
+          ( i <= (int)( sizeof( DisplayClasses ) / sizeof( DisplayClasses[ 0 ]))); i++ )
+    {
+      display = &Displays[ i ];
+
+      if ( !EwBspDisplayGetSurface( i, &display->Surface, &display->Framebuffer,
+             &display->Width, &display->Height ))
+        break;
+
+      EwPrint( "Create Root Object of Display %d...           ", i );
+      display->RootObject = (CoreRoot)EwNewObjectIndirect( DisplayClasses[ i - 1 ], 0 );
+      CHECK_HANDLE( display->RootObject );
+
+      EwLockObject( display->RootObject );
+      display->Size = EwNewPoint( display->Width, display->Height );
+      CoreRoot__Initialize( display->RootObject, display->Size );
+
+      EwPrint( "Create Viewport of Display %d...              ", i );
+      display->Viewport = EwInitViewport( display->Size, EwNewRect( 0, 0, display->Width,
+        display->Height ), 0, 255, &display->Framebuffer, EglDisplay, display->Surface,
+        ViewportProc );
+      CHECK_HANDLE( display->Viewport );
+
+      NoOfDisplays++;
+    }
+  #else
+    (void)i;
+  #endif
+
+  #ifdef EW_BACKGROUND_CLASS
+    /* create the root object of the static background - if the display has a
+       separate layer for the background, it gets its own viewport */
+    BOOT_PHASE( "Background" );
+    EwPrint( "Create Embedded Wizard Background Object...  " );
+    BackgroundObject = (CoreRoot)EwNewObject( EW_BACKGROUND_CLASS, 0 );
+    CHECK_HANDLE( BackgroundObject );
+
+    EwLockObject( BackgroundObject );
+    CoreRoot__Initialize( BackgroundObject, EwScreenSize );
+
+    BackgroundSurface = EwBspDisplayGetBackgroundSurface();
+
+    if ( BackgroundSurface )
+      BackgroundViewport = EwInitViewport( EwScreenSize, EwNewRect( 0, 0, Displays[ 0 ].Width,
+        Displays[ 0 ].Height ), EW_ROTATION, 255, &BackgroundFramebuffer, EglDisplay,
+        BackgroundSurface, BackgroundProc );
+  #endif
 
-  /* initialize your device driver(s) that provide data for your GUI */
+  /* initialize your device driver(s) that provide data for your GUI - the
+     hardware has to be set up */
+  BOOT_PHASE( "Device driver" );
+  BootTaskWait( gpioTask );
   DeviceDriver_Initialize();
+  BootTraceEnd( bootPhase );
+
+  #if EW_FRAME_PROFILER_FRAMES > 0
+    FrameProfilerInit();
+  #endif
 
   EwPrint( "Starting Embedded Wizard main loop - press <p> to shutdown application...\n" );
 
   return 1;
+
+  /* the worker threads must not continue with the hardware and the resources
+     after the initialization has been given up */
+failed:
+  BootTaskWait( gpioTask );
+  BootTaskWait( PrefetchTask );
+  BootTaskWait( shaderTask );
+  BootTraceEnd( bootPhase );
+  PrefetchTask = 0;
+
+  return 0;
 }
 
 
@@ -204,21 +443,57 @@ int EwInit( void )
 *******************************************************************************/
 void EwDone( void )
 {
+  int i;
+
+  #if EW_FRAME_PROFILER_FRAMES > 0
+    FrameProfilerDone();
+  #endif
+
   /* deinitialize your device driver(s) */
   DeviceDriver_Deinitialize();
 
+  /* the prefetch may still run, if the application is stopped early */
+  BootTaskWait( PrefetchTask );
+  PrefetchTask = 0;
+
+  GcSchedulerDone();
+  QualityControlDone();
+
   /* destroy the applications root object and release unused resources and memory */
   EwPrint( "Shutting down Application...                 " );
-  EwDoneViewport( Viewport );
-  EwUnlockObject( RootObject );
+  #ifdef EW_BACKGROUND_CLASS
+    if ( BackgroundViewport )
+      EwDoneViewport( BackgroundViewport );
+
+    EwUnlockObject( BackgroundObject );
+  #endif
+
+  for ( i = NoOfDisplays - 1; i >= 0; i-- )
+  {
+    EwDoneViewport( Displays[ i ].Viewport );
+    EwUnlockObject( Displays[ i ].RootObject );
+  }
+
   EwReclaimMemory();
   EwPrint( "[OK]\n" );
 
+  /* the atlas pages are released together with their last bitmap */
+  TextureAtlasDone();
+  OpaqueBitmapDone();
+  OverdrawHeatmapDone();
+
   /* deinitialize the Graphics Engine */
   EwPrint( "Deinitialize Graphics Engine...              " );
   EwDoneGraphicsEngine();
   EwPrint( "[OK]\n" );
 
+  ShaderCacheDone();
+  GpuBatchDone();
+  OcclusionDone();
+
+  /* the memory pools must not be accessed anymore */
+  HeapCheckDone();
+
   #if EW_MEMORY_POOL_SIZE > 0
     /* deinitialize heap manager */
     EwDoneHeap();
@@ -229,7 +504,11 @@ void EwDone( void )
   EwPrint( "[OK]\n" );
 
   /* deinitialize display */
-  EwBspDisplayDone( EglDisplay, EglSurface );
+  EwBspDisplayDone( EglDisplay, Displays[ 0 ].Surface );
+  NoOfDisplays = 0;
+
+  /* deinitialize the event handling */
+  EwBspEventDone();
 }
 
 
@@ -261,6 +540,10 @@ void EwDone( void )
 int EwProcess( void )
 {
   int          timers  = 0;
+  int          i;
+  int          timeout;
+  int          gcTimeout;
+  int          frameTimeout;
   int          signals = 0;
   int          events  = 0;
   int          devices = 0;
@@ -271,10 +554,29 @@ int EwProcess( void )
   int          finger;
   XPoint       touchPos;
 
+  PROFILE_BEGIN();
+
   /* process data of your device driver(s) and update the GUI
      application by setting properties or by triggering events */
   devices = DeviceDriver_ProcessData();
 
+  /* a display has been reconnected or has changed its mode - continue with
+     its surface, the textures and caches of the Graphics Engine are kept */
+  if ( EwBspDisplayProcessHotplug())
+    EwUpdateDisplays();
+
+  /* the overdraw heatmap has been switched on or off - redraw all displays */
+  if ( OverdrawHeatmapProcess())
+    for ( i = 0; i < NoOfDisplays; i++ )
+      CoreRoot__InvalidateArea( Displays[ i ].RootObject, EwNewRect( 0, 0,
+        Displays[ i ].Size.X, Displays[ i ].Size.Y ));
+
+  /* the timers and animations of this cycle refer to the vblank, the next
+     frame is presented with */
+  FrameClockUpdate( EwBspDisplayGetNextVBlank(), EwBspDisplayGetFramePeriod());
+
+  PROFILE_MARK( FRAME_PHASE_DEVICES );
+
   /* receive keyboard inputs */
   cmd = EwGetKeyCommand();
 
@@ -284,11 +586,15 @@ int EwProcess( void )
       return 0;
 
     /* feed the application with a 'press' and 'release' event */
-    events |= CoreRoot__DriveKeyboardHitting( RootObject, cmd, 0, 1 );
-    events |= CoreRoot__DriveKeyboardHitting( RootObject, cmd, 0, 0 );
+    events |= CoreRoot__DriveKeyboardHitting( Displays[ 0 ].RootObject, cmd, 0, 1 );
+    events |= CoreRoot__DriveKeyboardHitting( Displays[ 0 ].RootObject, cmd, 0, 0 );
   }
 
-  /* receive (multi-) touch inputs and provide it to the application */
+  PROFILE_MARK( FRAME_PHASE_KEYS );
+
+  /* receive (multi-) touch inputs and provide it to the application - the
+     movements are predicted for the time the next frame is shown */
+  EwBspTouchSetPresentationTime( EwBspDisplayGetNextVBlank());
   noOfTouch = EwBspTouchGetEvents( &touchEvent );
 
   if ( noOfTouch > 0 )
@@ -302,35 +608,78 @@ int EwProcess( void )
 
       /* begin of touch cycle */
       if ( touchEvent[ touch ].State == EW_BSP_TOUCH_DOWN )
-        events |= CoreRoot__DriveMultiTouchHitting(  RootObject, 1, finger, touchPos );
+        events |= CoreRoot__DriveMultiTouchHitting(  Displays[ 0 ].RootObject, 1, finger, touchPos );
 
       /* movement during touch cycle */
       else if ( touchEvent[ touch ].State == EW_BSP_TOUCH_MOVE )
-        events |= CoreRoot__DriveMultiTouchMovement( RootObject, finger, touchPos );
+        events |= CoreRoot__DriveMultiTouchMovement( Displays[ 0 ].RootObject, finger, touchPos );
 
       /* end of touch cycle */
       else if ( touchEvent[ touch ].State == EW_BSP_TOUCH_UP )
-        events |= CoreRoot__DriveMultiTouchHitting(  RootObject, 0, finger, touchPos );
+        events |= CoreRoot__DriveMultiTouchHitting(  Displays[ 0 ].RootObject, 0, finger, touchPos );
     }
   }
 
+  PROFILE_MARK( FRAME_PHASE_TOUCH );
+
   /* process expired timers */
   timers = EwProcessTimers();
+  PROFILE_MARK( FRAME_PHASE_TIMERS );
 
   /* process the pending signals */
   signals = EwProcessSignals();
+  PROFILE_MARK( FRAME_PHASE_SIGNALS );
 
-  /* refresh the screen, if something has changed and draw its content */
+  /* collect the changes until the deadline of the next frame */
   if ( devices || timers || signals || events )
+    PendingChanges = 1;
+
+  frameTimeout = PendingChanges ? EwBspDisplayGetFrameTimeout() : -1;
+
+  /* refresh the screen once per vblank, if something has changed and draw
+     its content */
+  if (( frameTimeout == 0 ) && EwBspDisplayGetNextVBlank() && QualityControlSkipFrame())
+  {
+    /* with reduced frame rate, this vblank is left out - the changes remain
+       pending for the next one */
+    EwBspDisplayBeginFrame();
+  }
+  else if ( frameTimeout == 0 )
   {
-    if ( CoreRoot__DoesNeedUpdate( RootObject ))
-      EwUpdate( Viewport, RootObject );
+    PendingChanges = 0;
 
-    /* just for debugging purposes: check the memory structure */
-    EwVerifyHeap();
+    if ( EwDoesNeedUpdate())
+    {
+      QualityControlBeginFrame( EwBspDisplayGetNextVBlank());
+      EwBspDisplayBeginFrame();
+      NoOfFrames++;
+
+      /* under load, the additional displays are updated with reduced rate */
+      for ( i = 0; i < NoOfDisplays; i++ )
+        if ( !i || !QualityControlDefersRedraws() || !( NoOfFrames % QUALITY_DEFER_INTERVAL ))
+          EwUpdate( &Displays[ i ]);
+        else if ( CoreRoot__DoesNeedUpdate( Displays[ i ].RootObject ))
+          PendingChanges = 1;
+
+      /* the collected draw calls are counted per frame */
+      GpuBatchEndFrame();
+      OcclusionEndFrame();
+
+      /* the next quality level takes effect with the next frame */
+      if ( QualityControlEndFrame())
+        EwSetRenderScale( QualityControlGetRenderScale());
+    }
+
+    PROFILE_MARK( FRAME_PHASE_UPDATE );
 
-    /* after each processed message start the garbage collection */
-    EwReclaimMemory();
+    /* check the memory structure - every frame or sampled, see ewconfig.h */
+    HeapCheckProcess();
+    PROFILE_MARK( FRAME_PHASE_VERIFY );
+
+    /* start the garbage collection only under memory pressure - otherwise it
+       is postponed to the idle time */
+    GcSchedulerProcess( -1, 0 );
+    PROFILE_MARK( FRAME_PHASE_RECLAIM );
 
     /* print current memory statistic to console interface */
     #ifdef EW_PRINT_MEMORY_USAGE
@@ -341,61 +690,669 @@ int EwProcess( void )
     #ifdef EW_DUMP_HEAP
       EwDumpHeap( 0 );
     #endif
+
+    PROFILE_END();
   }
   else
   {
-    /* otherwise sleep/suspend the UI application... */
-    usleep( 100 );
+    /* the program binaries linked by the recent frames are stored by a
+       worker thread */
+    ShaderCacheFlush();
+
+    /* the frame clock advances with the vblanks - wait for the vblank, after
+       which the next timer expires */
+    timeout = FrameClockGetTimeout( EwNextTimerExpiration());
+
+    if (( frameTimeout > 0 ) && ( frameTimeout < timeout ))
+      timeout = frameTimeout;
+
+    /* use the idle time for the garbage collection, if its pause ends before
+       the next timer expires and the next frame is due - afterwards all the
+       deadlines are evaluated again */
+    if ( GcSchedulerProcess( timeout, EwBspDisplayGetNextVBlank()))
+      return 1;
+
+    /* suspend the UI application until an input device, the display or a
+       worker thread reports an event, until the next timer expires, the
+       next frame is due or the pending garbage collection is due */
+    gcTimeout = GcSchedulerGetTimeout();
+
+    if (( gcTimeout >= 0 ) && ( gcTimeout < timeout ))
+      timeout = gcTimeout;
+
+    EwBspEventWait( timeout );
   }
 
   return 1;
 }
 
 
+/*******************************************************************************
+* FUNCTION:
+*   EwSetRenderScale
+*
+* DESCRIPTION:
+*   The function EwSetRenderScale changes the resolution, the UI is rendered
+*   with. The root objects keep their size - the viewports scale the drawing
+*   operations to the smaller framebuffer and the display controller scales
+*   the framebuffer up to the display. Thereby the fill rate of the GPU drops
+*   with the square of the scale. The next frame is drawn completely.
+*   The function has no effect, if the display can not scale the framebuffer.
+*
+* ARGUMENTS:
+*   aScale - Render resolution in percent of the display size (25 .. 100).
+*
+* RETURN VALUE:
+*   Returns 1 if the resolution has been changed, 0 otherwise.
+*
+*******************************************************************************/
+int EwSetRenderScale( int aScale )
+{
+  XDisplay* display;
+  int       changed = 0;
+  int       i;
+
+  if ( aScale < 25 )
+    aScale = 25;
+  if ( aScale > 100 )
+    aScale = 100;
+
+  for ( i = 0; i < NoOfDisplays; i++ )
+  {
+    display = &Displays[ i ];
+
+    if ( !EwBspDisplaySetRenderScale( EglDisplay, &display->Surface, aScale,
+           &display->Width, &display->Height ))
+      continue;
+
+    EwResetViewport( display );
+    changed = 1;
+  }
+
+  if ( !changed )
+    return 0;
+
+  RenderScale = aScale;
+
+  /* the surface of the first display is the current one between the frames */
+  if ( NoOfDisplays > 1 )
+    EwBspDisplayMakeCurrent( EglDisplay, Displays[ 0 ].Surface );
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwGetEnvOption
+*
+* DESCRIPTION:
+*   The function EwGetEnvOption evaluates the environment variable, that
+*   overrides a configuration option at runtime (see ewconfig.h).
+*
+* ARGUMENTS:
+*   aName    - Name of the environment variable.
+*   aValues  - List of the valid values terminated by NULL.
+*   aDefault - Value of the option, if the variable is not set or invalid.
+*
+* RETURN VALUE:
+*   Returns the index of the value within aValues or aDefault.
+*
+*******************************************************************************/
+int EwGetEnvOption( const char* aName, const char* const* aValues, int aDefault )
+{
+  const char* value = getenv( aName );
+  int         i;
+
+  for ( i = 0; value && aValues[ i ]; i++ )
+    if ( !strcmp( value, aValues[ i ]))
+      return i;
+
+  return aDefault;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwGetEnvSwitch
+*
+* DESCRIPTION:
+*   The function EwGetEnvSwitch evaluates the environment variable, that
+*   switches a configuration option on or off at runtime (see ewconfig.h).
+*
+* ARGUMENTS:
+*   aName    - Name of the environment variable.
+*   aDefault - Value of the option, if the variable is neither "off" nor "on".
+*
+* RETURN VALUE:
+*   Returns 0 for "off", 1 for "on" or aDefault.
+*
+*******************************************************************************/
+int EwGetEnvSwitch( const char* aName, int aDefault )
+{
+  static const char* const values[] = { "off", "on", NULL };
+
+  return EwGetEnvOption( aName, values, aDefault );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwResetViewport
+*
+* DESCRIPTION:
+*   The function EwResetViewport creates the viewport of a display again after
+*   its surface or the size of its framebuffer has changed. The root object
+*   keeps its size and is redrawn entirely, because the content of the new
+*   surface is undefined.
+*
+* ARGUMENTS:
+*   aDisplay - Display to reset.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwResetViewport( XDisplay* aDisplay )
+{
+  EwDoneViewport( aDisplay->Viewport );
+  aDisplay->Viewport = EwInitViewport( aDisplay->Size, EwNewRect( 0, 0, aDisplay->Width,
+    aDisplay->Height ), ( aDisplay == Displays ) ? EW_ROTATION : 0, 255,
+    &aDisplay->Framebuffer, EglDisplay, aDisplay->Surface, ViewportProc );
+
+  CoreRoot__InvalidateArea( aDisplay->RootObject, EwNewRect( 0, 0, aDisplay->Size.X,
+    aDisplay->Size.Y ));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwUpdateDisplays
+*
+* DESCRIPTION:
+*   The function EwUpdateDisplays takes over the surfaces of the displays after
+*   a display has been reconnected or has changed its mode. The viewports of
+*   replaced surfaces are created again and all displays are redrawn with the
+*   next frame.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwUpdateDisplays( void )
+{
+  XDisplay* display;
+  void*     surface;
+  int32_t   width;
+  int32_t   height;
+  int       i;
+
+  for ( i = 0; i < NoOfDisplays; i++ )
+  {
+    display = &Displays[ i ];
+    surface = display->Surface;
+    width   = display->Width;
+    height  = display->Height;
+
+    if ( !EwBspDisplayGetSurface( i, &display->Surface, &display->Framebuffer,
+           &display->Width, &display->Height ))
+      continue;
+
+    if (( surface != display->Surface ) || ( width != display->Width ) ||
+        ( height != display->Height ))
+      EwResetViewport( display );
+    else
+      CoreRoot__InvalidateArea( display->RootObject, EwNewRect( 0, 0, display->Size.X,
+        display->Size.Y ));
+  }
+
+  /* a new surface is selected when it is created */
+  EwBspDisplayMakeCurrent( EglDisplay, Displays[ 0 ].Surface );
+  PendingChanges = 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwPrefetchResources
+*
+* DESCRIPTION:
+*   The function EwPrefetchResources reads the executable into the page cache.
+*   The bitmap and font resources of the application are part of it - they
+*   are accessed without waiting for the storage, when the Graphics Engine
+*   loads them. The function is executed as boot task on a worker thread.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwPrefetchResources( void )
+{
+  static char buf[ 65536 ];
+  int         fd = open( "/proc/self/exe", O_RDONLY | O_CLOEXEC );
+
+  if ( fd < 0 )
+    return;
+
+  posix_fadvise( fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+  while ( read( fd, buf, sizeof( buf )) > 0 )
+    ;
+
+  close( fd );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwDoesNeedUpdate
+*
+* DESCRIPTION:
+*   The function EwDoesNeedUpdate determines whether the content of any display
+*   or of the static background has changed.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   1, if a screen update is needed, 0 otherwise.
+*
+*******************************************************************************/
+static int EwDoesNeedUpdate( void )
+{
+  int i;
+
+  #ifdef EW_BACKGROUND_CLASS
+    if ( CoreRoot__DoesNeedUpdate( BackgroundObject ))
+      return 1;
+  #endif
+
+  for ( i = 0; i < NoOfDisplays; i++ )
+    if ( CoreRoot__DoesNeedUpdate( Displays[ i ].RootObject ))
+      return 1;
+
+  return 0;
+}
+
+
 /*******************************************************************************
 * FUNCTION:
 *   EwUpdate
 *
 * DESCRIPTION:
-*   The function EwUpdate performs the screen update of the dirty area.
+*   The function EwUpdate performs the screen update of the dirty area of the
+*   given display. With several displays, the EGL surface of the display is
+*   selected first.
 *
 * ARGUMENTS:
-*   aViewPort    - Viewport used for the screen update.
-*   aApplication - Root object used for the screen update.
+*   aDisplay - Display to update.
 *
 * RETURN VALUE:
 *   None
 *
 *******************************************************************************/
-static void EwUpdate( XViewport* aViewport, CoreRoot aApplication )
+static void EwUpdate( XDisplay* aDisplay )
 {
-  XBitmap*       bitmap     = EwBeginUpdate( aViewport );
-  GraphicsCanvas canvas     = EwNewObject( GraphicsCanvas, 0 );
+  XViewport*     viewport    = aDisplay->Viewport;
+  CoreRoot       application = aDisplay->RootObject;
+  XBitmap*       bitmap;
+  GraphicsCanvas canvas;
   XRect          updateRect = {{ 0, 0 }, { 0, 0 }};
+  int            composed   = 0;
+
+  /* the static background is shown on the first display */
+  #ifdef EW_BACKGROUND_CLASS
+    if ( aDisplay == Displays )
+    {
+      EwUpdateBackground();
+      composed = !BackgroundViewport;
+    }
+  #endif
+
+  if ( !CoreRoot__DoesNeedUpdate( application ))
+    return;
+
+  if ( NoOfDisplays > 1 )
+    EwBspDisplayMakeCurrent( EglDisplay, aDisplay->Surface );
+
+  /* the heatmap shows the overdraw of the entire screen */
+  if ( OverdrawHeatmapIsActive())
+    CoreRoot__InvalidateArea( application, EwNewRect( 0, 0, aDisplay->Size.X,
+      aDisplay->Size.Y ));
+
+  #ifdef DAMAGE_HISTORY_SIZE
+    if ( UseBufferAge )
+    {
+      EwUpdateDamage( aDisplay );
+      return;
+    }
+  #endif
+
+  bitmap = EwBeginUpdate( viewport );
+  canvas = EwNewObject( GraphicsCanvas, 0 );
 
   /* let's redraw the dirty area of the screen. Cover the returned bitmap
      objects within a canvas, so Mosaic can draw to it. */
+  if ( bitmap && canvas && !composed )
+  {
+    GraphicsCanvas__AttachBitmap( canvas, (XUInt32)bitmap );
+    updateRect = CoreRoot__UpdateGE20( application, canvas );
+    GraphicsCanvas__DetachBitmap( canvas );
+  }
+
+  #ifdef EW_BACKGROUND_CLASS
+    /* without a separate layer, the background is drawn below the UI - the
+       content of the framebuffer is not preserved, so the entire screen is
+       redrawn */
+    if ( bitmap && canvas && composed )
+    {
+      updateRect = EwNewRect( 0, 0, aDisplay->Size.X, aDisplay->Size.Y );
+
+      GraphicsCanvas__AttachBitmap( canvas, (XUInt32)bitmap );
+      EwDrawBackground( canvas, updateRect );
+      CoreRoot__InvalidateArea( application, updateRect );
+      CoreRoot__BeginUpdate( application );
+      CoreRoot__UpdateCanvas( application, canvas, updateRect.Point1 );
+      CoreRoot__EndUpdate( application );
+      GraphicsCanvas__DetachBitmap( canvas );
+    }
+  #endif
+
+  /* complete the update */
+  if ( bitmap )
+    EwEndUpdate( viewport, updateRect );
+}
+
+
+#ifdef DAMAGE_HISTORY_SIZE
+/*******************************************************************************
+* FUNCTION:
+*   EwUpdateDamage
+*
+* DESCRIPTION:
+*   The function EwUpdateDamage performs the screen update of the dirty area
+*   by taking the age of the EGL back buffer in account. Beside the areas
+*   changed in the current frame, the areas changed since the back buffer was
+*   shown last time are redrawn. The rest of the back buffer remains untouched.
+*   Each display tracks the changes of its own back buffers.
+*
+* ARGUMENTS:
+*   aDisplay - Display to update.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwUpdateDamage( XDisplay* aDisplay )
+{
+  XViewport*     viewport      = aDisplay->Viewport;
+  CoreRoot       application   = aDisplay->RootObject;
+  XRect*         damageHistory = aDisplay->DamageHistory;
+  XRect          damage;
+  XBitmap*       bitmap;
+  GraphicsCanvas canvas;
+  XRect          area;
+  int            regions;
+  int            age;
+  int            i;
+
+  /* collect the areas changed since the previous frame */
+  damage  = EwNewRect( 0, 0, 0, 0 );
+  regions = CoreRoot__BeginUpdate( application );
+
+  for ( i = 0; i < regions; i++ )
+    damage = EwUnionRect( damage, CoreRoot__GetUpdateRegion( application, i ));
+
+  if ( EwIsRectEmpty( damage ))
+  {
+    CoreRoot__EndUpdate( application );
+    return;
+  }
+
+  /* the back buffer misses the changes of all frames shown since it was on the
+     screen - if its content is unknown, the entire screen has to be redrawn */
+  area = damage;
+  age  = EwBspDisplayGetBufferAge( EglDisplay, aDisplay->Surface );
+
+  if (( age <= 0 ) || ( age > DAMAGE_HISTORY_SIZE + 1 ))
+    area = EwNewRect( 0, 0, aDisplay->Size.X, aDisplay->Size.Y );
+  else
+    for ( i = 0; i < age - 1; i++ )
+      area = EwUnionRect( area, damageHistory[ i ]);
+
+  /* the entire area has to be redrawn by the Mosaic, also the parts between
+     the dirty regions - restart the update with the resulting area */
+  if (( regions > 1 ) || ( area.Point1.X != damage.Point1.X ) ||
+      ( area.Point1.Y != damage.Point1.Y ) || ( area.Point2.X != damage.Point2.X ) ||
+      ( area.Point2.Y != damage.Point2.Y ))
+  {
+    CoreRoot__EndUpdate( application );
+    CoreRoot__InvalidateArea( application, area );
+    CoreRoot__BeginUpdate( application );
+  }
+
+  /* remember the changes for the following frames */
+  for ( i = DAMAGE_HISTORY_SIZE - 1; i > 0; i-- )
+    damageHistory[ i ] = damageHistory[ i - 1 ];
+
+  damageHistory[ 0 ] = damage;
+  aDisplay->Damage   = damage;
+
+  /* restrict the drawing operations to the affected area of the back buffer */
+  EwBspDisplaySetDamage( EglDisplay, aDisplay->Surface, EwScaleArea( aDisplay, area ));
+
+  bitmap = EwBeginUpdateArea( viewport, area );
+  canvas = EwNewObject( GraphicsCanvas, 0 );
+
+  /* let's redraw the area. Cover the returned bitmap objects within a canvas,
+     so Mosaic can draw to it. */
   if ( bitmap && canvas )
   {
     GraphicsCanvas__AttachBitmap( canvas, (XUInt32)bitmap );
-    updateRect = CoreRoot__UpdateGE20( aApplication, canvas );
+
+    #ifdef EW_BACKGROUND_CLASS
+      if ( aDisplay == Displays )
+        EwDrawBackground( canvas, area );
+    #endif
+
+    CoreRoot__UpdateCanvas( application, canvas, area.Point1 );
     GraphicsCanvas__DetachBitmap( canvas );
   }
 
+  CoreRoot__EndUpdate( application );
+
   /* complete the update */
   if ( bitmap )
-    EwEndUpdate( aViewport, updateRect );
+    EwEndUpdate( viewport, area );
 }
 
 
-/* Completion callback for the viewport. If EwEndUpdate() is called, the
-   callback ensures, that the screen content is flipped */
+/*******************************************************************************
+* FUNCTION:
+*   EwScaleArea
+*
+* DESCRIPTION:
+*   The function EwScaleArea converts an area of the root object into the
+*   coordinates of the framebuffer. If the UI is rendered at reduced resolution,
+*   the framebuffer is smaller than the root object. The area is enlarged to
+*   include the pixels affected by the filtering of the scaled drawing.
+*
+* ARGUMENTS:
+*   aDisplay - Display the area belongs to.
+*   aArea    - Area relative to the top-left corner of the root object.
+*
+* RETURN VALUE:
+*   Returns the area relative to the top-left corner of the framebuffer.
+*
+*******************************************************************************/
+static XRect EwScaleArea( XDisplay* aDisplay, XRect aArea )
+{
+  XRect area;
+
+  if (( aDisplay->Width == aDisplay->Size.X ) && ( aDisplay->Height == aDisplay->Size.Y ))
+    return aArea;
+
+  area.Point1.X = aArea.Point1.X * aDisplay->Width  / aDisplay->Size.X - 1;
+  area.Point1.Y = aArea.Point1.Y * aDisplay->Height / aDisplay->Size.Y - 1;
+  area.Point2.X = ( aArea.Point2.X * aDisplay->Width  + aDisplay->Size.X - 1 ) / aDisplay->Size.X + 1;
+  area.Point2.Y = ( aArea.Point2.Y * aDisplay->Height + aDisplay->Size.Y - 1 ) / aDisplay->Size.Y + 1;
+
+  return EwIntersectRect( area, EwNewRect( 0, 0, aDisplay->Width, aDisplay->Height ));
+}
+#endif
+
+
+#ifdef EW_BACKGROUND_CLASS
+/*******************************************************************************
+* FUNCTION:
+*   EwUpdateBackground
+*
+* DESCRIPTION:
+*   The function EwUpdateBackground performs the update of the static
+*   background. If the display provides a separate layer for the background,
+*   the background is drawn into this layer. Otherwise the changed areas of the
+*   background are passed to the UI, which draws the background below its own
+*   content (see EwDrawBackground()).
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwUpdateBackground( void )
+{
+  XBitmap*       bitmap;
+  GraphicsCanvas canvas;
+  XRect          updateRect = {{ 0, 0 }, { 0, 0 }};
+  int            regions;
+  int            i;
+
+  if ( !CoreRoot__DoesNeedUpdate( BackgroundObject ))
+    return;
+
+  if ( !BackgroundViewport )
+  {
+    regions = CoreRoot__BeginUpdate( BackgroundObject );
+
+    for ( i = 0; i < regions; i++ )
+      CoreRoot__InvalidateArea( Displays[ 0 ].RootObject,
+        CoreRoot__GetUpdateRegion( BackgroundObject, i ));
+
+    CoreRoot__EndUpdate( BackgroundObject );
+    return;
+  }
+
+  /* the content of the background layer is not preserved between its buffers
+     - the background changes rarely, so it is redrawn entirely */
+  CoreRoot__InvalidateArea( BackgroundObject, EwNewRect( 0, 0, EwScreenSize.X, EwScreenSize.Y ));
+  EwBspDisplayMakeCurrent( EglDisplay, BackgroundSurface );
+
+  bitmap = EwBeginUpdate( BackgroundViewport );
+  canvas = EwNewObject( GraphicsCanvas, 0 );
+
+  if ( bitmap && canvas )
+  {
+    GraphicsCanvas__AttachBitmap( canvas, (XUInt32)bitmap );
+    updateRect = CoreRoot__UpdateGE20( BackgroundObject, canvas );
+    GraphicsCanvas__DetachBitmap( canvas );
+  }
+
+  if ( bitmap )
+    EwEndUpdate( BackgroundViewport, updateRect );
+
+  EwBspDisplayMakeCurrent( EglDisplay, Displays[ 0 ].Surface );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwDrawBackground
+*
+* DESCRIPTION:
+*   The function EwDrawBackground draws the given area of the background into
+*   the canvas of the UI, if the display has no separate layer for the
+*   background. The UI is drawn afterwards on top of it.
+*
+* ARGUMENTS:
+*   aCanvas - Canvas of the UI to draw on.
+*   aArea   - Area to draw relative to the top-left corner of the screen.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void EwDrawBackground( GraphicsCanvas aCanvas, XRect aArea )
+{
+  if ( BackgroundViewport )
+    return;
+
+  CoreRoot__InvalidateArea( BackgroundObject, aArea );
+  CoreRoot__BeginUpdate( BackgroundObject );
+  CoreRoot__UpdateCanvas( BackgroundObject, aCanvas, aArea.Point1 );
+  CoreRoot__EndUpdate( BackgroundObject );
+}
+
+
+/* Completion callback for the viewport of the background layer. The drawn
+   background is shown below the UI */
+static void BackgroundProc( XViewport* aViewport, unsigned long aHandle,
+  void* aDisplay1, void* aDisplay2, void* aDisplay3, XRect aArea )
+{
+  OverdrawHeatmapEndUpdate( aViewport );
+  GpuBatchFlush();
+
+  if (( aArea.Point2.X <= aArea.Point1.X ) || ( aArea.Point2.Y <= aArea.Point1.Y ))
+    return;
+
+  EwBspDisplaySwapBackground( aDisplay2, aDisplay3 );
+}
+#endif
+
+
+/* Completion callback for the viewports of all displays. If EwEndUpdate() is
+   called, the callback ensures, that the screen content is flipped */
 static void ViewportProc( XViewport* aViewport, unsigned long aHandle,
   void* aDisplay1, void* aDisplay2, void* aDisplay3, XRect aArea )
 {
+  #ifdef DAMAGE_HISTORY_SIZE
+    XDisplay* display = Displays;
+
+    /* the display is identified by its EGL surface */
+    while (( display < Displays + NoOfDisplays - 1 ) && ( display->Surface != aDisplay3 ))
+      display++;
+  #endif
+
+  /* the drawing operations are completed - the swap is measured separately.
+     With the overdraw heatmap, the heatmap replaces the drawn content */
+  OverdrawHeatmapEndUpdate( aViewport );
+  GpuBatchFlush();
+  PROFILE_MARK( FRAME_PHASE_UPDATE );
+
   /* Perform the swap if there was something drawn on the screen */
-  if (( aArea.Point2.X > aArea.Point1.X ) && ( aArea.Point2.Y > aArea.Point1.Y ))
+  if (( aArea.Point2.X <= aArea.Point1.X ) || ( aArea.Point2.Y <= aArea.Point1.Y ))
+    return;
+
+  /* with damage tracking, only the areas changed since the previous frame
+     are passed to the display */
+  #ifdef DAMAGE_HISTORY_SIZE
+    if ( UseBufferAge )
+      EwBspDisplaySwapBuffersWithDamage( aDisplay2, aDisplay3,
+        EwScaleArea( display, display->Damage ));
+    else
+      EwBspDisplaySwapBuffers( aDisplay2, aDisplay3 );
+  #else
     EwBspDisplaySwapBuffers( aDisplay2, aDisplay3 );
+  #endif
+
+  PROFILE_MARK( FRAME_PHASE_SWAP );
 }
 
 
@@ -474,7 +1431,9 @@ void EwPrintSystemInfo( void )
   EwPrint( "ExtraPool address                            0x%08X  \n", EW_EXTRA_POOL_ADDR );
   EwPrint( "ExtraPool size                               %u bytes\n", EW_EXTRA_POOL_SIZE );
   #endif
-  EwPrint( "Framebuffer size                             %u x %u \n", Width, Height );
+  EwPrint( "Framebuffer size                             %u x %u \n", Displays[ 0 ].Width, Displays[ 0 ].Height );
+  EwPrint( "Number of displays                           %u      \n", NoOfDisplays );
+  EwPrint( "Render scale                                 %u %%    \n", RenderScale );
   EwPrint( "EwScreeenSize                                %d x %d \n", EwScreenSize.X, EwScreenSize.Y );
   EwPrint( "Graphics accelerator                         %s      \n", GRAPHICS_ACCELERATOR_STRING );
   EwPrint( "Vector graphics support                      %s      \n", VECTOR_GRAPHICS_SUPPORT_STRING );
@@ -494,6 +1453,13 @@ void EwPrintSystemInfo( void )
   EwPrint( "Glyph cache size                             %u x %u \n", EW_MAX_GLYPH_SURFACE_WIDTH, EW_MAX_GLYPH_SURFACE_HEIGHT );
   EwPrint( "Max issue tasks                              %u      \n", EW_MAX_ISSUE_TASKS );
   EwPrint( "Surface rotation                             %u      \n", EW_ROTATION );
+  #ifdef DAMAGE_HISTORY_SIZE
+  EwPrint( "Damage tracking (buffer age)                 %s      \n", UseBufferAge ? "enabled" : "not supported" );
+  #endif
+  #if EW_FRAME_PROFILER_FRAMES > 0
+  EwPrint( "Frame profiler (SIGUSR1 to export)           %u frames\n", EW_FRAME_PROFILER_FRAMES );
+  #endif
+  EwPrint( "Overdraw heatmap (SIGUSR2 to toggle)         %s      \n", OverdrawHeatmapIsActive() ? "on" : "off" );
   EwPrint( "---------------------------------------------\n" );
 }
 
@@ -183,6 +183,67 @@ void EwDone( void );
 int EwProcess( void );
 
 
+/*******************************************************************************
+* FUNCTION:
+*   EwSetRenderScale
+*
+* DESCRIPTION:
+*   The function EwSetRenderScale changes the resolution, the UI is rendered
+*   with. The root objects keep their size - the viewports scale the drawing
+*   operations to the smaller framebuffer and the display controller scales
+*   the framebuffer up to the display. Thereby the fill rate of the GPU drops
+*   with the square of the scale. The next frame is drawn completely.
+*   The function has no effect, if the display can not scale the framebuffer.
+*
+* ARGUMENTS:
+*   aScale - Render resolution in percent of the display size (25 .. 100).
+*
+* RETURN VALUE:
+*   Returns 1 if the resolution has been changed, 0 otherwise.
+*
+*******************************************************************************/
+int EwSetRenderScale( int aScale );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwGetEnvOption
+*
+* DESCRIPTION:
+*   The function EwGetEnvOption evaluates the environment variable, that
+*   overrides a configuration option at runtime (see ewconfig.h).
+*
+* ARGUMENTS:
+*   aName    - Name of the environment variable.
+*   aValues  - List of the valid values terminated by NULL.
+*   aDefault - Value of the option, if the variable is not set or invalid.
+*
+* RETURN VALUE:
+*   Returns the index of the value within aValues or aDefault.
+*
+*******************************************************************************/
+int EwGetEnvOption( const char* aName, const char* const* aValues, int aDefault );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwGetEnvSwitch
+*
+* DESCRIPTION:
+*   The function EwGetEnvSwitch evaluates the environment variable, that
+*   switches a configuration option on or off at runtime (see ewconfig.h).
+*
+* ARGUMENTS:
+*   aName    - Name of the environment variable.
+*   aDefault - Value of the option, if the variable is neither "off" nor "on".
+*
+* RETURN VALUE:
+*   Returns 0 for "off", 1 for "on" or aDefault.
+*
+*******************************************************************************/
+int EwGetEnvSwitch( const char* aName, int aDefault );
+
+
 /*******************************************************************************
 * FUNCTION:
 *   EwPrintSystemInfo
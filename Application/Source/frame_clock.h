@@ -0,0 +1,157 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides the frame clock - a time base, that is locked to the
+*   vertical blanks of the display. Instead of the wall time at the moment the
+*   timers are processed, the timers and animations get the predicted time,
+*   when the frame they prepare will be presented. This time is derived from
+*   the timestamps and the measured period of the page flips (see
+*   EwBspDisplayGetNextVBlank()). Thereby every frame advances the animations
+*   by exactly one frame period and smooth movements do not judder.
+*
+*   The function EwGetTicks() is redirected by the linker (option --wrap) to
+*   __wrap_EwGetTicks(). As long as the vertical blanks are unknown, e.g. with
+*   unthrottled headless rendering, the wall time is used.
+*
+*   The frame clock is selected by EW_FRAME_CLOCK or at runtime by the
+*   environment variable EW_FRAME_CLOCK ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameClockInit
+*
+* DESCRIPTION:
+*   The function FrameClockInit selects whether the timers and animations are
+*   driven by the frame clock and determines the offset between the ticks of
+*   the Runtime Environment and the monotonic clock.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameClockInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameClockUpdate
+*
+* DESCRIPTION:
+*   The function FrameClockUpdate has to be called at the begin of every cycle
+*   of the main loop, before the timers are processed. It latches the predicted
+*   presentation time of the next frame - all calls of EwGetTicks() within the
+*   cycle return this time.
+*
+* ARGUMENTS:
+*   aVBlank - Time of the vertical blank, a frame rendered now is presented
+*     with, in microseconds (CLOCK_MONOTONIC) or 0 if unknown.
+*   aPeriod - Duration of one frame in microseconds or 0 if unknown.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameClockUpdate
+(
+  long long                   aVBlank,
+  long long                   aPeriod
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameClockGetTimeout
+*
+* DESCRIPTION:
+*   The function FrameClockGetTimeout converts the time until the next timer
+*   expires into the time, the main loop has to wait for it. Since the frame
+*   clock advances in steps of one frame, the timer expires as soon as its
+*   expiration falls within the frame presented with the next vertical blank.
+*   Waiting for the ticks instead would let the main loop spin.
+*
+* ARGUMENTS:
+*   aTimeout - Time until the next timer expires in ms, measured with the frame
+*     clock, or -1 if no timer is running.
+*
+* RETURN VALUE:
+*   Returns the time to wait in ms or -1 if no timer is running.
+*
+*******************************************************************************/
+int FrameClockGetTimeout
+(
+  int                         aTimeout
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwGetTicks
+*
+* DESCRIPTION:
+*   The function __wrap_EwGetTicks replaces EwGetTicks() of the Runtime
+*   Environment. With the frame clock, the predicted presentation time of the
+*   frame is returned. Otherwise the wall time is passed unchanged.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the time in milliseconds.
+*
+*******************************************************************************/
+unsigned long __wrap_EwGetTicks
+(
+  void
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* FRAME_CLOCK_H */
+
+
+/* msy */
@@ -0,0 +1,353 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template implements a lightweight frame profiler. For every processed
+*   cycle of the main loop (frame), the start time and the duration of the
+*   single phases are stored within a ring buffer containing the last
+*   EW_FRAME_PROFILER_FRAMES frames. The statistic is evaluated on demand and
+*   the recorded frames are written to a binary file on SIGUSR1.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+
+#include "ewrte.h"
+#include "frame_profiler.h"
+
+#ifndef EW_FRAME_PROFILER_FRAMES
+  #define EW_FRAME_PROFILER_FRAMES    0
+#endif
+
+#ifndef EW_FRAME_PROFILER_FILE
+  #define EW_FRAME_PROFILER_FILE      "/tmp/ew_frame_profile.bin"
+#endif
+
+/* size of the ring buffer - at least one frame is needed for the measurement */
+#if EW_FRAME_PROFILER_FRAMES > 0
+  #define NO_OF_FRAMES                EW_FRAME_PROFILER_FRAMES
+#else
+  #define NO_OF_FRAMES                1
+#endif
+
+static XFrameRecord           Frames[ NO_OF_FRAMES ];
+static uint32_t               Durations[ NO_OF_FRAMES ];  /* used for sorting */
+static unsigned int           NoOfFrames   = 0;  /* total number of completed frames */
+static XFrameRecord           Current;           /* frame in measurement */
+static int64_t                LastMark     = 0;
+static volatile sig_atomic_t  DumpRequest  = 0;
+
+static const char* PhaseNames[ NO_OF_FRAME_PHASES ] =
+{
+  "Devices", "Keys", "Touch", "Timers", "Signals", "Update", "Swap",
+  "VerifyHeap", "Reclaim", "Frame"
+};
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the current time in microseconds
+ */
+static int64_t GetTime( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/*
+ * signal handler of SIGUSR1 - the file is written by the GUI thread
+ */
+static void SignalHandler( int aSignal )
+{
+  /* suppress 'unused parameter' warnings */
+  (void)aSignal;
+
+  DumpRequest = 1;
+}
+
+
+/*
+ * compare function used to sort the durations
+ */
+static int CompareDurations( const void* aDuration1, const void* aDuration2 )
+{
+  uint32_t d1 = *(const uint32_t*)aDuration1;
+  uint32_t d2 = *(const uint32_t*)aDuration2;
+
+  return ( d1 > d2 ) - ( d1 < d2 );
+}
+
+
+/*
+ * helper function to write the recorded frames to the binary file
+ */
+static void WriteFrames( void )
+{
+  XFrameProfileHeader header;
+  XFrameStatistic     statistic;
+  FILE*               file;
+  unsigned int        count = ( NoOfFrames < NO_OF_FRAMES ) ? NoOfFrames : NO_OF_FRAMES;
+  unsigned int        first = ( NoOfFrames < NO_OF_FRAMES ) ? 0 : NoOfFrames % NO_OF_FRAMES;
+  int                 ok;
+  int                 i;
+
+  file = fopen( EW_FRAME_PROFILER_FILE, "wb" );
+  if ( !file )
+  {
+    EwPrint( "FrameProfiler: Cannot create %s!\n", EW_FRAME_PROFILER_FILE );
+    return;
+  }
+
+  memcpy( header.Magic, "EWFP", 4 );
+  header.Version    = 1;
+  header.NoOfPhases = NO_OF_FRAME_PHASES;
+  header.NoOfFrames = count;
+
+  ok = fwrite( &header, sizeof( header ), 1, file ) == 1;
+
+  for ( i = 0; ok && ( i < NO_OF_FRAME_PHASES ); i++ )
+  {
+    FrameProfilerGetStatistic( i, &statistic );
+    ok = fwrite( &statistic, sizeof( statistic ), 1, file ) == 1;
+  }
+
+  /* the ring buffer is stored from the oldest to the newest frame */
+  if ( ok )
+    ok = fwrite( Frames + first, sizeof( XFrameRecord ), count - first, file ) == count - first;
+
+  if ( ok && first )
+    ok = fwrite( Frames, sizeof( XFrameRecord ), first, file ) == first;
+
+  if (( fclose( file ) != 0 ) || !ok )
+    EwPrint( "FrameProfiler: Cannot write %s!\n", EW_FRAME_PROFILER_FILE );
+  else
+    EwPrint( "FrameProfiler: %u frames written to %s\n", count, EW_FRAME_PROFILER_FILE );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerInit
+*
+* DESCRIPTION:
+*   The function FrameProfilerInit clears the recorded frames and installs the
+*   SIGUSR1 handler to request the export of the frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerInit( void )
+{
+  struct sigaction action;
+
+  NoOfFrames  = 0;
+  DumpRequest = 0;
+
+  memset( &Current, 0, sizeof( Current ));
+
+  /* without SA_RESTART, a pending EwBspEventWait() returns on the signal */
+  memset( &action, 0, sizeof( action ));
+  action.sa_handler = SignalHandler;
+  sigemptyset( &action.sa_mask );
+  sigaction( SIGUSR1, &action, NULL );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerDone
+*
+* DESCRIPTION:
+*   The function FrameProfilerDone prints the statistic of the recorded frames
+*   and restores the default SIGUSR1 handler.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerDone( void )
+{
+  XFrameStatistic statistic;
+  int             count = 0;
+  int             i;
+
+  signal( SIGUSR1, SIG_DFL );
+
+  for ( i = 0; i < NO_OF_FRAME_PHASES; i++ )
+  {
+    count = FrameProfilerGetStatistic( i, &statistic );
+
+    if ( !count )
+      break;
+
+    if ( i == 0 )
+      EwPrint( "Frame profile of the last %d frames  p50 / p95 / p99 / max [us]\n", count );
+
+    EwPrint( "  %-12s %8u %8u %8u %8u\n", PhaseNames[ i ], statistic.P50,
+      statistic.P95, statistic.P99, statistic.Max );
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerBegin
+*
+* DESCRIPTION:
+*   The function FrameProfilerBegin starts the measurement of a new frame. It
+*   has to be called at the beginning of every cycle of the main loop. A frame
+*   that is not completed by FrameProfilerEnd() is discarded.
+*   If an export of the recorded frames was requested by SIGUSR1, the file is
+*   written before the new frame starts.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerBegin( void )
+{
+  if ( DumpRequest )
+  {
+    DumpRequest = 0;
+    WriteFrames();
+  }
+
+  memset( &Current, 0, sizeof( Current ));
+
+  Current.Time = LastMark = GetTime();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerMark
+*
+* DESCRIPTION:
+*   The function FrameProfilerMark adds the time elapsed since the previous
+*   mark (or since the begin of the frame) to the given phase of the current
+*   frame. A phase can be marked several times within one frame.
+*
+* ARGUMENTS:
+*   aPhase - The phase that has been completed (FRAME_PHASE_xxx).
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerMark( int aPhase )
+{
+  int64_t now = GetTime();
+
+  Current.Duration[ aPhase ] += (uint32_t)( now - LastMark );
+  LastMark = now;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerEnd
+*
+* DESCRIPTION:
+*   The function FrameProfilerEnd completes the measurement of the current frame
+*   and stores it within the ring buffer.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerEnd( void )
+{
+  Current.Duration[ FRAME_PHASE_TOTAL ] = (uint32_t)( GetTime() - Current.Time );
+
+  Frames[ NoOfFrames++ % NO_OF_FRAMES ] = Current;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerGetStatistic
+*
+* DESCRIPTION:
+*   The function FrameProfilerGetStatistic evaluates the percentiles and the
+*   maximum duration of the given phase over the recorded frames.
+*
+* ARGUMENTS:
+*   aPhase     - The phase to evaluate (FRAME_PHASE_xxx).
+*   aStatistic - Pointer to return the statistic.
+*
+* RETURN VALUE:
+*   Returns the number of evaluated frames.
+*
+*******************************************************************************/
+int FrameProfilerGetStatistic( int aPhase, XFrameStatistic* aStatistic )
+{
+  int count = ( NoOfFrames < NO_OF_FRAMES ) ? NoOfFrames : NO_OF_FRAMES;
+  int i;
+
+  memset( aStatistic, 0, sizeof( XFrameStatistic ));
+
+  if (( count == 0 ) || ( aPhase < 0 ) || ( aPhase >= NO_OF_FRAME_PHASES ))
+    return 0;
+
+  for ( i = 0; i < count; i++ )
+    Durations[ i ] = Frames[ i ].Duration[ aPhase ];
+
+  qsort( Durations, count, sizeof( uint32_t ), CompareDurations );
+
+  /* nearest rank percentiles */
+  aStatistic->P50 = Durations[ ( count * 50 + 99 ) / 100 - 1 ];
+  aStatistic->P95 = Durations[ ( count * 95 + 99 ) / 100 - 1 ];
+  aStatistic->P99 = Durations[ ( count * 99 + 99 ) / 100 - 1 ];
+  aStatistic->Max = Durations[ count - 1 ];
+
+  return count;
+}
+
+
+/* msy */
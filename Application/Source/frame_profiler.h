@@ -0,0 +1,240 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template implements a lightweight frame profiler. For every processed
+*   cycle of the main loop (frame), the start time and the duration of the
+*   single phases (device drivers, key and touch events, timers, signals, screen
+*   update, buffer swap, heap verification and garbage collection) are stored
+*   within a ring buffer containing the last EW_FRAME_PROFILER_FRAMES frames.
+*   The measurement costs one clock_gettime() call per phase, so the profiler
+*   can remain active in production builds.
+*
+*   The statistic (p50/p95/p99/max) of the recorded frames is evaluated on
+*   demand. Sending SIGUSR1 to the process writes the recorded frames to the
+*   file EW_FRAME_PROFILER_FILE. The file is stored in the native byte order
+*   and consists of:
+*
+*   XFrameProfileHeader  - Magic "EWFP", version, number of phases and frames.
+*   uint32_t [phases][4] - p50, p95, p99 and max of every phase in us.
+*   XFrameRecord [frames] - The recorded frames, the oldest frame first.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/* phases of one cycle of the main loop */
+#define FRAME_PHASE_DEVICES           0  /* DeviceDriver_ProcessData() */
+#define FRAME_PHASE_KEYS              1  /* key event dispatching */
+#define FRAME_PHASE_TOUCH             2  /* touch event dispatching */
+#define FRAME_PHASE_TIMERS            3  /* EwProcessTimers() */
+#define FRAME_PHASE_SIGNALS           4  /* EwProcessSignals() */
+#define FRAME_PHASE_UPDATE            5  /* drawing of the screen update */
+#define FRAME_PHASE_SWAP              6  /* buffer swap and page flip */
+#define FRAME_PHASE_VERIFY            7  /* EwVerifyHeap() */
+#define FRAME_PHASE_RECLAIM           8  /* EwReclaimMemory() */
+#define FRAME_PHASE_TOTAL             9  /* entire frame */
+#define NO_OF_FRAME_PHASES           10
+
+
+/* header of the binary file written on SIGUSR1 */
+typedef struct
+{
+  char          Magic[ 4 ];          /* "EWFP" */
+  uint32_t      Version;             /* format version, currently 1 */
+  uint32_t      NoOfPhases;          /* NO_OF_FRAME_PHASES */
+  uint32_t      NoOfFrames;          /* number of following frame records */
+} XFrameProfileHeader;
+
+
+/* measurement of one frame */
+typedef struct
+{
+  int64_t       Time;                              /* start in us (CLOCK_MONOTONIC) */
+  uint32_t      Duration[ NO_OF_FRAME_PHASES ];    /* duration of the phases in us */
+} XFrameRecord;
+
+
+/* statistic of one phase over the recorded frames in us */
+typedef struct
+{
+  uint32_t      P50;
+  uint32_t      P95;
+  uint32_t      P99;
+  uint32_t      Max;
+} XFrameStatistic;
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerInit
+*
+* DESCRIPTION:
+*   The function FrameProfilerInit clears the recorded frames and installs the
+*   SIGUSR1 handler to request the export of the frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerDone
+*
+* DESCRIPTION:
+*   The function FrameProfilerDone prints the statistic of the recorded frames
+*   and restores the default SIGUSR1 handler.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerBegin
+*
+* DESCRIPTION:
+*   The function FrameProfilerBegin starts the measurement of a new frame. It
+*   has to be called at the beginning of every cycle of the main loop. A frame
+*   that is not completed by FrameProfilerEnd() is discarded.
+*   If an export of the recorded frames was requested by SIGUSR1, the file is
+*   written before the new frame starts.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerBegin
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerMark
+*
+* DESCRIPTION:
+*   The function FrameProfilerMark adds the time elapsed since the previous
+*   mark (or since the begin of the frame) to the given phase of the current
+*   frame. A phase can be marked several times within one frame.
+*
+* ARGUMENTS:
+*   aPhase - The phase that has been completed (FRAME_PHASE_xxx).
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerMark
+(
+  int                         aPhase
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerEnd
+*
+* DESCRIPTION:
+*   The function FrameProfilerEnd completes the measurement of the current frame
+*   and stores it within the ring buffer.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void FrameProfilerEnd
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   FrameProfilerGetStatistic
+*
+* DESCRIPTION:
+*   The function FrameProfilerGetStatistic evaluates the percentiles and the
+*   maximum duration of the given phase over the recorded frames.
+*
+* ARGUMENTS:
+*   aPhase     - The phase to evaluate (FRAME_PHASE_xxx).
+*   aStatistic - Pointer to return the statistic.
+*
+* RETURN VALUE:
+*   Returns the number of evaluated frames.
+*
+*******************************************************************************/
+int FrameProfilerGetStatistic
+(
+  int                         aPhase,
+  XFrameStatistic*            aStatistic
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* FRAME_PROFILER_H */
+
+
+/* msy */
@@ -0,0 +1,388 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template decides, when the Garbage Collector (EwReclaimMemory()) is
+*   started. The garbage is collected preferably while the GUI thread is idle.
+*   Within the processing of a frame, the Garbage Collector is started under
+*   memory pressure only.
+*
+*   The allocations are counted by GcSchedulerCountAlloc(), called by the
+*   redirected EwAlloc() (see heap_check.c). The amount of new garbage is
+*   estimated from the memory allocated since the last collection. The memory
+*   pressure is taken from the counters of the memory pools (EwGetHeapInfo()).
+*   Without memory pools, the pending garbage is collected at least every
+*   EW_GC_MAX_INTERVAL milliseconds.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+
+#include "ewrte.h"
+#include "gc_scheduler.h"
+
+#ifndef EW_GC_IDLE_THRESHOLD
+  #define EW_GC_IDLE_THRESHOLD        ( 64 * 1024 )
+#endif
+
+#ifndef EW_GC_PRESSURE_THRESHOLD
+  #define EW_GC_PRESSURE_THRESHOLD    20
+#endif
+
+#ifndef EW_GC_PRESSURE_MIN_GARBAGE
+  #define EW_GC_PRESSURE_MIN_GARBAGE  ( 16 * 1024 )
+#endif
+
+#ifndef EW_GC_QUIET_TIME
+  #define EW_GC_QUIET_TIME            250
+#endif
+
+#ifndef EW_GC_MAX_INTERVAL
+  #define EW_GC_MAX_INTERVAL          5000
+#endif
+
+/* number of recent pauses used to estimate the next pause */
+#define NO_OF_PAUSES                  8
+
+static unsigned long       Allocs;           /* alloc operations since the start */
+static unsigned long long  Allocated;        /* allocated memory since the start */
+static unsigned long       AllocsAfterGc;    /* alloc operations until the last collection */
+static unsigned long long  AllocatedAfterGc; /* allocated memory until the last collection */
+static long long           LastActivity;     /* time of the last processed frame in us */
+static long long           LastCollection;   /* time of the last collection in us */
+static unsigned long long  PressureGarbage;  /* allocated memory required under pressure */
+static long long           Pauses[ NO_OF_PAUSES ];
+static int                 PauseIndex;
+
+/* statistic of the garbage collection pauses in us */
+static unsigned int        NoOfIdleCollections;
+static unsigned int        NoOfForcedCollections;
+static long long           TotalPause;
+static long long           MaxIdlePause;
+static long long           MaxForcedPause;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the current time in microseconds
+ */
+static long long GetTime( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/*
+ * helper function to get the size and usage of the memory pools - without
+ * querying the free blocks, EwGetHeapInfo() just sums up their counters
+ */
+static void GetHeapState( long* aTotal, long* aUsed )
+{
+  long total = 0;
+  long free  = 0;
+
+  EwGetHeapInfo( 0, &total, &free, 0, 0, 0, 0, 0, 0, 0 );
+
+  *aTotal = total;
+  *aUsed  = total - free;
+}
+
+
+/*
+ * helper function to determine whether garbage may be pending - only the
+ * allocations since the last collection can have become garbage
+ */
+static int IsGarbagePending( void )
+{
+  return Allocs != AllocsAfterGc;
+}
+
+
+/*
+ * helper function to estimate the next pause from the recent pauses
+ */
+static long long EstimatePause( void )
+{
+  long long pause = 0;
+  int       i;
+
+  for ( i = 0; i < NO_OF_PAUSES; i++ )
+    if ( Pauses[ i ] > pause )
+      pause = Pauses[ i ];
+
+  return pause;
+}
+
+
+/*
+ * helper function to run the Garbage Collector and to record its pause
+ */
+static void Collect( int aForced )
+{
+  long long start = GetTime();
+  long long pause;
+
+  EwReclaimMemory();
+
+  pause = GetTime() - start;
+
+  Pauses[ PauseIndex ] = pause;
+  PauseIndex = ( PauseIndex + 1 ) % NO_OF_PAUSES;
+  TotalPause += pause;
+
+  if ( aForced )
+  {
+    NoOfForcedCollections++;
+    if ( pause > MaxForcedPause )
+      MaxForcedPause = pause;
+  }
+  else
+  {
+    NoOfIdleCollections++;
+    if ( pause > MaxIdlePause )
+      MaxIdlePause = pause;
+  }
+
+  /* the following garbage is measured from the current allocations */
+  AllocsAfterGc    = Allocs;
+  AllocatedAfterGc = Allocated;
+  LastCollection   = GetTime();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerInit
+*
+* DESCRIPTION:
+*   The function GcSchedulerInit resets the state and the statistic of the
+*   garbage collection scheduler. It has to be called after the heap manager
+*   has been initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerInit( void )
+{
+  memset( Pauses, 0, sizeof( Pauses ));
+
+  Allocs                = 0;
+  Allocated             = 0;
+  AllocsAfterGc         = 0;
+  AllocatedAfterGc      = 0;
+  LastActivity          = GetTime();
+  LastCollection        = LastActivity;
+  PressureGarbage       = EW_GC_PRESSURE_MIN_GARBAGE;
+  PauseIndex            = 0;
+  NoOfIdleCollections   = 0;
+  NoOfForcedCollections = 0;
+  TotalPause            = 0;
+  MaxIdlePause          = 0;
+  MaxForcedPause        = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerDone
+*
+* DESCRIPTION:
+*   The function GcSchedulerDone prints the statistic of the garbage collection
+*   pauses.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerDone( void )
+{
+  unsigned int count = NoOfIdleCollections + NoOfForcedCollections;
+
+  EwPrint( "Garbage collections: %u idle (max %u us), %u forced (max %u us), "
+    "average pause %u us\n", NoOfIdleCollections, (unsigned int)MaxIdlePause,
+    NoOfForcedCollections, (unsigned int)MaxForcedPause,
+    (unsigned int)( count ? TotalPause / count : 0 ));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerProcess
+*
+* DESCRIPTION:
+*   The function GcSchedulerProcess starts the Garbage Collector if necessary.
+*   It has to be called after each processed frame with aTimeout < 0 and
+*   before the GUI thread is suspended with the time until the next timer.
+*   Within a frame, the garbage is collected under memory pressure only and
+*   only if enough memory has been allocated since the last collection. In
+*   the idle time, the garbage is collected when enough new garbage is expected
+*   and the estimated pause ends before the next timer expiration and the next
+*   vertical blank. After a longer period without any activity, the collection
+*   is done regardless of these deadlines. Without memory pools, the memory
+*   pressure is unknown - the garbage is collected at least periodically.
+*
+* ARGUMENTS:
+*   aTimeout - Time in milliseconds until the next timer expiration or -1 if
+*     called within the processing of a frame.
+*   aVBlank  - Time of the next vertical blank in microseconds (CLOCK_MONOTONIC)
+*     or 0 if unknown.
+*
+* RETURN VALUE:
+*   Returns 1 if the Garbage Collector was started, 0 otherwise.
+*
+*******************************************************************************/
+int GcSchedulerProcess( int aTimeout, long long aVBlank )
+{
+  long long now = GetTime();
+  long long budget;
+  long      total;
+  long      used;
+  long      usedAfterGc;
+
+  GetHeapState( &total, &used );
+
+  /* within a frame - collect the garbage only if the heap runs out of memory
+     and new garbage may have been produced since the last collection */
+  if ( aTimeout < 0 )
+  {
+    LastActivity = now;
+
+    if ( !total || (( total - used ) * 100LL >= total * (long long)EW_GC_PRESSURE_THRESHOLD ) ||
+         !IsGarbagePending() || ( Allocated - AllocatedAfterGc < PressureGarbage ))
+      return 0;
+
+    Collect( 1 );
+    GetHeapState( &total, &usedAfterGc );
+
+    /* the live set fills the heap - back off, as long as the collections free
+       almost nothing */
+    if ( used - usedAfterGc < EW_GC_PRESSURE_MIN_GARBAGE )
+    {
+      if ( PressureGarbage < (unsigned long long)total )
+        PressureGarbage *= 2;
+    }
+    else
+      PressureGarbage = EW_GC_PRESSURE_MIN_GARBAGE;
+
+    return 1;
+  }
+
+  if ( !IsGarbagePending())
+    return 0;
+
+  /* without memory pools, a continuous animation would postpone the
+     collection forever */
+  if ( !total && ( now - LastCollection >= EW_GC_MAX_INTERVAL * 1000LL ))
+  {
+    Collect( 0 );
+    return 1;
+  }
+
+  /* the idle time ends with the next timer expiration or vertical blank */
+  budget = aTimeout * 1000LL;
+
+  if ( aVBlank && ( aVBlank - now < budget ))
+    budget = aVBlank - now;
+
+  /* in the idle time - postpone the collection as long as the user interacts
+     with the GUI and the pause would delay the next frame */
+  if (( now - LastActivity < EW_GC_QUIET_TIME * 1000LL ) &&
+     (( Allocated - AllocatedAfterGc < EW_GC_IDLE_THRESHOLD ) || ( EstimatePause() > budget )))
+    return 0;
+
+  Collect( 0 );
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerCountAlloc
+*
+* DESCRIPTION:
+*   The function GcSchedulerCountAlloc has to be called for every memory block
+*   allocated by EwAlloc(). The allocations since the last collection are the
+*   potential garbage.
+*
+* ARGUMENTS:
+*   aSize - Size of the allocated memory block in bytes.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerCountAlloc( int aSize )
+{
+  Allocs++;
+  Allocated += aSize;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerGetTimeout
+*
+* DESCRIPTION:
+*   The function GcSchedulerGetTimeout returns the time, after which a pending
+*   garbage collection is started regardless of the idle time budget. The GUI
+*   thread should not be suspended longer than this time.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the timeout in milliseconds or -1 if no garbage collection is
+*   pending.
+*
+*******************************************************************************/
+int GcSchedulerGetTimeout( void )
+{
+  long long timeout;
+
+  if ( !IsGarbagePending())
+    return -1;
+
+  timeout = LastActivity + EW_GC_QUIET_TIME * 1000LL - GetTime();
+
+  return ( timeout > 0 ) ? (int)(( timeout + 999 ) / 1000 ) : 0;
+}
+
+
+/* msy */
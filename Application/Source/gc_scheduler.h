@@ -0,0 +1,178 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template decides, when the Garbage Collector (EwReclaimMemory()) is
+*   started. Instead of collecting after every processed event, the garbage is
+*   collected preferably while the GUI thread is idle and the expected pause
+*   fits into the time until the next timer expiration or vertical blank.
+*   Within the processing of a frame, the Garbage Collector is started under
+*   memory pressure only. The amount of new garbage is estimated from the
+*   memory allocated since the last collection (see GcSchedulerCountAlloc()).
+*   The memory pressure is taken from the memory pools (EwGetHeapInfo()) -
+*   without memory pools, the garbage is collected at least periodically. All
+*   pauses caused by the Garbage Collector are recorded.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef GC_SCHEDULER_H
+#define GC_SCHEDULER_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerInit
+*
+* DESCRIPTION:
+*   The function GcSchedulerInit resets the state and the statistic of the
+*   garbage collection scheduler. It has to be called after the heap manager
+*   has been initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerDone
+*
+* DESCRIPTION:
+*   The function GcSchedulerDone prints the statistic of the garbage collection
+*   pauses.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerProcess
+*
+* DESCRIPTION:
+*   The function GcSchedulerProcess starts the Garbage Collector if necessary.
+*   It has to be called after each processed frame with aTimeout < 0 and
+*   before the GUI thread is suspended with the time until the next timer.
+*   Within a frame, the garbage is collected under memory pressure only. In
+*   the idle time, the garbage is collected when enough new garbage is expected
+*   and the estimated pause ends before the next timer expiration and the next
+*   vertical blank. After a longer period without any activity, the collection
+*   is done regardless of these deadlines. Without memory pools, the memory
+*   pressure is unknown - the garbage is collected at least periodically.
+*
+* ARGUMENTS:
+*   aTimeout - Time in milliseconds until the next timer expiration or -1 if
+*     called within the processing of a frame.
+*   aVBlank  - Time of the next vertical blank in microseconds (CLOCK_MONOTONIC)
+*     or 0 if unknown.
+*
+* RETURN VALUE:
+*   Returns 1 if the Garbage Collector was started, 0 otherwise.
+*
+*******************************************************************************/
+int GcSchedulerProcess
+(
+  int                         aTimeout,
+  long long                   aVBlank
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerCountAlloc
+*
+* DESCRIPTION:
+*   The function GcSchedulerCountAlloc has to be called for every memory block
+*   allocated by EwAlloc(). The allocations since the last collection are the
+*   potential garbage.
+*
+* ARGUMENTS:
+*   aSize - Size of the allocated memory block in bytes.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GcSchedulerCountAlloc
+(
+  int                         aSize
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GcSchedulerGetTimeout
+*
+* DESCRIPTION:
+*   The function GcSchedulerGetTimeout returns the time, after which a pending
+*   garbage collection is started regardless of the idle time budget. The GUI
+*   thread should not be suspended longer than this time.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the timeout in milliseconds or -1 if no garbage collection is
+*   pending.
+*
+*******************************************************************************/
+int GcSchedulerGetTimeout
+(
+  void
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* GC_SCHEDULER_H */
+
+
+/* msy */
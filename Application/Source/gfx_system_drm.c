@@ -44,38 +44,180 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <linux/netlink.h>
 
 #include "ewrte.h"
+#include "boot_trace.h"
+#include "gpu_batch.h"
 #include "gfx_system_drm.h"
 
 #define DEFAULT_DRM_DEVICE "/dev/dri/card1"
 
-static drmModeModeInfo*    DrmMode = NULL;
-static int                 DrmFd;
-static uint32_t            DrmCrtcId;
-static drmModeConnector*   DrmConnector;
-static struct gbm_device*  GbmDevice;
-static struct gbm_surface* GbmSurface;
-static struct gbm_bo*      GbmBuffer;
+#ifndef EW_USE_ATOMIC_MODESETTING
+  #define EW_USE_ATOMIC_MODESETTING 1
+#endif
 
+#ifndef EW_RENDER_SCALE
+  #define EW_RENDER_SCALE 100
+#endif
 
-/*******************************************************************************
- * private functions
- *******************************************************************************/
-/*
- * callback function, called after frame buffer flip is done
- */
-static void DrmFbFlipCallback( int fd, unsigned int frame, unsigned int sec,
-  unsigned int usec, void* data )
+#ifndef EW_SPLASH_FILE
+  #define EW_SPLASH_FILE "/var/lib/embedded-wizard/splash.raw"
+#endif
+
+/* lowest render resolution in percent of the display mode */
+#define MIN_RENDER_SCALE    25
+
+/* maximum number of displays, overlay planes and imported dma-buf frame
+   buffers */
+#define MAX_NO_OF_DISPLAYS  4
+#define MAX_NO_OF_OVERLAYS  4
+#define MAX_NO_OF_DMABUFS   32
+
+/* time in ms to wait for the page flips of a display, that has been
+   reconnected - the flips of a lost link may never complete */
+#define HOTPLUG_FLIP_TIMEOUT  100
+
+/* identification of a boot splash image ('EWSP') - the header is followed by
+   the rows of XRGB8888 pixels without padding */
+#define SPLASH_MAGIC          0x50535745
+#define MAX_SPLASH_SIZE       8192
+
+/* properties of a plane, that are set by an atomic commit */
+enum
 {
-  /* suppress 'unused parameter' warnings */
-  (void)fd, (void)frame, (void)sec, (void)usec;
+  PLANE_FB_ID, PLANE_CRTC_ID, PLANE_SRC_X, PLANE_SRC_Y, PLANE_SRC_W, PLANE_SRC_H,
+  PLANE_CRTC_X, PLANE_CRTC_Y, PLANE_CRTC_W, PLANE_CRTC_H, PLANE_ZPOS,
+  NO_OF_PLANE_PROPS
+};
 
-  int* waiting_for_flip = data;
-  *waiting_for_flip = 0;
-}
+static const char* PlanePropNames[ NO_OF_PLANE_PROPS ] =
+{
+  "FB_ID", "CRTC_ID", "SRC_X", "SRC_Y", "SRC_W", "SRC_H",
+  "CRTC_X", "CRTC_Y", "CRTC_W", "CRTC_H", "zpos"
+};
 
+typedef struct
+{
+  uint32_t            Id;
+  uint32_t            Props[ NO_OF_PLANE_PROPS ];
+  uint64_t            ZPosMin;
+  uint64_t            ZPosMax;
+  int                 ZPosMutable;
+} XDrmPlane;
+
+typedef struct
+{
+  uint32_t            FbId;         /* 0 if the entry is not used */
+  int                 Width;
+  int                 Height;
+  XDmaBufReleaseProc  ReleaseProc;
+  void*               UserData;
+} XDmaBuf;
+
+typedef struct
+{
+  XDrmPlane           Plane;
+  XDmaBuf*            Buffer;       /* buffer to show with the next commit */
+  XDmaBuf*            CommitBuffer; /* buffer of the pending commit */
+  XDmaBuf*            ShownBuffer;  /* buffer currently scanned out */
+  int                 Above;        /* overlay is shown above the UI plane */
+  int                 X;
+  int                 Y;
+  int                 Width;
+  int                 Height;
+} XDrmOverlay;
+
+typedef struct
+{
+  drmModeConnector*   Connector;
+  drmModeModeInfo*    Mode;
+  uint32_t            CrtcId;
+  uint32_t            CrtcIndex;
+  uint32_t            ConnectorCrtcProp;
+  uint32_t            CrtcModeProp;
+  uint32_t            CrtcActiveProp;
+  uint32_t            ModeBlob;
+  int                 Connected;        /* the frames are shown on the display */
+  int                 ModeChanged;      /* the mode is set with the next commit */
+  XDrmPlane           PrimaryPlane;
+  XDrmPlane*          UiPlane;          /* plane showing the UI */
+  struct gbm_surface* GbmSurface;
+  struct gbm_bo*      GbmBuffer;        /* buffer currently scanned out */
+  struct gbm_bo*      GbmFlipBuffer;    /* buffer waiting for the page flip */
+  struct gbm_bo*      GbmQueuedBuffer;  /* buffer waiting for the next flip */
+  long long           FlipTime;         /* time of the recent page flip in us */
+  unsigned int        FlipSequence;     /* vblank counter of the recent page flip */
+  unsigned int        FlipGeneration;   /* incremented when the page flips are given up */
+  long long           Period;           /* measured duration of a frame in us */
+  EGLSurface          EglSurface;
+  GLint               EglFramebuffer;
+  EGLint              EglWidth;
+  EGLint              EglHeight;
+  struct gbm_surface* RetiredSurface;   /* surface replaced by a new render scale */
+  struct gbm_bo*      RetiredBuffer;    /* its buffer still scanned out */
+  EGLSurface          RetiredEglSurface;
+} XDrmDisplay;
+
+typedef struct
+{
+  uint32_t            Magic;        /* SPLASH_MAGIC */
+  uint32_t            Width;
+  uint32_t            Height;
+  uint32_t            Format;       /* GBM_FORMAT_XRGB8888 */
+} XSplashHeader;
+
+static int                 DrmFd = -1;
+static int                 HotplugFd = -1;   /* netlink socket receiving uevents */
+static XDrmDisplay         DrmDisplays[ MAX_NO_OF_DISPLAYS ];
+static int                 DrmNoOfDisplays = 0;
+static struct gbm_device*  GbmDevice;
+static uint32_t            GbmFormat;
+static EGLDisplay          EglDisplay;
+static EGLConfig           EglConfig;
+static EGLContext          EglContext;
+static int                 DrmRenderScale = 100;  /* render resolution in percent */
+static uint32_t            SplashFb;         /* dumb buffer shown until the first frame */
+static uint32_t            SplashHandle;
+
+/* the background layer and the overlays belong to the first display */
+static struct gbm_surface* GbmBgSurface;
+static struct gbm_bo*      GbmBgBuffer;        /* background to show with the next commit */
+static struct gbm_bo*      GbmBgCommitBuffer;  /* background of the pending commit */
+static struct gbm_bo*      GbmBgShownBuffer;   /* background currently scanned out */
+static EGLSurface          EglBgSurface = EGL_NO_SURFACE;
+
+static int                 DrmAtomic = 0;    /* atomic modesetting is used */
+static XDrmPlane           DrmLayerPlane;    /* overlay showing the UI above the background */
+static XDrmOverlay         DrmOverlays[ MAX_NO_OF_OVERLAYS ];
+static int                 DrmNoOfOverlays = 0;
+static int                 DrmOverlayChanged = 0;
+static XDmaBuf             DmaBufs[ MAX_NO_OF_DMABUFS ];
+
+static int                 EglBufferAge = 0;
+static PFNEGLSETDAMAGEREGIONKHRPROC      EglSetDamageRegion       = 0;
+static PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC EglSwapBuffersWithDamage = 0;
+static EGLint              GlDamage[ 4 ];    /* area to redraw in EGL coordinates */
+static int                 GlDamageActive = 0;
+
+static void DrmFbFlipCallback( int fd, unsigned int frame, unsigned int sec,
+  unsigned int usec, void* data );
 
+static drmEventContext     DrmEventContext =
+{
+  .version = 2,
+  .page_flip_handler = DrmFbFlipCallback
+};
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
 /*
  * callback function to destroy a drm frame buffer
  */
@@ -121,418 +263,2705 @@ static uint32_t DrmGetFb( struct gbm_bo* aGbmBuffer )
 }
 
 /*
- * helper function to get the config index for the given visual_id
+ * helper function to get the id of the named property of a DRM object
  */
-static int match_config_to_visual( EGLDisplay egl_display, EGLint visual_id,
-  EGLConfig* configs, int count )
+static uint32_t DrmGetPropId( uint32_t aObjectId, uint32_t aObjectType, const char* aName )
+{
+  drmModeObjectProperties* props = drmModeObjectGetProperties( DrmFd, aObjectId, aObjectType );
+  drmModePropertyRes*      prop;
+  uint32_t                 id = 0;
+  uint32_t                 i;
+
+  if ( !props )
+    return 0;
+
+  for ( i = 0; !id && ( i < props->count_props ); i++ )
+  {
+    prop = drmModeGetProperty( DrmFd, props->props[ i ]);
+    if ( !prop )
+      continue;
+
+    if ( !strcmp( prop->name, aName ))
+      id = prop->prop_id;
+
+    drmModeFreeProperty( prop );
+  }
+
+  drmModeFreeObjectProperties( props );
+  return id;
+}
+
+
+/*
+ * helper function to get the properties of a plane - returns the plane type
+ * (DRM_PLANE_TYPE_xxx) or -1 if the plane is not usable
+ */
+static int DrmGetPlane( uint32_t aPlaneId, XDrmPlane* aPlane )
+{
+  drmModeObjectProperties* props = drmModeObjectGetProperties( DrmFd, aPlaneId, DRM_MODE_OBJECT_PLANE );
+  drmModePropertyRes*      prop;
+  int                      type = -1;
+  uint32_t                 i;
+  int                      n;
+
+  if ( !props )
+    return -1;
+
+  memset( aPlane, 0, sizeof( XDrmPlane ));
+  aPlane->Id = aPlaneId;
+
+  for ( i = 0; i < props->count_props; i++ )
+  {
+    prop = drmModeGetProperty( DrmFd, props->props[ i ]);
+    if ( !prop )
+      continue;
+
+    if ( !strcmp( prop->name, "type" ))
+      type = (int)props->prop_values[ i ];
+
+    for ( n = 0; n < NO_OF_PLANE_PROPS; n++ )
+      if ( !strcmp( prop->name, PlanePropNames[ n ]))
+        aPlane->Props[ n ] = prop->prop_id;
+
+    /* the z-position is either fixed or can be chosen within a range */
+    if ( !strcmp( prop->name, "zpos" ))
+    {
+      aPlane->ZPosMutable = !( prop->flags & DRM_MODE_PROP_IMMUTABLE ) && ( prop->count_values >= 2 );
+      aPlane->ZPosMin     = aPlane->ZPosMutable ? prop->values[ 0 ] : props->prop_values[ i ];
+      aPlane->ZPosMax     = aPlane->ZPosMutable ? prop->values[ 1 ] : props->prop_values[ i ];
+    }
+
+    drmModeFreeProperty( prop );
+  }
+
+  drmModeFreeObjectProperties( props );
+
+  /* without these properties, the plane cannot be used by an atomic commit */
+  for ( n = PLANE_FB_ID; n <= PLANE_CRTC_H; n++ )
+    if ( !aPlane->Props[ n ])
+      return -1;
+
+  return type;
+}
+
+
+/*
+ * helper function to find the display, that shows the given EGL surface
+ */
+static XDrmDisplay* DrmGetDisplay( EGLSurface aSurface )
 {
   int i;
 
-  for ( i = 0; i < count; ++i )
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+    if ( DrmDisplays[ i ].EglSurface == aSurface )
+      return &DrmDisplays[ i ];
+
+  return NULL;
+}
+
+
+/*
+ * helper function to find a CRTC, that can drive the given connector and is
+ * not used by another display - the CRTC currently connected is preferred
+ */
+static uint32_t DrmFindCrtc( drmModeRes* aResources, drmModeConnector* aConnector,
+  uint32_t* aCrtcIndex )
+{
+  drmModeEncoder* encoder;
+  uint32_t        crtcId = 0;
+  int             e;
+  int             c;
+  int             d;
+
+  for ( e = 0; e < aConnector->count_encoders; e++ )
   {
-    EGLint id;
+    encoder = drmModeGetEncoder( DrmFd, aConnector->encoders[ e ]);
+    if ( !encoder )
+      continue;
 
-    if ( ! eglGetConfigAttrib( egl_display, configs[ i ], EGL_NATIVE_VISUAL_ID, &id ))
+    for ( c = 0; c < aResources->count_crtcs; c++ )
+    {
+      if ( !( encoder->possible_crtcs & ( 1 << c )))
+        continue;
+
+      for ( d = 0; ( d < DrmNoOfDisplays ) && ( DrmDisplays[ d ].CrtcId != aResources->crtcs[ c ]); d++ )
+        ;
+
+      if ( d < DrmNoOfDisplays )
+        continue;
+
+      if ( !crtcId || (( encoder->encoder_id == aConnector->encoder_id ) &&
+         ( encoder->crtc_id == aResources->crtcs[ c ])))
+      {
+        crtcId      = aResources->crtcs[ c ];
+        *aCrtcIndex = c;
+      }
+    }
+
+    drmModeFreeEncoder( encoder );
+  }
+
+  return crtcId;
+}
+
+
+/*
+ * helper function to switch to atomic modesetting and to enumerate the
+ * primary planes of all displays and the overlay planes, that can be
+ * connected to the CRTC of the first display
+ */
+static int DrmAtomicInit( void )
+{
+  drmModePlaneRes* planes;
+  drmModePlane*    plane;
+  XDrmPlane        drmPlane;
+  XDrmDisplay*     display;
+  uint32_t         i;
+  int              type;
+  int              d;
+
+  DrmAtomic       = 0;
+  DrmNoOfOverlays = 0;
+  memset( DrmOverlays, 0, sizeof( DrmOverlays ));
+
+  for ( d = 0; d < DrmNoOfDisplays; d++ )
+    memset( &DrmDisplays[ d ].PrimaryPlane, 0, sizeof( XDrmPlane ));
+
+  if ( drmSetClientCap( DrmFd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1 ) ||
+       drmSetClientCap( DrmFd, DRM_CLIENT_CAP_ATOMIC, 1 ))
+    return 0;
+
+  planes = drmModeGetPlaneResources( DrmFd );
+  if ( !planes )
+    return 0;
+
+  for ( i = 0; i < planes->count_planes; i++ )
+  {
+    plane = drmModeGetPlane( DrmFd, planes->planes[ i ]);
+    if ( !plane )
       continue;
 
-    if ( id == visual_id )
-      return i;
+    type = DrmGetPlane( plane->plane_id, &drmPlane );
+
+    /* each plane is used by one display only */
+    for ( d = 0; d < DrmNoOfDisplays; d++ )
+    {
+      display = &DrmDisplays[ d ];
+
+      if ( !( plane->possible_crtcs & ( 1 << display->CrtcIndex )))
+        continue;
+
+      if (( type == DRM_PLANE_TYPE_PRIMARY ) && !display->PrimaryPlane.Id )
+      {
+        display->PrimaryPlane = drmPlane;
+        break;
+      }
+
+      if (( type == DRM_PLANE_TYPE_OVERLAY ) && ( d == 0 ) && ( DrmNoOfOverlays < MAX_NO_OF_OVERLAYS ))
+      {
+        DrmOverlays[ DrmNoOfOverlays++ ].Plane = drmPlane;
+        break;
+      }
+    }
+
+    drmModeFreePlane( plane );
+  }
+
+  drmModeFreePlaneResources( planes );
+
+  /* otherwise the legacy API is used */
+  DrmAtomic = DrmNoOfDisplays > 0;
+
+  for ( d = 0; d < DrmNoOfDisplays; d++ )
+  {
+    display = &DrmDisplays[ d ];
+
+    display->ConnectorCrtcProp = DrmGetPropId( display->Connector->connector_id,
+      DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID" );
+    display->CrtcModeProp      = DrmGetPropId( display->CrtcId, DRM_MODE_OBJECT_CRTC, "MODE_ID" );
+    display->CrtcActiveProp    = DrmGetPropId( display->CrtcId, DRM_MODE_OBJECT_CRTC, "ACTIVE" );
+
+    DrmAtomic = DrmAtomic && display->PrimaryPlane.Id && display->ConnectorCrtcProp &&
+                display->CrtcModeProp && display->CrtcActiveProp;
+  }
+
+  if ( !DrmAtomic )
+    DrmNoOfOverlays = 0;
+
+  return DrmAtomic;
+}
+
+
+/*
+ * helper function to add the state of a plane to an atomic request - planes
+ * without a frame buffer are disabled
+ */
+static void DrmAtomicAddPlane( drmModeAtomicReq* aRequest, XDrmDisplay* aDisplay,
+  XDrmPlane* aPlane, uint32_t aFbId, int aSrcWidth, int aSrcHeight, int aX, int aY,
+  int aWidth, int aHeight, int aZPos )
+{
+  uint32_t* props = aPlane->Props;
+  uint32_t  id    = aPlane->Id;
+
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_FB_ID   ], aFbId );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_CRTC_ID ], aFbId ? aDisplay->CrtcId : 0 );
+
+  if ( !aFbId )
+    return;
+
+  /* the source rectangle is given in 16.16 fixed point - the HVS scales it
+     to the destination rectangle */
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_SRC_X  ], 0 );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_SRC_Y  ], 0 );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_SRC_W  ], (uint64_t)aSrcWidth  << 16 );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_SRC_H  ], (uint64_t)aSrcHeight << 16 );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_CRTC_X ], (uint64_t)(int64_t)aX );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_CRTC_Y ], (uint64_t)(int64_t)aY );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_CRTC_W ], aWidth );
+  drmModeAtomicAddProperty( aRequest, id, props[ PLANE_CRTC_H ], aHeight );
+
+  if ( props[ PLANE_ZPOS ] && aPlane->ZPosMutable )
+    drmModeAtomicAddProperty( aRequest, id, props[ PLANE_ZPOS ], aZPos );
+}
+
+
+/*
+ * helper function to add the state of an overlay to an atomic request - an
+ * overlay, that is not shown, is left untouched unless the mode is set
+ */
+static void DrmAtomicAddOverlay( drmModeAtomicReq* aRequest, XDrmDisplay* aDisplay,
+  XDrmOverlay* aOverlay, int aZPos, int aModeSet )
+{
+  XDmaBuf* buffer = aOverlay->Buffer;
+
+  if ( buffer )
+    DrmAtomicAddPlane( aRequest, aDisplay, &aOverlay->Plane, buffer->FbId, buffer->Width,
+      buffer->Height, aOverlay->X, aOverlay->Y, aOverlay->Width, aOverlay->Height, aZPos );
+  else if ( aOverlay->ShownBuffer || aModeSet )
+    DrmAtomicAddPlane( aRequest, aDisplay, &aOverlay->Plane, 0, 0, 0, 0, 0, 0, 0, aZPos );
+}
+
+
+/*
+ * helper function to add the UI plane of a display to an atomic request -
+ * on the first display, the overlays below the UI plane are stacked first,
+ * followed by the UI plane and the overlays above it
+ */
+static void DrmAtomicAddDisplay( drmModeAtomicReq* aRequest, XDrmDisplay* aDisplay,
+  uint32_t aFbId, int aModeSet )
+{
+  drmModeModeInfo* mode  = aDisplay->Mode;
+  int              first = ( aDisplay == DrmDisplays );
+  int              zpos  = 0;
+  int              i;
+
+  if ( aModeSet )
+  {
+    drmModeAtomicAddProperty( aRequest, aDisplay->Connector->connector_id,
+      aDisplay->ConnectorCrtcProp, aDisplay->CrtcId );
+    drmModeAtomicAddProperty( aRequest, aDisplay->CrtcId, aDisplay->CrtcModeProp, aDisplay->ModeBlob );
+    drmModeAtomicAddProperty( aRequest, aDisplay->CrtcId, aDisplay->CrtcActiveProp, 1 );
+  }
+
+  /* the background layer is the lowest plane - the UI is shown by an overlay.
+     After a mode change, the background is scaled to the new mode */
+  if ( first && GbmBgBuffer )
+    DrmAtomicAddPlane( aRequest, aDisplay, &aDisplay->PrimaryPlane, DrmGetFb( GbmBgBuffer ),
+      gbm_bo_get_width( GbmBgBuffer ), gbm_bo_get_height( GbmBgBuffer ), 0, 0,
+      mode->hdisplay, mode->vdisplay, zpos++ );
+
+  for ( i = 0; first && ( i < DrmNoOfOverlays ); i++ )
+    if ( !DrmOverlays[ i ].Above )
+      DrmAtomicAddOverlay( aRequest, aDisplay, &DrmOverlays[ i ], zpos++, aModeSet );
+
+  /* the UI may be rendered at reduced resolution - it is scaled to the mode */
+  DrmAtomicAddPlane( aRequest, aDisplay, aDisplay->UiPlane, aFbId, aDisplay->EglWidth,
+    aDisplay->EglHeight, 0, 0, mode->hdisplay, mode->vdisplay, zpos++ );
+
+  for ( i = 0; first && ( i < DrmNoOfOverlays ); i++ )
+    if ( DrmOverlays[ i ].Above )
+      DrmAtomicAddOverlay( aRequest, aDisplay, &DrmOverlays[ i ], zpos++, aModeSet );
+}
+
+
+/*
+ * helper function to take over the overlays and the background of a
+ * successful commit - they are shown as soon as the commit is completed
+ */
+static void DrmAtomicSetCommitBuffers( void )
+{
+  int i;
+
+  for ( i = 0; i < DrmNoOfOverlays; i++ )
+    DrmOverlays[ i ].CommitBuffer = DrmOverlays[ i ].Buffer;
+
+  GbmBgCommitBuffer = GbmBgBuffer;
+  DrmOverlayChanged = 0;
+}
+
+
+/*
+ * helper function to get the user data of the page flip events of a display -
+ * it contains the flip generation, so the events of given up flips can be
+ * recognized when they arrive later
+ */
+static void* DrmFlipData( XDrmDisplay* aDisplay )
+{
+  return (void*)(uintptr_t)((uintptr_t)aDisplay->FlipGeneration * MAX_NO_OF_DISPLAYS +
+    ( aDisplay - DrmDisplays ) + 1 );
+}
+
+
+/*
+ * helper function to commit the UI plane of a display - the overlays and the
+ * background are committed together with the first display
+ */
+static int DrmAtomicCommit( XDrmDisplay* aDisplay, uint32_t aFbId, uint32_t aFlags )
+{
+  drmModeAtomicReq* request = drmModeAtomicAlloc();
+  int               ret;
+
+  if ( !request )
+    return 0;
+
+  /* a reconnected display gets its mode together with the next frame */
+  if ( aDisplay->ModeChanged )
+    aFlags |= DRM_MODE_ATOMIC_ALLOW_MODESET;
+
+  DrmAtomicAddDisplay( request, aDisplay, aFbId, aDisplay->ModeChanged );
+
+  ret = drmModeAtomicCommit( DrmFd, request, aFlags, DrmFlipData( aDisplay ));
+  drmModeAtomicFree( request );
+
+  if ( ret )
+    return 0;
+
+  if ( !( aFlags & DRM_MODE_ATOMIC_TEST_ONLY ))
+    aDisplay->ModeChanged = 0;
+
+  if ( !( aFlags & DRM_MODE_ATOMIC_TEST_ONLY ) && ( aDisplay == DrmDisplays ))
+    DrmAtomicSetCommitBuffers();
+
+  return 1;
+}
+
+
+/*
+ * helper function to set the mode of all displays by one atomic commit - the
+ * overlays are disabled as well. With DRM_MODE_ATOMIC_TEST_ONLY, the
+ * configuration is verified only
+ */
+static int DrmAtomicModeSet( uint32_t aFlags )
+{
+  drmModeAtomicReq* request = drmModeAtomicAlloc();
+  XDrmDisplay*      display;
+  int               ret = 0;
+  int               i;
+
+  if ( !request )
+    return 0;
+
+  for ( i = 0; !ret && ( i < DrmNoOfDisplays ); i++ )
+  {
+    display = &DrmDisplays[ i ];
+
+    if ( display->ModeBlob )
+      drmModeDestroyPropertyBlob( DrmFd, display->ModeBlob );
+
+    display->ModeBlob = 0;
+    ret               = drmModeCreatePropertyBlob( DrmFd, display->Mode, sizeof( drmModeModeInfo ),
+                          &display->ModeBlob );
+
+    if ( !ret )
+      DrmAtomicAddDisplay( request, display, DrmGetFb( display->GbmBuffer ), 1 );
+  }
+
+  if ( !ret )
+    ret = drmModeAtomicCommit( DrmFd, request, DRM_MODE_ATOMIC_ALLOW_MODESET | aFlags, NULL );
+
+  drmModeAtomicFree( request );
+
+  if ( ret )
+    return 0;
+
+  if ( !( aFlags & DRM_MODE_ATOMIC_TEST_ONLY ))
+    DrmAtomicSetCommitBuffers();
+
+  return 1;
+}
+
+
+/*
+ * helper function to update the overlays after the completion of a commit of
+ * the first display - the buffers, that are not scanned out anymore, are
+ * returned to their owner
+ */
+static void DrmAtomicCompleted( void )
+{
+  XDrmOverlay*   overlay;
+  XDmaBuf*       buffer;
+  struct gbm_bo* bgBuffer = GbmBgShownBuffer;
+  int            i;
+
+  GbmBgShownBuffer = GbmBgCommitBuffer;
+
+  if ( bgBuffer && ( bgBuffer != GbmBgShownBuffer ) && ( bgBuffer != GbmBgBuffer ))
+    gbm_surface_release_buffer( GbmBgSurface, bgBuffer );
+
+  for ( i = 0; i < DrmNoOfOverlays; i++ )
+  {
+    overlay = &DrmOverlays[ i ];
+    buffer  = overlay->ShownBuffer;
+
+    overlay->ShownBuffer = overlay->CommitBuffer;
+
+    if ( buffer && ( buffer != overlay->ShownBuffer ) && ( buffer != overlay->Buffer ) &&
+         buffer->ReleaseProc )
+      buffer->ReleaseProc((int)( buffer - DmaBufs ) + 1, buffer->UserData );
   }
+}
+
+
+/*
+ * helper function to remove the boot splash - it must not be scanned out
+ * anymore
+ */
+static void DrmReleaseSplash( void )
+{
+  struct drm_mode_destroy_dumb destroy;
+
+  if ( SplashFb )
+    drmModeRmFB( DrmFd, SplashFb );
+
+  if ( SplashHandle )
+  {
+    memset( &destroy, 0, sizeof( destroy ));
+    destroy.handle = SplashHandle;
+    drmIoctl( DrmFd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy );
+  }
+
+  SplashFb     = 0;
+  SplashHandle = 0;
+}
+
+/*
+ * helper function to get the imported dma-buf with the given handle
+ */
+static XDmaBuf* DrmGetDmaBuf( int aBuffer )
+{
+  if (( aBuffer < 1 ) || ( aBuffer > MAX_NO_OF_DMABUFS ) || !DmaBufs[ aBuffer - 1 ].FbId )
+    return NULL;
+
+  return &DmaBufs[ aBuffer - 1 ];
+}
+
+
+/*
+ * helper function to create the GBM and EGL surface of a display with the
+ * given size
+ */
+static int DrmEglCreateSurface( XDrmDisplay* aDisplay, int aWidth, int aHeight )
+{
+  struct gbm_surface* gbmSurface;
+  EGLSurface          eglSurface;
+
+  gbmSurface = gbm_surface_create( GbmDevice, aWidth, aHeight, GbmFormat,
+    GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING );
+  if ( !gbmSurface )
+    return 0;
+
+  eglSurface = eglCreateWindowSurface( EglDisplay, EglConfig, (EGLNativeWindowType)gbmSurface, 0 );
+  if ( eglSurface == EGL_NO_SURFACE )
+  {
+    gbm_surface_destroy( gbmSurface );
+    return 0;
+  }
+
+  #if EW_PERFORM_FULLSCREEN_UPDATE == 0
+    eglSurfaceAttrib( EglDisplay, eglSurface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED );
+  #else
+    eglSurfaceAttrib( EglDisplay, eglSurface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_DESTROYED );
+  #endif
+
+  aDisplay->GbmSurface = gbmSurface;
+  aDisplay->EglSurface = eglSurface;
+
+  eglQuerySurface( EglDisplay, eglSurface, EGL_WIDTH,  &aDisplay->EglWidth );
+  eglQuerySurface( EglDisplay, eglSurface, EGL_HEIGHT, &aDisplay->EglHeight );
+
+  return 1;
+}
+
+
+/*
+ * helper function to destroy the surface, that was replaced by a surface with
+ * another render scale - as soon as its buffer is not scanned out anymore
+ */
+static void DrmEglReleaseRetired( XDrmDisplay* aDisplay )
+{
+  if ( !aDisplay->RetiredSurface )
+    return;
+
+  if ( aDisplay->RetiredBuffer )
+    gbm_surface_release_buffer( aDisplay->RetiredSurface, aDisplay->RetiredBuffer );
+
+  eglDestroySurface( EglDisplay, aDisplay->RetiredEglSurface );
+  gbm_surface_destroy( aDisplay->RetiredSurface );
+
+  aDisplay->RetiredSurface    = NULL;
+  aDisplay->RetiredBuffer     = NULL;
+  aDisplay->RetiredEglSurface = EGL_NO_SURFACE;
+}
+
+
+/*
+ * helper function to calculate the size of the UI surface for the given render
+ * scale in percent
+ */
+static int DrmScaleSize( int aSize, int aScale )
+{
+  return ( aSize * aScale + 99 ) / 100;
+}
+
+
+/*
+ * helper function to schedule the page flip of the given buffer - with atomic
+ * modesetting, the pending changes of the overlays are committed too
+ */
+static int DrmPageFlip( XDrmDisplay* aDisplay, struct gbm_bo* aGbmBuffer )
+{
+  uint32_t        fb_id = DrmGetFb( aGbmBuffer );
+  struct timespec ts;
+  int             ok;
+
+  /* the legacy API sets the mode of a reconnected display synchronously - the
+     completion of the flip is reported immediately */
+  if ( !DrmAtomic && aDisplay->ModeChanged && fb_id &&
+       !drmModeSetCrtc( DrmFd, aDisplay->CrtcId, fb_id, 0, 0,
+         &aDisplay->Connector->connector_id, 1, aDisplay->Mode ))
+  {
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    aDisplay->ModeChanged   = 0;
+    aDisplay->GbmFlipBuffer = aGbmBuffer;
+    DrmFbFlipCallback( DrmFd, 0, ts.tv_sec, ts.tv_nsec / 1000, DrmFlipData( aDisplay ));
+    return 1;
+  }
+
+  if ( DrmAtomic )
+    ok = fb_id && DrmAtomicCommit( aDisplay, fb_id, DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT );
+  else
+    ok = fb_id && !drmModePageFlip( DrmFd, aDisplay->CrtcId, fb_id, DRM_MODE_PAGE_FLIP_EVENT,
+      DrmFlipData( aDisplay ));
+
+  if ( ok )
+  {
+    aDisplay->GbmFlipBuffer = aGbmBuffer;
+    return 1;
+  }
+
+  /* the buffer cannot be shown - return it to the surface to render on again,
+     unless it is already on the screen (commit of the overlays only) */
+  if ( aGbmBuffer != aDisplay->GbmBuffer )
+    gbm_surface_release_buffer( aDisplay->GbmSurface, aGbmBuffer );
+
+  return 0;
+}
+
+
+/*
+ * helper function to return the duration of one frame in us - the value
+ * measured from the page flips or, until then, the value of the display mode
+ */
+static long long DrmGetFramePeriod( XDrmDisplay* aDisplay )
+{
+  if ( aDisplay->Period )
+    return aDisplay->Period;
+
+  /* the pixel clock is given in kHz */
+  if ( !aDisplay->Mode || !aDisplay->Mode->clock )
+    return 0;
+
+  return (long long)aDisplay->Mode->htotal * aDisplay->Mode->vtotal * 1000 /
+    aDisplay->Mode->clock;
+}
+
+
+/*
+ * helper function to refine the duration of a frame by the timestamp and the
+ * vblank counter of a page flip - the nominal refresh rate of the mode differs
+ * slightly from the real one and the predicted vblanks would drift away
+ */
+static void DrmMeasureFramePeriod( XDrmDisplay* aDisplay, unsigned int aSequence,
+  long long aTime )
+{
+  long long nominal = DrmGetFramePeriod( aDisplay );
+  long long period;
+
+  /* the synthetic flips of the legacy API do not provide a vblank counter */
+  if ( aSequence && aDisplay->FlipSequence && ( aSequence != aDisplay->FlipSequence ) &&
+     ( aTime > aDisplay->FlipTime ) && nominal )
+  {
+    period = ( aTime - aDisplay->FlipTime ) / (unsigned int)( aSequence - aDisplay->FlipSequence );
+
+    /* ignore implausible values, e.g. after the display has been switched
+       off - otherwise low-pass filter the measurement */
+    if (( period > nominal - nominal / 4 ) && ( period < nominal + nominal / 4 ))
+      aDisplay->Period = nominal + ( period - nominal ) / 8;
+  }
+
+  aDisplay->FlipSequence = aSequence;
+}
+
+
+/*
+ * callback function, called after frame buffer flip is done - the flip of
+ * each display is reported separately
+ */
+static void DrmFbFlipCallback( int fd, unsigned int frame, unsigned int sec,
+  unsigned int usec, void* data )
+{
+  uintptr_t    flip    = (uintptr_t)data;
+  XDrmDisplay* display;
+  long long    time    = sec * 1000000LL + usec;
+
+  /* suppress 'unused parameter' warnings */
+  (void)fd;
+
+  if ( !flip )
+    return;
+
+  /* the flip has been given up after a hotplug event - its buffers are
+     already accounted, the event must not release the current buffer */
+  display = &DrmDisplays[( flip - 1 ) % MAX_NO_OF_DISPLAYS ];
+
+  if ( flip != (uintptr_t)DrmFlipData( display ))
+    return;
+
+  /* the timestamp of the vblank (CLOCK_MONOTONIC) and the measured frame
+     duration serve as model for the prediction of the following vblanks */
+  DrmMeasureFramePeriod( display, frame, time );
+  display->FlipTime = time;
+
+  /* the flipped buffer is on screen now - release the previous one */
+  if ( display->GbmBuffer && ( display->GbmBuffer != display->GbmFlipBuffer ))
+    gbm_surface_release_buffer( display->GbmSurface, display->GbmBuffer );
+
+  display->GbmBuffer     = display->GbmFlipBuffer;
+  display->GbmFlipBuffer = NULL;
+
+  /* the first frame with a new render scale is on screen */
+  DrmEglReleaseRetired( display );
+
+  /* the first frame replaces the boot splash and completes the boot trace */
+  if ( display == DrmDisplays )
+  {
+    DrmAtomicCompleted();
+    DrmReleaseSplash();
+    BootTraceFirstFlip( display->FlipTime );
+  }
+
+  /* a further frame is already waiting - show it with the next vblank */
+  if ( display->GbmQueuedBuffer )
+  {
+    DrmPageFlip( display, display->GbmQueuedBuffer );
+    display->GbmQueuedBuffer = NULL;
+  }
+
+  /* the overlays have changed meanwhile - commit them with the unchanged UI */
+  else if (( display == DrmDisplays ) && DrmOverlayChanged && display->GbmBuffer )
+    DrmPageFlip( display, display->GbmBuffer );
+}
+
+
+/*
+ * helper function to wait for and to dispatch the next DRM event - returns 0
+ * if no event has arrived within the given time in ms (-1 = infinite)
+ */
+static int DrmWaitForEvent( int aTimeout )
+{
+  struct pollfd p;
+  int           ret;
+
+  p.fd     = DrmFd;
+  p.events = POLLIN;
+
+  do
+    ret = poll( &p, 1, aTimeout );
+  while (( ret < 0 ) && ( errno == EINTR ));
+
+  if (( ret <= 0 ) || !( p.revents & POLLIN ))
+    return 0;
+
+  return drmHandleEvent( DrmFd, &DrmEventContext ) == 0;
+}
+
+
+/*
+ * helper function to show the recently swapped EGL buffer of a display
+ */
+static void DrmPresent( XDrmDisplay* aDisplay )
+{
+  struct gbm_bo* next_bo = gbm_surface_lock_front_buffer( aDisplay->GbmSurface );
+
+  if ( !next_bo )
+    return;
+
+  /* the display is disconnected - the frame is dropped until it returns */
+  if ( !aDisplay->Connected )
+  {
+    gbm_surface_release_buffer( aDisplay->GbmSurface, next_bo );
+    return;
+  }
+
+  /* only one frame can wait for the next flip - wait for the pending flip,
+     which takes over the queued frame */
+  while ( aDisplay->GbmQueuedBuffer && DrmWaitForEvent( -1 ))
+    ;
+
+  /* show the new frame immediately or with the next vblank */
+  if ( aDisplay->GbmFlipBuffer )
+    aDisplay->GbmQueuedBuffer = next_bo;
+  else
+    DrmPageFlip( aDisplay, next_bo );
+
+  /* the GUI thread continues with the next frame while the current one is
+     scanned out - block only if no free buffer is left to render on */
+  while ( !gbm_surface_has_free_buffers( aDisplay->GbmSurface ) && aDisplay->GbmFlipBuffer &&
+          DrmWaitForEvent( -1 ))
+    ;
+}
+
+
+/*
+ * helper function to convert the given area into EGL rectangle coordinates
+ * with the origin at the bottom-left corner of the surface
+ */
+static void DrmEglRect( XDrmDisplay* aDisplay, EGLint* aRect, int aX, int aY,
+  int aWidth, int aHeight )
+{
+  aRect[ 0 ] = aX;
+  aRect[ 1 ] = aDisplay->EglHeight - aY - aHeight;
+  aRect[ 2 ] = aWidth;
+  aRect[ 3 ] = aHeight;
+}
+
+
+/*
+ * helper function to replace the surface of a display by a new surface with
+ * the given size - the pending page flips have to be completed. The previous
+ * surface is retired until the first frame of the new surface is on screen
+ */
+static int DrmEglReplaceSurface( XDrmDisplay* aDisplay, int aWidth, int aHeight )
+{
+  struct gbm_surface* gbmSurface = aDisplay->GbmSurface;
+  struct gbm_bo*      gbmBuffer  = aDisplay->GbmBuffer;
+  EGLSurface          eglSurface = aDisplay->EglSurface;
+
+  if ( !DrmEglCreateSurface( aDisplay, aWidth, aHeight ))
+    return 0;
+
+  eglMakeCurrent( EglDisplay, aDisplay->EglSurface, aDisplay->EglSurface, EglContext );
+  glGetIntegerv( GL_FRAMEBUFFER_BINDING, &aDisplay->EglFramebuffer );
+
+  /* the surface replaced before is still on the screen - the current one has
+     never been shown and can be destroyed immediately */
+  if ( aDisplay->RetiredSurface )
+  {
+    eglDestroySurface( EglDisplay, eglSurface );
+    gbm_surface_destroy( gbmSurface );
+  }
+  else
+  {
+    aDisplay->RetiredSurface    = gbmSurface;
+    aDisplay->RetiredBuffer     = gbmBuffer;
+    aDisplay->RetiredEglSurface = eglSurface;
+  }
+
+  aDisplay->GbmBuffer = NULL;
+  return 1;
+}
+
+
+/*
+ * helper function to find the preferred mode of a connector
+ */
+static drmModeModeInfo* DrmFindMode( drmModeConnector* aConnector )
+{
+  int m;
+
+  for ( m = 0; m < aConnector->count_modes; m++ )
+    if ( aConnector->modes[ m ].type & DRM_MODE_TYPE_PREFERRED )
+      return &aConnector->modes[ m ];
+
+  return NULL;
+}
+
+
+/*
+ * helper function to open a netlink socket receiving the uevents of the
+ * kernel - returns -1 if the uevents are not available
+ */
+static int DrmOpenUevents( void )
+{
+  struct sockaddr_nl addr;
+  int                fd;
+
+  fd = socket( AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT );
+  if ( fd < 0 )
+    return -1;
+
+  memset( &addr, 0, sizeof( addr ));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = 1;  /* uevents sent by the kernel */
+
+  if ( bind( fd, (struct sockaddr*)&addr, sizeof( addr )))
+  {
+    close( fd );
+    return -1;
+  }
+
+  return fd;
+}
+
+
+/*
+ * helper function to determine whether a uevent reports a change of the DRM
+ * connectors - the uevent consists of zero terminated KEY=value strings
+ */
+static int DrmIsHotplugEvent( const char* aEvent, int aSize )
+{
+  const char* end     = aEvent + aSize;
+  int         drm     = 0;
+  int         hotplug = 0;
+
+  for ( ; aEvent < end; aEvent += strlen( aEvent ) + 1 )
+  {
+    drm     |= !strcmp( aEvent, "SUBSYSTEM=drm" );
+    hotplug |= !strcmp( aEvent, "HOTPLUG=1" );
+  }
+
+  return drm && hotplug;
+}
+
+
+/*
+ * helper function to probe the connector of each display after a hotplug
+ * event - a disconnected display does not show the frames anymore. A
+ * reconnected display or a display with a new preferred mode gets its mode
+ * with the next frame and, if the size has changed, a new surface. Returns 1
+ * if a display has to be redrawn
+ */
+static int DrmReprobe( void )
+{
+  drmModeConnector* connector;
+  drmModeModeInfo*  mode;
+  XDrmDisplay*      display;
+  int               changed = 0;
+  int               i;
+
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+  {
+    display   = &DrmDisplays[ i ];
+    connector = drmModeGetConnector( DrmFd, display->Connector->connector_id );
+    mode      = connector ? DrmFindMode( connector ) : NULL;
+
+    if ( !mode || ( connector->connection != DRM_MODE_CONNECTED ))
+    {
+      if ( display->Connected )
+        EwPrint( "DrmEgl: Display %d disconnected\n", i );
+
+      display->Connected = 0;
+
+      if ( connector )
+        drmModeFreeConnector( connector );
+      continue;
+    }
+
+    /* nothing has changed for this display */
+    if ( display->Connected && !memcmp( mode, display->Mode, sizeof( drmModeModeInfo )))
+    {
+      drmModeFreeConnector( connector );
+      continue;
+    }
+
+    EwPrint( "DrmEgl: Display %d connected with %u x %u @ %u Hz\n", i, mode->hdisplay,
+      mode->vdisplay, mode->vrefresh );
+
+    /* the page flips of a lost link may never complete - they are given up */
+    while (( display->GbmFlipBuffer || display->GbmQueuedBuffer ) &&
+           DrmWaitForEvent( HOTPLUG_FLIP_TIMEOUT ))
+      ;
+
+    if ( display->GbmQueuedBuffer )
+      gbm_surface_release_buffer( display->GbmSurface, display->GbmQueuedBuffer );
+
+    /* an overlay-only commit flips the current buffer again */
+    if ( display->GbmFlipBuffer && display->GbmBuffer &&
+       ( display->GbmBuffer != display->GbmFlipBuffer ))
+      gbm_surface_release_buffer( display->GbmSurface, display->GbmBuffer );
+
+    /* the events of the given up flips may still arrive - they are ignored */
+    if ( display->GbmFlipBuffer )
+    {
+      display->GbmBuffer = display->GbmFlipBuffer;
+      display->FlipGeneration++;
+    }
+
+    display->GbmFlipBuffer   = NULL;
+    display->GbmQueuedBuffer = NULL;
+
+    /* the mode refers to the connector it was queried with */
+    drmModeFreeConnector( display->Connector );
+    display->Connector = connector;
+    display->Mode      = mode;
+
+    /* the frame duration has to be measured again with the new mode */
+    display->Period       = 0;
+    display->FlipSequence = 0;
+
+    if (( DrmScaleSize( mode->hdisplay, DrmRenderScale ) != display->EglWidth ) ||
+        ( DrmScaleSize( mode->vdisplay, DrmRenderScale ) != display->EglHeight ))
+      DrmEglReplaceSurface( display, DrmScaleSize( mode->hdisplay, DrmRenderScale ),
+        DrmScaleSize( mode->vdisplay, DrmRenderScale ));
+
+    if ( DrmAtomic )
+    {
+      if ( display->ModeBlob )
+        drmModeDestroyPropertyBlob( DrmFd, display->ModeBlob );
+
+      display->ModeBlob = 0;
+      drmModeCreatePropertyBlob( DrmFd, display->Mode, sizeof( drmModeModeInfo ),
+        &display->ModeBlob );
+    }
+
+    display->ModeChanged = 1;
+    display->Connected   = 1;
+    changed              = 1;
+  }
+
+  return changed;
+}
+
+
+/*
+ * helper function to copy the pixel of a boot splash image into a new dumb
+ * buffer - the dumb buffer is CPU accessible and needs neither GBM nor EGL
+ */
+static int DrmCreateSplash( const uint32_t* aPixel, int aWidth, int aHeight )
+{
+  struct drm_mode_create_dumb create;
+  struct drm_mode_map_dumb    map;
+  uint8_t*                    dst = MAP_FAILED;
+  int                         y;
+
+  memset( &create, 0, sizeof( create ));
+  memset( &map,    0, sizeof( map ));
+  create.width  = aWidth;
+  create.height = aHeight;
+  create.bpp    = 32;
+
+  if ( drmIoctl( DrmFd, DRM_IOCTL_MODE_CREATE_DUMB, &create ))
+    return 0;
+
+  SplashHandle = create.handle;
+  map.handle   = create.handle;
+
+  if ( !drmIoctl( DrmFd, DRM_IOCTL_MODE_MAP_DUMB, &map ))
+    dst = mmap( NULL, create.size, PROT_WRITE, MAP_SHARED, DrmFd, map.offset );
+
+  if ( dst != MAP_FAILED )
+  {
+    for ( y = 0; y < aHeight; y++ )
+      memcpy( dst + y * create.pitch, aPixel + y * aWidth, aWidth * 4 );
+
+    munmap( dst, create.size );
+
+    if ( drmModeAddFB( DrmFd, aWidth, aHeight, 24, 32, create.pitch, create.handle, &SplashFb ))
+      SplashFb = 0;
+  }
+
+  /* the dumb buffer is not needed without frame buffer */
+  if ( !SplashFb )
+    DrmReleaseSplash();
+
+  return SplashFb != 0;
+}
+
+
+/*
+ * helper function to blend a pixel of the UI layer with premultiplied alpha
+ * over the opaque background - like the display controller does
+ */
+static uint32_t DrmBlendPixel( uint32_t aUi, uint32_t aBg )
+{
+  uint32_t a = 255 - ( aUi >> 24 );
+
+  return aUi + (((( aBg & 0x00FF00FF ) * a ) >> 8 ) & 0x00FF00FF ) +
+               (((( aBg & 0x0000FF00 ) * a ) >> 8 ) & 0x0000FF00 );
+}
+
+
+/*
+ * helper function to return the file name of the boot splash image - an
+ * empty name disables the boot splash
+ */
+static const char* DrmGetSplashFileName( void )
+{
+  const char* fileName = getenv( "EW_SPLASH_FILE" );
+
+  return fileName ? fileName : EW_SPLASH_FILE;
+}
+
+
+/*
+ * helper function to get the config index for the given visual_id
+ */
+static int match_config_to_visual( EGLDisplay egl_display, EGLint visual_id,
+  EGLConfig* configs, int count )
+{
+  int i;
+
+  for ( i = 0; i < count; ++i )
+  {
+    EGLint id;
+
+    if ( ! eglGetConfigAttrib( egl_display, configs[ i ], EGL_NATIVE_VISUAL_ID, &id ))
+      continue;
+
+    if ( id == visual_id )
+      return i;
+  }
+
+  return -1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemInit
+*
+* DESCRIPTION:
+*   The function GfxSystemInit is responsible to get an access to the
+*   graphics subsystem. In case that the underlying graphics subsystem contains
+*   a window manager, the given size is used to create a suitable window.
+*   Otherwise, the given size is ignored, because the size of the framebuffer
+*   cannot be changed.
+*
+* ARGUMENTS:
+*   aWidth   - Desired width of the GUI application in pixel.
+*   aHeight  - Desired height of the GUI application in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemInit( int aWidth, int aHeight )
+{
+  drmModeRes*       resources;
+  drmModeConnector* connector;
+  drmModeModeInfo*  mode;
+  XDrmDisplay*      display;
+  uint32_t          crtcId;
+  uint32_t          crtcIndex = 0;
+  int               i;
+  char*             drmDevName = NULL;
+
+  if (( drmDevName = getenv( "EW_DRMDEVICE" )) == NULL )
+    drmDevName = DEFAULT_DRM_DEVICE;
+
+  DrmFd = open( drmDevName, O_RDWR );
+  if ( DrmFd < 0 )
+  {
+    EwPrint( "GfxSystemInit: Cannot open '%s'!\n", drmDevName );
+    return 0;
+  }
+
+  /* retrieve resources */
+  resources = drmModeGetResources( DrmFd );
+  if ( !resources )
+    return 0;
+
+  memset( DrmDisplays, 0, sizeof( DrmDisplays ));
+  DrmNoOfDisplays = 0;
+
+  /* iterate all connectors - each connected one is driven by its own CRTC */
+  for ( i = 0; ( i < resources->count_connectors ) && ( DrmNoOfDisplays < MAX_NO_OF_DISPLAYS ); i++ )
+  {
+    /* get information for each connector */
+    connector = drmModeGetConnector( DrmFd, resources->connectors[ i ] );
+    if ( !connector )
+      continue;
+
+    if ( connector->connection != DRM_MODE_CONNECTED )
+    {
+      EwPrint( "GfxSystemInit: DRM connector not connected\n" );
+      drmModeFreeConnector( connector );
+      continue;
+    }
+
+    /* find preferred mode */
+    mode   = DrmFindMode( connector );
+    crtcId = mode ? DrmFindCrtc( resources, connector, &crtcIndex ) : 0;
+
+    if ( !crtcId )
+    {
+      drmModeFreeConnector( connector );
+      continue;
+    }
+
+    /* the index of the CRTC selects the planes, that can be connected to it */
+    display            = &DrmDisplays[ DrmNoOfDisplays++ ];
+    display->Connector = connector;
+    display->Mode      = mode;
+    display->CrtcId    = crtcId;
+    display->CrtcIndex = crtcIndex;
+    display->UiPlane   = &display->PrimaryPlane;
+    display->Connected = 1;
+  }
+
+  drmModeFreeResources( resources );
+
+  /* the connectors are probed again, when the kernel reports a hotplug */
+  HotplugFd = DrmOpenUevents();
+  if ( HotplugFd < 0 )
+    EwPrint( "GfxSystemInit: No uevents - display hotplug not supported\n" );
+
+  if ( EW_USE_ATOMIC_MODESETTING && DrmNoOfDisplays && !DrmAtomicInit())
+    EwPrint( "GfxSystemInit: No atomic modesetting - using the legacy API\n" );
+
+  /*
+  EwPrint( "%u x %u, %u x %u mm, connector_type: %u, connector_type_id: %u\n",
+    DrmDisplays->Mode->hdisplay, DrmDisplays->Mode->vdisplay, DrmDisplays->Connector->mmWidth,
+    DrmDisplays->Connector->mmHeight, DrmDisplays->Connector->connector_type,
+    DrmDisplays->Connector->connector_type_id);
+  */
+
+  return ( DrmNoOfDisplays > 0 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemDone
+*
+* DESCRIPTION:
+*   The function GfxSystemDone is responsible to close the access to the
+*   graphics subsystem.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GfxSystemDone( void )
+{
+  int i;
+
+  /* the dma-bufs, that were not removed by their owner */
+  for ( i = 0; i < MAX_NO_OF_DMABUFS; i++ )
+    if ( DmaBufs[ i ].FbId )
+      drmModeRmFB( DrmFd, DmaBufs[ i ].FbId );
+
+  memset( DmaBufs, 0, sizeof( DmaBufs ));
+
+  /* the application has finished before its first frame */
+  DrmReleaseSplash();
+
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+    drmModeFreeConnector( DrmDisplays[ i ].Connector );
+
+  memset( DrmDisplays, 0, sizeof( DrmDisplays ));
+
+  if ( DrmFd >= 0 )
+    close ( DrmFd );
+
+  if ( HotplugFd >= 0 )
+    close( HotplugFd );
+
+  DrmFd           = -1;
+  HotplugFd       = -1;
+  DrmNoOfDisplays = 0;
+  DrmAtomic       = 0;
+  DrmNoOfOverlays = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemProcess
+*
+* DESCRIPTION:
+*   The function GfxSystemProcess drives the graphics subsystem or window
+*   manager in order to process all pending events.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   1, if further processing is needed, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemProcess( void )
+{
+  struct pollfd p;
+
+  p.fd     = DrmFd;
+  p.events = POLLIN;
+
+  /* dispatch all pending DRM events without blocking */
+  if (( DrmFd >= 0 ) && ( poll( &p, 1, 0 ) > 0 ) && ( p.revents & POLLIN ))
+    drmHandleEvent( DrmFd, &DrmEventContext );
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetEventFd
+*
+* DESCRIPTION:
+*   The function GfxSystemGetEventFd returns the file descriptor of the
+*   graphics subsystem, that becomes readable as soon as an event (e.g. the
+*   completion of a page flip) is pending. The events are dispatched by the
+*   function GfxSystemProcess().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the graphics subsystem is not open.
+*
+*******************************************************************************/
+int GfxSystemGetEventFd( void )
+{
+  return DrmFd;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetHotplugFd
+*
+* DESCRIPTION:
+*   The function GfxSystemGetHotplugFd returns the file descriptor, that
+*   becomes readable as soon as the kernel reports a uevent (e.g. a display
+*   has been connected or disconnected). The uevents are evaluated by the
+*   function DrmEglProcessHotplug().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the uevents are not available.
+*
+*******************************************************************************/
+int GfxSystemGetHotplugFd( void )
+{
+  return HotplugFd;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemShowSplash
+*
+* DESCRIPTION:
+*   The function GfxSystemShowSplash shows the boot splash image on the first
+*   display immediately after GfxSystemInit() - before EGL and the Graphics
+*   Engine are initialized. The image is memory-mapped and copied into a DRM
+*   dumb buffer, which is scanned out until the first frame of the UI is on
+*   the screen. Afterwards the dumb buffer is released.
+*   The image is stored by GfxSystemSaveSplash() during the previous clean
+*   shutdown. Its file name is given by EW_SPLASH_FILE or the environment
+*   variable EW_SPLASH_FILE - an empty name disables the boot splash.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the boot splash is shown, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemShowSplash( void )
+{
+  XDrmDisplay*      display  = DrmDisplays;
+  drmModeModeInfo*  mode     = display->Mode;
+  const char*       fileName = DrmGetSplashFileName();
+  XSplashHeader*    header   = MAP_FAILED;
+  drmModeAtomicReq* request;
+  struct stat       st;
+  uint32_t          width    = 0;
+  uint32_t          height   = 0;
+  int               fd;
+  int               ok;
+
+  if ( !DrmNoOfDisplays || SplashFb || !*fileName )
+    return 0;
+
+  fd = open( fileName, O_RDONLY | O_CLOEXEC );
+  if ( fd < 0 )
+    return 0;
+
+  /* only the pages of the image are read, that are copied to the screen */
+  if ( !fstat( fd, &st ) && ( st.st_size >= (off_t)sizeof( XSplashHeader )))
+    header = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+  close( fd );
+
+  if ( header == MAP_FAILED )
+    return 0;
+
+  width  = header->Width;
+  height = header->Height;
+  ok     = ( header->Magic == SPLASH_MAGIC ) && ( header->Format == GBM_FORMAT_XRGB8888 ) &&
+           width && height && ( width <= MAX_SPLASH_SIZE ) && ( height <= MAX_SPLASH_SIZE ) &&
+           ( st.st_size >= (off_t)sizeof( XSplashHeader ) + (off_t)width * height * 4 );
+
+  /* the legacy API cannot scale an image of a different mode */
+  if ( ok && !DrmAtomic && (( width != mode->hdisplay ) || ( height != mode->vdisplay )))
+    ok = 0;
+
+  ok = ok && DrmCreateSplash((const uint32_t*)( header + 1 ), width, height );
+  munmap( header, st.st_size );
+
+  if ( !ok )
+  {
+    EwPrint( "GfxSystemShowSplash: Cannot show the boot splash '%s'!\n", fileName );
+    return 0;
+  }
+
+  /* the image is shown by the primary plane and scaled to the mode */
+  if ( DrmAtomic )
+  {
+    request = drmModeAtomicAlloc();
+    ok      = request && !drmModeCreatePropertyBlob( DrmFd, mode, sizeof( drmModeModeInfo ),
+                &display->ModeBlob );
+
+    if ( ok )
+    {
+      drmModeAtomicAddProperty( request, display->Connector->connector_id,
+        display->ConnectorCrtcProp, display->CrtcId );
+      drmModeAtomicAddProperty( request, display->CrtcId, display->CrtcModeProp, display->ModeBlob );
+      drmModeAtomicAddProperty( request, display->CrtcId, display->CrtcActiveProp, 1 );
+      DrmAtomicAddPlane( request, display, &display->PrimaryPlane, SplashFb, width, height,
+        0, 0, mode->hdisplay, mode->vdisplay, 0 );
+
+      ok = !drmModeAtomicCommit( DrmFd, request, DRM_MODE_ATOMIC_ALLOW_MODESET, NULL );
+    }
+
+    if ( request )
+      drmModeAtomicFree( request );
+  }
+  else
+    ok = !drmModeSetCrtc( DrmFd, display->CrtcId, SplashFb, 0, 0,
+           &display->Connector->connector_id, 1, mode );
+
+  if ( !ok )
+    DrmReleaseSplash();
+
+  return ok;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemSaveSplash
+*
+* DESCRIPTION:
+*   The function GfxSystemSaveSplash stores the frame currently shown on the
+*   first display as boot splash image for the next start (see the function
+*   GfxSystemShowSplash()). It has to be called on a clean shutdown before
+*   the Embedded Wizard application is deinitialized.
+*   The scanned out buffers are read back - with background layer, the UI is
+*   blended over the background like the display controller does. The image
+*   is written to a temporary file first, thereby an interrupted shutdown
+*   does not corrupt the previous image.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemSaveSplash( void )
+{
+  XDrmDisplay*   display  = DrmDisplays;
+  const char*    fileName = DrmGetSplashFileName();
+  struct gbm_bo* uiBuffer;
+  struct gbm_bo* bgBuffer;
+  XSplashHeader  header;
+  char           tmpName[ 256 ];
+  uint8_t*       ui       = NULL;
+  uint8_t*       bg       = NULL;
+  void*          uiMap    = NULL;
+  void*          bgMap    = NULL;
+  uint32_t       uiStride = 0;
+  uint32_t       bgStride = 0;
+  uint32_t       uiWidth;
+  uint32_t       uiHeight;
+  uint32_t*      row;
+  uint32_t*      src;
+  uint32_t       x, y;
+  FILE*          file;
+  int            ok;
+
+  if ( !DrmNoOfDisplays || !*fileName ||
+       ( snprintf( tmpName, sizeof( tmpName ), "%s.tmp", fileName ) >= (int)sizeof( tmpName )))
+    return 0;
+
+  /* wait until the final frame is on the screen */
+  while ( display->GbmFlipBuffer && DrmWaitForEvent( -1 ))
+    ;
+
+  /* without any frame of the UI, the previous image is kept */
+  uiBuffer = display->GbmBuffer;
+  bgBuffer = GbmBgShownBuffer;
+
+  if ( SplashFb || !uiBuffer || !display->Connected )
+    return 0;
+
+  uiWidth       = gbm_bo_get_width( uiBuffer );
+  uiHeight      = gbm_bo_get_height( uiBuffer );
+  header.Magic  = SPLASH_MAGIC;
+  header.Width  = bgBuffer ? gbm_bo_get_width( bgBuffer )  : uiWidth;
+  header.Height = bgBuffer ? gbm_bo_get_height( bgBuffer ) : uiHeight;
+  header.Format = GBM_FORMAT_XRGB8888;
+
+  ui = gbm_bo_map( uiBuffer, 0, 0, uiWidth, uiHeight, GBM_BO_TRANSFER_READ, &uiStride, &uiMap );
+
+  if ( bgBuffer )
+    bg = gbm_bo_map( bgBuffer, 0, 0, header.Width, header.Height, GBM_BO_TRANSFER_READ,
+           &bgStride, &bgMap );
+
+  row  = malloc( header.Width * 4 );
+  file = ( ui && ( bg || !bgBuffer ) && row ) ? fopen( tmpName, "wb" ) : NULL;
+  ok   = file && ( fwrite( &header, sizeof( header ), 1, file ) == 1 );
+
+  /* the UI may be rendered at reduced resolution - it is scaled to the size
+     of the background */
+  for ( y = 0; ok && ( y < header.Height ); y++ )
+  {
+    src = (uint32_t*)( ui + ( y * uiHeight / header.Height ) * uiStride );
+
+    for ( x = 0; x < header.Width; x++ )
+      row[ x ] = src[ x * uiWidth / header.Width ];
+
+    for ( x = 0; bg && ( x < header.Width ); x++ )
+      row[ x ] = DrmBlendPixel( row[ x ], ((uint32_t*)( bg + y * bgStride ))[ x ] );
+
+    for ( x = 0; x < header.Width; x++ )
+      row[ x ] |= 0xFF000000;
+
+    ok = ( fwrite( row, header.Width * 4, 1, file ) == 1 );
+  }
+
+  /* the previous image is replaced only by a complete one */
+  if ( file )
+  {
+    ok = ok && !fflush( file ) && !fsync( fileno( file ));
+    ok = !fclose( file ) && ok;
+    ok = ok && !rename( tmpName, fileName );
+
+    if ( !ok )
+      unlink( tmpName );
+  }
+
+  if ( ui )
+    gbm_bo_unmap( uiBuffer, uiMap );
+
+  if ( bg )
+    gbm_bo_unmap( bgBuffer, bgMap );
+
+  free( row );
+
+  if ( !ok )
+    EwPrint( "GfxSystemSaveSplash: Cannot save the boot splash '%s'!\n", fileName );
+
+  return ok;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNextVBlank
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNextVBlank estimates the time, when a frame that
+*   is rendered now will appear on the display. The estimation is based on the
+*   timestamp of the recent page flip, the frame duration measured from the
+*   page flips and the number of frames still waiting for their page flip.
+*   With several displays, the first display paces the GUI thread.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the expected presentation time in microseconds (CLOCK_MONOTONIC)
+*   or 0 if no page flip has happened so far.
+*
+*******************************************************************************/
+long long GfxSystemGetNextVBlank( void )
+{
+  XDrmDisplay*    display = DrmDisplays;
+  struct timespec ts;
+  long long       period;
+  long long       now;
+  long long       next;
+
+  if ( !DrmNoOfDisplays || !display->FlipTime )
+    return 0;
+
+  period = DrmGetFramePeriod( display );
+  if ( period <= 0 )
+    return 0;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  now = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+
+  /* the first vblank after now */
+  next = display->FlipTime + period;
+  if ( now >= next )
+    next += (( now - next ) / period + 1 ) * period;
+
+  /* frames waiting for their page flip are shown first */
+  if ( display->GbmFlipBuffer )
+    next += period;
+  if ( display->GbmQueuedBuffer )
+    next += period;
+
+  return next;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetFramePeriod
+*
+* DESCRIPTION:
+*   The function GfxSystemGetFramePeriod returns the duration of one frame of
+*   the first display. The value is measured from the timestamps and vblank
+*   counters of the page flips. Until then, it is derived from the display
+*   mode.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the frame duration in microseconds or 0 if unknown.
+*
+*******************************************************************************/
+long long GfxSystemGetFramePeriod( void )
+{
+  if ( !DrmNoOfDisplays )
+    return 0;
+
+  return DrmGetFramePeriod( DrmDisplays );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNoOfDisplays
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNoOfDisplays returns the number of connected
+*   displays. Each display is driven by its own CRTC and shows its own EGL
+*   surface (see DrmEglGetSurface()).
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the number of displays.
+*
+*******************************************************************************/
+int GfxSystemGetNoOfDisplays( void )
+{
+  return DrmNoOfDisplays;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetDisplaySize
+*
+* DESCRIPTION:
+*   The function GfxSystemGetDisplaySize returns the size of the display mode.
+*   If the UI is rendered at reduced resolution (see DrmEglSetRenderScale()),
+*   the framebuffer is smaller than the display.
+*
+* ARGUMENTS:
+*   aIndex   - Index of the display (0 .. GfxSystemGetNoOfDisplays() - 1).
+*   aWidth   - Pointer to return the width of the display in pixel.
+*   aHeight  - Pointer to return the height of the display in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if there is no such display.
+*
+*******************************************************************************/
+int GfxSystemGetDisplaySize( int aIndex, int* aWidth, int* aHeight )
+{
+  if (( aIndex < 0 ) || ( aIndex >= DrmNoOfDisplays ))
+    return 0;
+
+  if ( aWidth )
+    *aWidth = DrmDisplays[ aIndex ].Mode->hdisplay;
+  if ( aHeight )
+    *aHeight = DrmDisplays[ aIndex ].Mode->vdisplay;
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNoOfOverlays
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNoOfOverlays returns the number of hardware overlay
+*   planes, that can show external frame buffers (e.g. video or camera frames)
+*   below or above the UI plane. Overlays are available only with atomic
+*   modesetting and are shown on the first display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the number of overlays.
+*
+*******************************************************************************/
+int GfxSystemGetNoOfOverlays( void )
+{
+  return DrmAtomic ? DrmNoOfOverlays : 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemAddDmaBuf
+*
+* DESCRIPTION:
+*   The function GfxSystemAddDmaBuf imports the given dma-buf (e.g. a frame of a
+*   video decoder or camera) as DRM frame buffer, that can be shown by an
+*   overlay. The import is done once - the producer should cycle through a
+*   fixed set of imported buffers.
+*   As soon as a buffer is not scanned out anymore, the given release function
+*   is called and the producer may fill the buffer again.
+*
+* ARGUMENTS:
+*   aFd          - File descriptor of the dma-buf.
+*   aFormat      - DRM fourcc format of the buffer (e.g. DRM_FORMAT_NV12).
+*   aWidth       - Width of the buffer in pixel.
+*   aHeight      - Height of the buffer in pixel.
+*   aNoOfPlanes  - Number of color planes of the format (1 .. 4).
+*   aPitches     - Pitch of each color plane in bytes.
+*   aOffsets     - Offset of each color plane within the dma-buf in bytes.
+*   aReleaseProc - Function to call when the buffer is not scanned out anymore
+*     or NULL.
+*   aUserData    - User data passed to the release function.
+*
+* RETURN VALUE:
+*   Returns the handle of the buffer or 0 if the import has failed.
+*
+*******************************************************************************/
+int GfxSystemAddDmaBuf( int aFd, unsigned int aFormat, int aWidth, int aHeight,
+  int aNoOfPlanes, const unsigned int* aPitches, const unsigned int* aOffsets,
+  XDmaBufReleaseProc aReleaseProc, void* aUserData )
+{
+  uint32_t              handles[ 4 ] = { 0 };
+  uint32_t              pitches[ 4 ] = { 0 };
+  uint32_t              offsets[ 4 ] = { 0 };
+  struct drm_gem_close  gemClose;
+  XDmaBuf*              dmaBuf;
+  uint32_t              handle;
+  int                   i;
+
+  if ( !DrmAtomic || ( aNoOfPlanes < 1 ) || ( aNoOfPlanes > 4 ))
+    return 0;
+
+  for ( i = 0; ( i < MAX_NO_OF_DMABUFS ) && DmaBufs[ i ].FbId; i++ )
+    ;
+
+  if ( i == MAX_NO_OF_DMABUFS )
+  {
+    EwPrint( "GfxSystemAddDmaBuf: Too many dma-bufs!\n" );
+    return 0;
+  }
+
+  dmaBuf = &DmaBufs[ i ];
+
+  if ( drmPrimeFDToHandle( DrmFd, aFd, &handle ))
+    return 0;
+
+  /* all color planes are stored within the same dma-buf */
+  for ( i = 0; i < aNoOfPlanes; i++ )
+  {
+    handles[ i ] = handle;
+    pitches[ i ] = aPitches[ i ];
+    offsets[ i ] = aOffsets[ i ];
+  }
+
+  if ( drmModeAddFB2( DrmFd, aWidth, aHeight, aFormat, handles, pitches, offsets,
+       &dmaBuf->FbId, 0 ))
+    dmaBuf->FbId = 0;
+
+  /* the frame buffer keeps its own reference to the buffer */
+  memset( &gemClose, 0, sizeof( gemClose ));
+  gemClose.handle = handle;
+  drmIoctl( DrmFd, DRM_IOCTL_GEM_CLOSE, &gemClose );
+
+  if ( !dmaBuf->FbId )
+    return 0;
+
+  dmaBuf->Width       = aWidth;
+  dmaBuf->Height      = aHeight;
+  dmaBuf->ReleaseProc = aReleaseProc;
+  dmaBuf->UserData    = aUserData;
+
+  return (int)( dmaBuf - DmaBufs ) + 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemRemoveDmaBuf
+*
+* DESCRIPTION:
+*   The function GfxSystemRemoveDmaBuf removes a buffer, that was imported by
+*   GfxSystemAddDmaBuf(). A buffer, that is still used by an overlay, cannot be
+*   removed.
+*
+* ARGUMENTS:
+*   aBuffer - Handle of the buffer.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemRemoveDmaBuf( int aBuffer )
+{
+  XDmaBuf*     dmaBuf = DrmGetDmaBuf( aBuffer );
+  XDrmOverlay* overlay;
+  int          i;
+
+  if ( !dmaBuf )
+    return 0;
+
+  for ( i = 0; i < DrmNoOfOverlays; i++ )
+  {
+    overlay = &DrmOverlays[ i ];
+
+    if (( overlay->Buffer == dmaBuf ) || ( overlay->CommitBuffer == dmaBuf ) ||
+        ( overlay->ShownBuffer == dmaBuf ))
+      return 0;
+  }
+
+  drmModeRmFB( DrmFd, dmaBuf->FbId );
+  memset( dmaBuf, 0, sizeof( XDmaBuf ));
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemShowOverlay
+*
+* DESCRIPTION:
+*   The function GfxSystemShowOverlay shows the given buffer by an overlay at
+*   the given position of the screen. The buffer is scaled to the given size by
+*   the display controller. Overlays below the UI plane are visible only where
+*   the UI is transparent.
+*   The change is committed together with the next frame of the UI in one
+*   atomic commit. If no frame is pending, the change is committed immediately.
+*   The function has to be called from the GUI thread.
+*
+* ARGUMENTS:
+*   aOverlay - Index of the overlay (0 .. GfxSystemGetNoOfOverlays() - 1).
+*   aBuffer  - Handle of the buffer to show or 0 to hide the overlay.
+*   aAbove   - 1 to show the overlay above the UI plane, 0 below.
+*   aX, aY   - Top-left corner of the overlay on the screen in pixel.
+*   aWidth   - Width of the overlay on the screen in pixel.
+*   aHeight  - Height of the overlay on the screen in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if the overlay is not available or the display
+*   controller does not support the format, position or scaling.
+*
+*******************************************************************************/
+int GfxSystemShowOverlay( int aOverlay, int aBuffer, int aAbove, int aX, int aY,
+  int aWidth, int aHeight )
+{
+  XDrmDisplay* display = DrmDisplays;
+  XDmaBuf*     dmaBuf  = DrmGetDmaBuf( aBuffer );
+  XDrmOverlay* overlay;
+  XDrmOverlay  previous;
+
+  if ( !DrmAtomic || !display->GbmBuffer || ( aOverlay < 0 ) || ( aOverlay >= DrmNoOfOverlays ) ||
+       ( aBuffer && !dmaBuf ))
+    return 0;
+
+  overlay  = &DrmOverlays[ aOverlay ];
+  previous = *overlay;
+
+  /* the stacking order of a plane with fixed z-position cannot be changed */
+  if ( dmaBuf && !overlay->Plane.ZPosMutable && overlay->Plane.Props[ PLANE_ZPOS ] &&
+       !display->PrimaryPlane.ZPosMutable && display->PrimaryPlane.Props[ PLANE_ZPOS ] &&
+       ( !aAbove != ( overlay->Plane.ZPosMin < display->PrimaryPlane.ZPosMin )))
+    return 0;
+
+  overlay->Buffer = dmaBuf;
+  overlay->Above  = aAbove;
+  overlay->X      = aX;
+  overlay->Y      = aY;
+  overlay->Width  = aWidth;
+  overlay->Height = aHeight;
+
+  /* let the driver verify the new configuration without applying it */
+  if ( dmaBuf && !DrmAtomicCommit( display, DrmGetFb( display->GbmBuffer ),
+       DRM_MODE_ATOMIC_TEST_ONLY ))
+  {
+    *overlay = previous;
+    return 0;
+  }
+
+  /* a buffer, that is replaced before it was committed, is not needed anymore */
+  if ( previous.Buffer && ( previous.Buffer != dmaBuf ) &&
+     ( previous.Buffer != overlay->CommitBuffer ) && ( previous.Buffer != overlay->ShownBuffer ) &&
+       previous.Buffer->ReleaseProc )
+    previous.Buffer->ReleaseProc((int)( previous.Buffer - DmaBufs ) + 1,
+      previous.Buffer->UserData );
+
+  DrmOverlayChanged = 1;
+
+  /* without pending frames, the overlays are committed with the current UI -
+     otherwise together with the next frame or after the pending flip. The
+     boot splash is replaced by the first frame of the UI only */
+  if ( !display->GbmFlipBuffer && !display->GbmQueuedBuffer && !SplashFb )
+    DrmPageFlip( display, display->GbmBuffer );
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglInit
+*
+* DESCRIPTION:
+*   The function DrmEglInit initializes the display hardware via EGL and
+*   returns the display parameter. All connected displays are initialized -
+*   the returned surface belongs to the first display.
+*
+* ARGUMENTS:
+*   aDisplay - Pointer to return EGL display.
+*   aSurface - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth   - Pointer to return the width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int DrmEglInit( void** aDisplay, void** aSurface, int* aFrameBuffer,
+  int* aWidth, int* aHeight )
+{
+  EGLDisplay        eglDisplay        = 0;
+  EGLConfig         eglConfig         = 0;
+  EGLContext        eglContext        = 0;
+  EGLint            count = 0;
+  EGLint            matched = 0;
+  EGLConfig*        configs;
+  int               config_index      = -1;
+  uint32_t          format            = GBM_FORMAT_XRGB8888;
+  XDrmDisplay*      display;
+  drmModeModeInfo*  mode;
+  uint32_t          fb_id;
+  int               errorCode;
+  int               scale;
+  int               i;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = 0;
+  const EGLint      contextAttribs[]  = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+  const char*       eglClientExtensions;
+  const char*       eglDisplayExtensions;
+  const EGLint      configAttribs[] =
+  {
+    EGL_SURFACE_TYPE,    EGL_WINDOW_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE,        1,
+    EGL_GREEN_SIZE,      1,
+    EGL_BLUE_SIZE,       1,
+    EGL_ALPHA_SIZE,      0,
+    EGL_SAMPLES,         0,
+    EGL_NONE
+  };
+
+  if ( !DrmNoOfDisplays )
+    return 0;
+
+  #ifdef EW_BACKGROUND_CLASS
+    /* the background is shown by the primary plane and the UI by the topmost
+       overlay with transparency - the overlay has to be above the primary */
+    if ( DrmAtomic && DrmNoOfOverlays && DrmOverlays[ DrmNoOfOverlays - 1 ].Plane.Props[ PLANE_ZPOS ] &&
+       ( DrmOverlays[ DrmNoOfOverlays - 1 ].Plane.ZPosMutable ||
+       ( DrmOverlays[ DrmNoOfOverlays - 1 ].Plane.ZPosMin > DrmDisplays->PrimaryPlane.ZPosMin )))
+    {
+      DrmLayerPlane         = DrmOverlays[ --DrmNoOfOverlays ].Plane;
+      DrmDisplays->UiPlane  = &DrmLayerPlane;
+      format                = GBM_FORMAT_ARGB8888;
+    }
+  #endif
+
+  /* access to EGL is done via GBM (graphics buffer management) - all
+     displays share the same device, EGL display and context */
+  GbmDevice = gbm_create_device( DrmFd );
+  if ( !GbmDevice )
+    return 0;
+
+  /* get egl extension */
+  eglClientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+  if ( strstr( eglClientExtensions, "EGL_EXT_platform_base" ))
+    eglGetPlatformDisplayEXT = (void*)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+
+  if ( eglGetPlatformDisplayEXT )
+    eglDisplay = eglGetPlatformDisplayEXT( EGL_PLATFORM_GBM_KHR, GbmDevice, NULL );
+  else
+    eglDisplay = eglGetDisplay((void*)GbmDevice );
+
+  eglInitialize( eglDisplay, 0, 0 );
+  eglBindAPI( EGL_OPENGL_ES_API );
+
+  /* check for the extensions needed to redraw only the damaged areas */
+  eglDisplayExtensions = eglQueryString( eglDisplay, EGL_EXTENSIONS );
+  if ( eglDisplayExtensions )
+  {
+    EglBufferAge = strstr( eglDisplayExtensions, "EGL_EXT_buffer_age" ) ||
+                   strstr( eglDisplayExtensions, "EGL_KHR_partial_update" );
+
+    if ( strstr( eglDisplayExtensions, "EGL_KHR_partial_update" ))
+      EglSetDamageRegion = (void*)eglGetProcAddress( "eglSetDamageRegionKHR" );
+
+    if ( strstr( eglDisplayExtensions, "EGL_KHR_swap_buffers_with_damage" ))
+      EglSwapBuffersWithDamage = (void*)eglGetProcAddress( "eglSwapBuffersWithDamageKHR" );
+    else if ( strstr( eglDisplayExtensions, "EGL_EXT_swap_buffers_with_damage" ))
+      EglSwapBuffersWithDamage = (void*)eglGetProcAddress( "eglSwapBuffersWithDamageEXT" );
+  }
+
+  if (!eglGetConfigs(eglDisplay, NULL, 0, &count) || count < 1) {
+    EwPrint("No EGL configs to choose from.\n");
+    return 0;
+  }
+
+  configs = malloc(count * sizeof *configs);
+  if (!configs)
+    return 0;
+
+  if (!eglChooseConfig(eglDisplay, configAttribs, configs,
+            count, &matched) || !matched) {
+    EwPrint("No EGL configs with appropriate attributes.\n");
+    goto out;
+  }
+
+  config_index = match_config_to_visual(
+    eglDisplay, format, configs, matched);
+
+  if (config_index != -1)
+    eglConfig = configs[config_index];
+
+out:
+  free(configs);
+  if (config_index == -1)
+    return 0;
+
+  eglContext = eglCreateContext( eglDisplay, eglConfig, EGL_NO_CONTEXT, contextAttribs );
+  EglDisplay = eglDisplay;
+  EglConfig  = eglConfig;
+  GbmFormat  = format;
+
+  /* the UI can be rendered at reduced resolution and scaled to the mode by the
+     display controller - this needs the planes of atomic modesetting */
+  scale          = getenv( "EW_RENDER_SCALE" ) ? atoi( getenv( "EW_RENDER_SCALE" )) : EW_RENDER_SCALE;
+  DrmRenderScale = 100;
+
+  if ( DrmAtomic && ( scale >= MIN_RENDER_SCALE ) && ( scale < 100 ))
+    DrmRenderScale = scale;
+
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+  {
+    display = &DrmDisplays[ i ];
+    mode    = display->Mode;
+
+    if ( !DrmEglCreateSurface( display, DrmScaleSize( mode->hdisplay, DrmRenderScale ),
+           DrmScaleSize( mode->vdisplay, DrmRenderScale )))
+      return 0;
+  }
+
+  /* the background layer is drawn by the application into its own surface -
+     it is black until the first frame of the background is shown */
+  if ( DrmDisplays->UiPlane != &DrmDisplays->PrimaryPlane )
+  {
+    mode         = DrmDisplays->Mode;
+    GbmBgSurface = gbm_surface_create( GbmDevice, mode->hdisplay, mode->vdisplay,
+      format, GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING );
+
+    if ( GbmBgSurface )
+      EglBgSurface = eglCreateWindowSurface( eglDisplay, eglConfig, (EGLNativeWindowType)GbmBgSurface, 0 );
+
+    if (( EglBgSurface != EGL_NO_SURFACE ) &&
+          eglMakeCurrent( eglDisplay, EglBgSurface, EglBgSurface, eglContext ))
+    {
+      glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+      glClear( GL_COLOR_BUFFER_BIT );
+      eglSwapBuffers( eglDisplay, EglBgSurface );
+      GbmBgBuffer = gbm_surface_lock_front_buffer( GbmBgSurface );
+    }
+
+    /* without background layer, the UI is shown by the primary plane */
+    if ( !GbmBgBuffer )
+    {
+      EwPrint( "DrmEglInit: Background layer not available!\n" );
+      DrmOverlays[ DrmNoOfOverlays++ ].Plane = DrmLayerPlane;
+      DrmDisplays->UiPlane = &DrmDisplays->PrimaryPlane;
+    }
+  }
+
+  EglContext = eglContext;
+
+  /* prepare the first frame of each display - the areas of the UI without any
+     view are transparent */
+  for ( i = DrmNoOfDisplays - 1; i >= 0; i-- )
+  {
+    display = &DrmDisplays[ i ];
+    eglMakeCurrent( eglDisplay, display->EglSurface, display->EglSurface, eglContext );
+
+    if ( display->UiPlane != &display->PrimaryPlane )
+    {
+      glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+      glClear( GL_COLOR_BUFFER_BIT );
+    }
+
+    glGetIntegerv( GL_FRAMEBUFFER_BINDING, &display->EglFramebuffer );
+
+    eglSwapBuffers( eglDisplay, display->EglSurface );
+    display->GbmBuffer = gbm_surface_lock_front_buffer( display->GbmSurface );
+    if ( !display->GbmBuffer || !DrmGetFb( display->GbmBuffer ))
+      return 0;
+  }
+
+  /* return EGL display and surface of the first display - it remains current */
+  if ( aDisplay )
+    *aDisplay = eglDisplay;
+  if ( aSurface )
+    *aSurface = DrmDisplays->EglSurface;
+
+  /* get the framebuffer and its size in pixel */
+  if ( aFrameBuffer )
+    *aFrameBuffer = DrmDisplays->EglFramebuffer;
+  if ( aWidth )
+    *aWidth = DrmDisplays->EglWidth;
+  if ( aHeight )
+    *aHeight = DrmDisplays->EglHeight;
+
+  /* set the mode of all displays at once - with atomic modesetting, the
+     overlays are disabled as well. While the boot splash is shown, the
+     configuration is verified only */
+  if ( DrmAtomic && !DrmAtomicModeSet( SplashFb ? DRM_MODE_ATOMIC_TEST_ONLY : 0 ))
+  {
+    EwPrint( "DrmEglInit: Atomic modeset failed - using the legacy API%s\n",
+      ( DrmRenderScale < 100 ) ? ", which cannot scale the UI" : "" );
+    DrmAtomic       = 0;
+    DrmNoOfOverlays = 0;
+  }
+
+  /* the legacy API shows the UI only */
+  if ( !DrmAtomic && GbmBgBuffer )
+  {
+    gbm_surface_release_buffer( GbmBgSurface, GbmBgBuffer );
+    GbmBgBuffer          = NULL;
+    DrmDisplays->UiPlane = &DrmDisplays->PrimaryPlane;
+  }
+
+  DrmAtomicCompleted();
+
+  /* the boot splash remains on the screen until the first frame of the UI is
+     ready - each display gets its mode together with its first frame */
+  for ( i = 0; SplashFb && ( i < DrmNoOfDisplays ); i++ )
+    DrmDisplays[ i ].ModeChanged = 1;
+
+  for ( i = 0; !DrmAtomic && !SplashFb && ( i < DrmNoOfDisplays ); i++ )
+  {
+    display   = &DrmDisplays[ i ];
+    fb_id     = DrmGetFb( display->GbmBuffer );
+    errorCode = drmModeSetCrtc( DrmFd, display->CrtcId, fb_id, 0, 0,
+      &display->Connector->connector_id, 1, display->Mode );
+
+    if ( errorCode )
+      return 0;
+  }
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglDone
+*
+* DESCRIPTION:
+*   The function DrmEglDone deinitializes EGL and all displays.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display to deinitialize.
+*   aEglSurface - EGL surface to deinitialize.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglDone( void* aDisplay, void* aSurface )
+{
+  XDrmDisplay* display;
+  int          i;
+
+  /* suppress 'unused parameter' warnings */
+  (void)aSurface;
+
+  /* wait until all scheduled frames are on the screen - the completed flips
+     may still release retired EGL surfaces */
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+    while ( DrmDisplays[ i ].GbmFlipBuffer && DrmWaitForEvent( -1 ))
+      ;
+
+  /* the EGL surfaces refer to the GBM surfaces - destroy them before EGL is
+     terminated and the GBM surfaces are destroyed */
+  eglMakeCurrent( (EGLDisplay)aDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT ) ;
+
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+  {
+    DrmEglReleaseRetired( &DrmDisplays[ i ]);
+
+    if ( DrmDisplays[ i ].EglSurface != EGL_NO_SURFACE )
+      eglDestroySurface( (EGLDisplay)aDisplay, DrmDisplays[ i ].EglSurface );
+  }
+
+  if ( EglBgSurface != EGL_NO_SURFACE )
+    eglDestroySurface( (EGLDisplay)aDisplay, EglBgSurface );
+
+  /* shutdown the EGL / OpenGL ES 2.0 sub-system */
+  eglTerminate( (EGLDisplay)aDisplay );
+
+  /* remove the overlays from the screen before their owners release the
+     buffers */
+  if ( DrmAtomic && DrmNoOfDisplays && DrmDisplays->GbmBuffer )
+  {
+    for ( i = 0; i < DrmNoOfOverlays; i++ )
+      DrmOverlays[ i ].Buffer = NULL;
+
+    if ( DrmAtomicCommit( DrmDisplays, DrmGetFb( DrmDisplays->GbmBuffer ), 0 ))
+      DrmAtomicCompleted();
+  }
+
+  for ( i = 0; i < DrmNoOfDisplays; i++ )
+  {
+    display = &DrmDisplays[ i ];
+
+    if ( display->ModeBlob )
+      drmModeDestroyPropertyBlob( DrmFd, display->ModeBlob );
+
+    /* access to EGL was done via GBM (graphics buffer management) */
+    if ( display->GbmSurface )
+    {
+      if ( display->GbmQueuedBuffer )
+        gbm_surface_release_buffer( display->GbmSurface, display->GbmQueuedBuffer );
+
+      if ( display->GbmBuffer )
+        gbm_surface_release_buffer( display->GbmSurface, display->GbmBuffer );
+
+      gbm_surface_destroy( display->GbmSurface );
+    }
+
+    display->ModeBlob        = 0;
+    display->GbmQueuedBuffer = NULL;
+    display->GbmBuffer       = NULL;
+    display->GbmSurface      = NULL;
+    display->EglSurface      = EGL_NO_SURFACE;
+    display->FlipTime        = 0;
+    display->FlipSequence    = 0;
+    display->Period          = 0;
+    display->UiPlane         = &display->PrimaryPlane;
+  }
+
+  if ( GbmBgSurface )
+  {
+    if ( GbmBgBuffer && ( GbmBgBuffer != GbmBgShownBuffer ))
+      gbm_surface_release_buffer( GbmBgSurface, GbmBgBuffer );
+
+    if ( GbmBgShownBuffer )
+      gbm_surface_release_buffer( GbmBgSurface, GbmBgShownBuffer );
+
+    gbm_surface_destroy( GbmBgSurface );
+  }
+
+  GbmBgSurface      = NULL;
+  GbmBgBuffer       = NULL;
+  GbmBgCommitBuffer = NULL;
+  GbmBgShownBuffer  = NULL;
+  EglBgSurface      = EGL_NO_SURFACE;
+
+  EglBufferAge             = 0;
+  EglSetDamageRegion       = 0;
+  EglSwapBuffersWithDamage = 0;
+  GlDamageActive           = 0;
+  DrmRenderScale           = 100;
+
+  if ( GbmDevice )
+    gbm_device_destroy( GbmDevice );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglGetSurface
+*
+* DESCRIPTION:
+*   The function DrmEglGetSurface returns the EGL surface of the given display.
+*   All surfaces share the EGL display and context returned by DrmEglInit() -
+*   the surface has to be selected by DrmEglMakeCurrent() before drawing on it.
+*   Each display flips its buffers independently of the other displays.
+*
+* ARGUMENTS:
+*   aIndex       - Index of the display (0 .. GfxSystemGetNoOfDisplays() - 1).
+*   aSurface     - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth       - Pointer to return the width of the framebuffer in pixel.
+*   aHeight      - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if there is no such display.
+*
+*******************************************************************************/
+int DrmEglGetSurface( int aIndex, void** aSurface, int* aFrameBuffer,
+  int* aWidth, int* aHeight )
+{
+  XDrmDisplay* display;
+
+  if (( aIndex < 0 ) || ( aIndex >= DrmNoOfDisplays ) ||
+      ( DrmDisplays[ aIndex ].EglSurface == EGL_NO_SURFACE ))
+    return 0;
+
+  display = &DrmDisplays[ aIndex ];
+
+  if ( aSurface )
+    *aSurface = display->EglSurface;
+  if ( aFrameBuffer )
+    *aFrameBuffer = display->EglFramebuffer;
+  if ( aWidth )
+    *aWidth = display->EglWidth;
+  if ( aHeight )
+    *aHeight = display->EglHeight;
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSetRenderScale
+*
+* DESCRIPTION:
+*   The function DrmEglSetRenderScale changes the resolution, the UI of a
+*   display is rendered with. The UI surface is replaced by a surface with the
+*   given scale of the display mode and the display controller scales it up
+*   to the mode. Thereby the fill rate of the GPU drops with the square of the
+*   scale. The previous surface is destroyed as soon as the first frame of the
+*   new surface is on the screen - its content is lost, so the next frame has
+*   to be drawn completely. The scaling needs atomic modesetting.
+*
+* ARGUMENTS:
+*   aDisplay - EGL display.
+*   aSurface - Pointer to the EGL surface of the display. Returns the new EGL
+*     surface, which is selected for the following drawing operations.
+*   aScale   - Render resolution in percent of the display mode (25 .. 100).
+*   aWidth   - Pointer to return the new width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the new height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if the surface has been replaced, 0 if the scale is unchanged or
+*   not supported.
+*
+*******************************************************************************/
+int DrmEglSetRenderScale( void* aDisplay, void** aSurface, int aScale,
+  int* aWidth, int* aHeight )
+{
+  XDrmDisplay* display = DrmGetDisplay((EGLSurface)*aSurface );
+  int          width;
+  int          height;
+
+  /* suppress 'unused parameter' warnings */
+  (void)aDisplay;
+
+  if ( !display || !DrmAtomic )
+    return 0;
+
+  if ( aScale < MIN_RENDER_SCALE )
+    aScale = MIN_RENDER_SCALE;
+  if ( aScale > 100 )
+    aScale = 100;
+
+  width  = DrmScaleSize( display->Mode->hdisplay, aScale );
+  height = DrmScaleSize( display->Mode->vdisplay, aScale );
+
+  if (( width == display->EglWidth ) && ( height == display->EglHeight ))
+    return 0;
+
+  /* the frames of the current surface have to be on the screen before it can
+     be retired */
+  while (( display->GbmFlipBuffer || display->GbmQueuedBuffer ) && DrmWaitForEvent( -1 ))
+    ;
+
+  /* the buffer on the screen remains until the next page flip */
+  if ( !DrmEglReplaceSurface( display, width, height ))
+    return 0;
+
+  *aSurface = display->EglSurface;
+
+  if ( aWidth )
+    *aWidth = display->EglWidth;
+  if ( aHeight )
+    *aHeight = display->EglHeight;
 
-  return -1;
+  return 1;
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   GfxSystemInit
+*   DrmEglProcessHotplug
 *
 * DESCRIPTION:
-*   The function GfxSystemInit is responsible to get an access to the
-*   graphics subsystem. In case that the underlying graphics subsystem contains
-*   a window manager, the given size is used to create a suitable window.
-*   Otherwise, the given size is ignored, because the size of the framebuffer
-*   cannot be changed.
+*   The function DrmEglProcessHotplug evaluates the pending uevents. If the
+*   kernel reports a change of the DRM connectors, the connectors of all
+*   displays are probed again. The frames of a disconnected display are
+*   dropped. A reconnected display or a display with a new preferred mode gets
+*   its mode with the next frame. If the size of the display has changed, its
+*   surface is replaced - the EGL context and thereby all textures and caches
+*   of the Graphics Engine are kept.
 *
 * ARGUMENTS:
-*   aWidth   - Desired width of the GUI application in pixel.
-*   aHeight  - Desired height of the GUI application in pixel.
+*   None
 *
 * RETURN VALUE:
-*   Returns 1 if successful, 0 otherwise.
+*   Returns 1 if a display has been reconnected or has changed its mode. The
+*   surfaces have to be queried again (see DrmEglGetSurface()) and the
+*   displays have to be redrawn entirely. Otherwise 0 is returned.
 *
 *******************************************************************************/
-int GfxSystemInit( int aWidth, int aHeight )
+int DrmEglProcessHotplug( void )
 {
-  drmModeRes*       resources;
-  drmModeConnector* connector;
-  drmModeEncoder*   encoder;
-  uint32_t          drmCrtcId = 0;
-  unsigned int      i;
-  char*             drmDevName = NULL;
+  char    buffer[ 4096 ];
+  ssize_t size;
+  int     hotplug = 0;
 
-  if (( drmDevName = getenv( "EW_DRMDEVICE" )) == NULL )
-    drmDevName = DEFAULT_DRM_DEVICE;
+  if ( HotplugFd < 0 )
+    return 0;
 
-  DrmFd = open( drmDevName, O_RDWR );
-  if ( DrmFd < 0 )
+  /* read all pending uevents - only the hotplug of the DRM devices matters */
+  while (( size = recv( HotplugFd, buffer, sizeof( buffer ) - 1, 0 )) > 0 )
   {
-    EwPrint( "GfxSystemInit: Cannot open '%s'!\n", drmDevName );
-    return 0;
+    buffer[ size ] = 0;
+    hotplug |= DrmIsHotplugEvent( buffer, (int)size );
   }
 
-  /* retrieve resources */
-  resources = drmModeGetResources( DrmFd );
-  if ( !resources )
-    return 0;
+  return hotplug && DrmReprobe();
+}
 
-  /* iterate all connectors and use the first connected one */
-  for ( i = 0; i < resources->count_connectors; i++ )
-  {
-    /* get information for each connector */
-    connector = drmModeGetConnector( DrmFd, resources->connectors[ i ] );
-    if ( !connector )
-      continue;
 
-    if ( connector->connection != DRM_MODE_CONNECTED )
-    {
-      EwPrint( "GfxSystemInit: DRM connector not connected\n" );
-      drmModeFreeConnector( connector );
-      continue;
-    }
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSwapBuffers
+*
+* DESCRIPTION:
+*   The function DrmEglSwapBuffers is called from the completion callback
+*   of the viewport. The function ensures that the screen content is shown by
+*   swapping the EGL buffers.
+*   The page flip is performed asynchronously - up to three buffers are in
+*   flight (scanned out, waiting for the flip and queued for the next flip).
+*   The flip completion is dispatched by GfxSystemProcess(). The function
+*   blocks only if no free buffer is left to render the next frame.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglSwapBuffers( void* aDisplay, void* aSurface )
+{
+  XDrmDisplay* display = DrmGetDisplay((EGLSurface)aSurface );
 
-    /* find preferred mode or the highest resolution mode: */
-    for ( i = 0; i < connector->count_modes; i++ )
-    {
-      drmModeModeInfo*  mode = &connector->modes[ i ];
-      if ( mode->type & DRM_MODE_TYPE_PREFERRED )
-      {
-        DrmMode = mode;
-        break;
-      }
-    }
+  /* perform the swap if there was something drawn on the screen */
+  eglSwapBuffers( (EGLDisplay)aDisplay, (EGLSurface)aSurface );
+  GlDamageActive = 0;
 
-    if ( !DrmMode )
-    {
-      drmModeFreeConnector( connector );
-      continue;
-    }
+  if ( display )
+    DrmPresent( display );
+}
 
-    /* find crtc_id via encoder */
-    for ( i = 0; i < resources->count_encoders; i++ )
-    {
-      encoder = drmModeGetEncoder( DrmFd, resources->encoders[i] );
-      if ( encoder->encoder_id == connector->encoder_id )
-      {
-        drmCrtcId = encoder->crtc_id;
-        break;
-      }
 
-      drmModeFreeEncoder( encoder );
-    }
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSwapBuffersWithDamage
+*
+* DESCRIPTION:
+*   The function DrmEglSwapBuffersWithDamage works like DrmEglSwapBuffers, but
+*   informs the display about the area, that has changed since the previous
+*   frame. If EGL_KHR_swap_buffers_with_damage or its EXT variant is missing,
+*   the entire buffer is swapped.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aX, aY      - Top-left corner of the changed area in pixel.
+*   aWidth      - Width of the changed area in pixel.
+*   aHeight     - Height of the changed area in pixel.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglSwapBuffersWithDamage( void* aDisplay, void* aSurface, int aX,
+  int aY, int aWidth, int aHeight )
+{
+  XDrmDisplay* display = DrmGetDisplay((EGLSurface)aSurface );
+  EGLint       rect[ 4 ];
 
-    if ( connector && DrmMode && drmCrtcId )
-    {
-      DrmConnector   = connector;
-      DrmCrtcId      = drmCrtcId;
-    }
-    else if ( connector )
-    {
-      drmModeFreeConnector( connector );
-    }
+  if ( !EglSwapBuffersWithDamage || !display )
+  {
+    DrmEglSwapBuffers( aDisplay, aSurface );
+    return;
   }
-  drmModeFreeResources( resources );
 
-  /*
-  EwPrint( "%u x %u, %u x %u mm, connector_type: %u, connector_type_id: %u\n",
-    DrmMode->hdisplay, DrmMode->vdisplay, DrmConnector->mmWidth, DrmConnector->mmHeight,
-    DrmConnector->connector_type, DrmConnector->connector_type_id);
-  */
+  DrmEglRect( display, rect, aX, aY, aWidth, aHeight );
+  EglSwapBuffersWithDamage( (EGLDisplay)aDisplay, (EGLSurface)aSurface, rect, 1 );
+  GlDamageActive = 0;
 
-  return ( DrmMode != 0 );
+  DrmPresent( display );
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   GfxSystemDone
+*   DrmEglGetBackgroundSurface
 *
 * DESCRIPTION:
-*   The function GfxSystemDone is responsible to close the access to the
-*   graphics subsystem.
+*   The function DrmEglGetBackgroundSurface returns the EGL surface of the
+*   background layer. The background layer is shown by the primary plane below
+*   the UI, which is shown by an overlay plane with transparency. Thereby the
+*   static background has to be drawn only once and is not affected by the
+*   updates of the UI. The background layer is available, if the application
+*   has a background (EW_BACKGROUND_CLASS) and the display controller supports
+*   atomic modesetting with an overlay plane above the primary plane.
 *
 * ARGUMENTS:
 *   None
 *
 * RETURN VALUE:
-*   None
+*   Returns the EGL surface or NULL if there is no background layer.
 *
 *******************************************************************************/
-void GfxSystemDone( void )
+void* DrmEglGetBackgroundSurface( void )
 {
-  if ( DrmConnector )
-    drmModeFreeConnector( DrmConnector );
-
-  if ( DrmFd )
-    close ( DrmFd );
+  return GbmBgBuffer ? (void*)EglBgSurface : NULL;
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   GfxSystemProcess
+*   DrmEglMakeCurrent
 *
 * DESCRIPTION:
-*   The function GfxSystemProcess drives the graphics subsystem or window
-*   manager in order to process all pending events.
+*   The function DrmEglMakeCurrent selects the EGL surface for the following
+*   drawing operations. The UI surfaces of all displays and the surface of the
+*   background layer share the same EGL context.
 *
 * ARGUMENTS:
-*   None
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface to draw on.
 *
 * RETURN VALUE:
-*   1, if further processing is needed, 0 otherwise.
+*   None
 *
 *******************************************************************************/
-int GfxSystemProcess( void )
+void DrmEglMakeCurrent( void* aDisplay, void* aSurface )
 {
-  return 1;
+  eglMakeCurrent( (EGLDisplay)aDisplay, (EGLSurface)aSurface, (EGLSurface)aSurface,
+    EglContext );
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   DrmEglInit
+*   DrmEglSwapBackground
 *
 * DESCRIPTION:
-*   The function DrmEglInit initializes the display hardware via EGL and
-*   returns the display parameter.
+*   The function DrmEglSwapBackground shows the recently drawn content of the
+*   background layer. The new background is committed together with the next
+*   frame of the UI or immediately, if no frame is pending.
 *
 * ARGUMENTS:
-*   aDisplay - Pointer to return EGL display.
-*   aSurface - Pointer to return EGL surface.
-*   aFrameBuffer - Pointer to return the framebuffer.
-*   aWidth   - Pointer to return the width of the framebuffer in pixel.
-*   aHeight  - Pointer to return the height of the framebuffer in pixel.
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface of the background layer.
 *
 * RETURN VALUE:
-*   Returns 1 if successful, 0 otherwise.
+*   None
 *
 *******************************************************************************/
-int DrmEglInit( void** aDisplay, void** aSurface, int* aFrameBuffer,
-  int* aWidth, int* aHeight )
+void DrmEglSwapBackground( void* aDisplay, void* aSurface )
 {
-  EGLDisplay        eglDisplay        = 0;
-  EGLConfig         eglConfig         = 0;
-  EGLSurface        eglSurface        = 0;
-  EGLContext        eglContext        = 0;
-  EGLint            count = 0;
-  EGLint            matched = 0;
-  EGLConfig*        configs;
-  int               config_index      = -1;
-  uint32_t          fb_id;
-  int               errorCode;
-  PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = 0;
-  const EGLint      contextAttribs[]  = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
-  const char*       eglClientExtensions;
-  const EGLint      configAttribs[] =
-  {
-    EGL_SURFACE_TYPE,    EGL_WINDOW_BIT,
-    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-    EGL_RED_SIZE,        1,
-    EGL_GREEN_SIZE,      1,
-    EGL_BLUE_SIZE,       1,
-    EGL_ALPHA_SIZE,      0,
-    EGL_SAMPLES,         0,
-    EGL_NONE
-  };
-
-  if ( !DrmMode )
-    return 0;
-
-  /* access to EGL is done via GBM (graphics buffer management) */
-  GbmDevice = gbm_create_device( DrmFd );
-  if ( !GbmDevice )
-    return 0;
-
-  GbmSurface = gbm_surface_create( GbmDevice, DrmMode->hdisplay, DrmMode->vdisplay,
-    GBM_FORMAT_XRGB8888, GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING );
-  if ( !GbmSurface )
-    return 0;
+  XDrmDisplay*   display = DrmDisplays;
+  struct gbm_bo* bgBuffer;
 
-  /* get egl extension */
-  eglClientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
-  if ( strstr( eglClientExtensions, "EGL_EXT_platform_base" ))
-    eglGetPlatformDisplayEXT = (void*)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
-
-  if ( eglGetPlatformDisplayEXT )
-    eglDisplay = eglGetPlatformDisplayEXT( EGL_PLATFORM_GBM_KHR, GbmDevice, NULL );
-  else
-    eglDisplay = eglGetDisplay((void*)GbmDevice );
-
-  eglInitialize( eglDisplay, 0, 0 );
-  eglBindAPI( EGL_OPENGL_ES_API );
-
-  if (!eglGetConfigs(eglDisplay, NULL, 0, &count) || count < 1) {
-    EwPrint("No EGL configs to choose from.\n");
-    return 0;
-  }
-
-  configs = malloc(count * sizeof *configs);
-  if (!configs)
-    return 0;
-
-  if (!eglChooseConfig(eglDisplay, configAttribs, configs,
-            count, &matched) || !matched) {
-    EwPrint("No EGL configs with appropriate attributes.\n");
-    goto out;
-  }
-
-  config_index = match_config_to_visual(
-    eglDisplay, GBM_FORMAT_XRGB8888, configs, matched);
+  eglSwapBuffers( (EGLDisplay)aDisplay, (EGLSurface)aSurface );
 
-  if (config_index != -1)
-    eglConfig = configs[config_index];
+  bgBuffer = gbm_surface_lock_front_buffer( GbmBgSurface );
+  if ( !bgBuffer )
+    return;
 
-out:
-  free(configs);
-  if (config_index == -1)
-    return 0;
+  /* a background, that is replaced before it was committed, is not needed */
+  if (( GbmBgBuffer != GbmBgCommitBuffer ) && ( GbmBgBuffer != GbmBgShownBuffer ))
+    gbm_surface_release_buffer( GbmBgSurface, GbmBgBuffer );
 
-  eglSurface = eglCreateWindowSurface( eglDisplay, eglConfig, (EGLNativeWindowType)GbmSurface, 0 );
-  eglContext = eglCreateContext( eglDisplay, eglConfig, EGL_NO_CONTEXT, contextAttribs );
+  GbmBgBuffer       = bgBuffer;
+  DrmOverlayChanged = 1;
 
-  #if EW_PERFORM_FULLSCREEN_UPDATE == 0
-    eglSurfaceAttrib( eglDisplay, eglSurface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED );
-  #else
-    eglSurfaceAttrib( eglDisplay, eglSurface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_DESTROYED );
-  #endif
+  if ( !display->GbmFlipBuffer && !display->GbmQueuedBuffer && display->GbmBuffer && !SplashFb )
+    DrmPageFlip( display, display->GbmBuffer );
 
-  eglMakeCurrent( eglDisplay, eglSurface, eglSurface, eglContext );
+  /* block only if no free buffer is left to draw the background on */
+  while ( !gbm_surface_has_free_buffers( GbmBgSurface ) && display->GbmFlipBuffer &&
+          DrmWaitForEvent( -1 ))
+    ;
+}
 
-  /* return EGL display and surface */
-  if ( aDisplay )
-    *aDisplay = eglDisplay;
-  if ( aSurface )
-    *aSurface = eglSurface;
 
-  /* get the framebuffer and its size in pixel */
-  if ( aFrameBuffer )
-    glGetIntegerv( GL_FRAMEBUFFER_BINDING, aFrameBuffer );
-  if ( aWidth )
-    eglQuerySurface( eglDisplay, eglSurface, EGL_WIDTH, aWidth );
-  if ( aHeight )
-    eglQuerySurface( eglDisplay, eglSurface, EGL_HEIGHT, aHeight );
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglGetBufferAge
+*
+* DESCRIPTION:
+*   The function DrmEglGetBufferAge returns the age of the current back buffer
+*   according to EGL_EXT_buffer_age - the number of frames since its content
+*   was shown on the screen.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   Returns the age of the back buffer, 0 if its content is undefined or -1 if
+*   the buffer age is not supported.
+*
+*******************************************************************************/
+int DrmEglGetBufferAge( void* aDisplay, void* aSurface )
+{
+  EGLint age = 0;
 
-  eglSwapBuffers( eglDisplay, eglSurface );
-  GbmBuffer = gbm_surface_lock_front_buffer( GbmSurface );
-  fb_id = DrmGetFb( GbmBuffer );
-  if ( !fb_id )
-    return 0;
+  if ( !EglBufferAge )
+    return -1;
 
-  /* set mode */
-  errorCode = drmModeSetCrtc( DrmFd, DrmCrtcId, fb_id, 0, 0, &DrmConnector->connector_id, 1, DrmMode );
-  if ( errorCode )
+  if ( !eglQuerySurface( (EGLDisplay)aDisplay, (EGLSurface)aSurface, EGL_BUFFER_AGE_EXT, &age ))
     return 0;
 
-  return 1;
+  return age;
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   DrmEglDone
+*   DrmEglSetDamage
 *
 * DESCRIPTION:
-*   The function DrmEglDone deinitializes EGL.
+*   The function DrmEglSetDamage limits the drawing operations of the current
+*   frame to the given area of the back buffer. The area is passed to EGL via
+*   EGL_KHR_partial_update (if available) and restricts the clearing of the
+*   framebuffer until the next swap. The function has to be called after
+*   DrmEglGetBufferAge() and before the first drawing operation of the frame.
 *
 * ARGUMENTS:
-*   aEglDisplay - EGL display to deinitialize.
-*   aEglSurface - EGL surface to deinitialize.
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aX, aY      - Top-left corner of the area to redraw in pixel.
+*   aWidth      - Width of the area to redraw in pixel.
+*   aHeight     - Height of the area to redraw in pixel.
 *
 * RETURN VALUE:
 *   None
 *
 *******************************************************************************/
-void DrmEglDone( void* aDisplay, void* aSurface )
+void DrmEglSetDamage( void* aDisplay, void* aSurface, int aX, int aY,
+  int aWidth, int aHeight )
 {
-  /* shutdown the EGL / OpenGL ES 2.0 sub-system */
-  eglMakeCurrent( (EGLDisplay)aDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT ) ;
-  eglTerminate( (EGLDisplay)aDisplay );
+  XDrmDisplay* display = DrmGetDisplay((EGLSurface)aSurface );
 
-  /* access to EGL was done via GBM (graphics buffer management) */
-  if ( GbmSurface )
-  {
-    if ( GbmBuffer )
-      gbm_surface_release_buffer( GbmSurface, GbmBuffer );
+  if ( !display )
+    return;
 
-    gbm_surface_destroy( GbmSurface );
-  }
+  DrmEglRect( display, GlDamage, aX, aY, aWidth, aHeight );
+  GlDamageActive = 1;
 
-  if ( GbmDevice )
-    gbm_device_destroy( GbmDevice );
+  if ( EglSetDamageRegion )
+    EglSetDamageRegion( (EGLDisplay)aDisplay, (EGLSurface)aSurface, GlDamage, 1 );
 }
 
 
 /*******************************************************************************
 * FUNCTION:
-*   DrmEglSwapBuffers
+*   __wrap_glClear
 *
 * DESCRIPTION:
-*   The function DrmEglSwapBuffers is called from the completion callback
-*   of the viewport. The function ensures that the screen content is shown by
-*   swapping the EGL buffers.
+*   The function __wrap_glClear replaces all glClear() calls of the Graphics
+*   Engine (see the linker option --wrap=glClear in the Makefile). The OpenGL
+*   adaptation clears the framebuffer at the beginning of every screen update.
+*   While a damage area is set by DrmEglSetDamage(), the clearing is restricted
+*   to this area - the remaining content of the back buffer is still valid.
 *
 * ARGUMENTS:
-*   aEglDisplay - EGL display.
-*   aEglSurface - EGL surface.
+*   aMask - Bitwise OR of the buffers to clear.
 *
 * RETURN VALUE:
 *   None
 *
 *******************************************************************************/
-void DrmEglSwapBuffers( void* aDisplay, void* aSurface )
-{
-  struct gbm_bo*  next_bo;
-  int             waiting_for_flip = 1;
-  int             ret;
-  fd_set          fds;
-  uint32_t        fb_id;
-  drmEventContext evctx =
-  {
-    .version = 2,
-    .page_flip_handler = DrmFbFlipCallback
-  };
+void __real_glClear( GLbitfield aMask );
 
-  /* perform the swap if there was something drawn on the screen */
-  eglSwapBuffers( (EGLDisplay)aDisplay, (EGLSurface)aSurface );
+void __wrap_glClear( GLbitfield aMask )
+{
+  GLint framebuffer = -1;
 
-  next_bo = gbm_surface_lock_front_buffer( GbmSurface );
-  fb_id = DrmGetFb( next_bo );
-  if ( !fb_id )
-    return;
+  /* the collected draw calls belong to the previous content */
+  GpuBatchFlush();
 
-  ret = drmModePageFlip( DrmFd, DrmCrtcId, fb_id,
-      DRM_MODE_PAGE_FLIP_EVENT, &waiting_for_flip );
-  if ( ret )
-    return;
+  if ( GlDamageActive )
+    glGetIntegerv( GL_FRAMEBUFFER_BINDING, &framebuffer );
 
-  while ( waiting_for_flip )
+  /* off-screen buffers are cleared completely */
+  if ( framebuffer != 0 )
   {
-    FD_ZERO( &fds );
-    FD_SET( 0, &fds );
-    FD_SET( DrmFd, &fds );
-
-    ret = select( DrmFd + 1, &fds, NULL, NULL, NULL );
-    if ( ret <= 0 )
-      break;
-    else if ( FD_ISSET( DrmFd, &fds ) )
-      drmHandleEvent( DrmFd, &evctx );
+    __real_glClear( aMask );
+    return;
   }
 
-  /* release last buffer to render on again */
-  if ( GbmBuffer )
-    gbm_surface_release_buffer( GbmSurface, GbmBuffer );
-  GbmBuffer = next_bo;
+  glEnable( GL_SCISSOR_TEST );
+  glScissor( GlDamage[ 0 ], GlDamage[ 1 ], GlDamage[ 2 ], GlDamage[ 3 ]);
+  __real_glClear( aMask );
+  glDisable( GL_SCISSOR_TEST );
 }
 
 
@@ -26,6 +26,14 @@
 *   embedded Linux environment. The display is accessed by using EGL via the
 *   graphics subsystem (e.g. Wayland, DRM, X11 or fbdev).
 *
+*   With atomic modesetting, external frame buffers (dma-bufs of a video
+*   decoder or camera) can be shown by hardware overlay planes below or above
+*   the UI plane. The display controller scales and blends them without any
+*   load of the GPU.
+*
+*   All connected displays are driven by their own CRTC and EGL surface. They
+*   share one EGL context and flip their buffers independently.
+*
 *   Important: This file is intended to be used as a template. Please adapt the
 *   implementation and declarations according your particular hardware.
 *
@@ -103,13 +111,334 @@ void GfxSystemDone( void );
 int GfxSystemProcess( void );
 
 
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetEventFd
+*
+* DESCRIPTION:
+*   The function GfxSystemGetEventFd returns the file descriptor of the
+*   graphics subsystem, that becomes readable as soon as an event (e.g. the
+*   completion of a page flip) is pending. The events are dispatched by the
+*   function GfxSystemProcess().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the graphics subsystem is not open.
+*
+*******************************************************************************/
+int GfxSystemGetEventFd( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetHotplugFd
+*
+* DESCRIPTION:
+*   The function GfxSystemGetHotplugFd returns the file descriptor, that
+*   becomes readable as soon as the kernel reports a uevent (e.g. a display
+*   has been connected or disconnected). The uevents are evaluated by the
+*   function DrmEglProcessHotplug().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the uevents are not available.
+*
+*******************************************************************************/
+int GfxSystemGetHotplugFd( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemShowSplash
+*
+* DESCRIPTION:
+*   The function GfxSystemShowSplash shows the boot splash image on the first
+*   display immediately after GfxSystemInit() - before EGL and the Graphics
+*   Engine are initialized. The image is memory-mapped and copied into a DRM
+*   dumb buffer, which is scanned out until the first frame of the UI is on
+*   the screen. Afterwards the dumb buffer is released.
+*   The image is stored by GfxSystemSaveSplash() during the previous clean
+*   shutdown. Its file name is given by EW_SPLASH_FILE or the environment
+*   variable EW_SPLASH_FILE - an empty name disables the boot splash.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the boot splash is shown, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemShowSplash( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemSaveSplash
+*
+* DESCRIPTION:
+*   The function GfxSystemSaveSplash stores the frame currently shown on the
+*   first display as boot splash image for the next start (see the function
+*   GfxSystemShowSplash()). It has to be called on a clean shutdown before
+*   the Embedded Wizard application is deinitialized.
+*   The scanned out buffers are read back - with background layer, the UI is
+*   blended over the background like the display controller does. The image
+*   is written to a temporary file first, thereby an interrupted shutdown
+*   does not corrupt the previous image.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemSaveSplash( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNextVBlank
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNextVBlank estimates the time, when a frame that
+*   is rendered now will appear on the display. The estimation is based on the
+*   timestamp of the recent page flip, the frame duration measured from the
+*   page flips and the number of frames still waiting for their page flip.
+*   With several displays, the first display paces the GUI thread.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the expected presentation time in microseconds (CLOCK_MONOTONIC)
+*   or 0 if no page flip has happened so far.
+*
+*******************************************************************************/
+long long GfxSystemGetNextVBlank( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetFramePeriod
+*
+* DESCRIPTION:
+*   The function GfxSystemGetFramePeriod returns the duration of one frame of
+*   the first display. The value is measured from the timestamps and vblank
+*   counters of the page flips. Until then, it is derived from the display
+*   mode.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the frame duration in microseconds or 0 if unknown.
+*
+*******************************************************************************/
+long long GfxSystemGetFramePeriod( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNoOfDisplays
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNoOfDisplays returns the number of connected
+*   displays. Each display is driven by its own CRTC and shows its own EGL
+*   surface (see DrmEglGetSurface()).
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the number of displays.
+*
+*******************************************************************************/
+int GfxSystemGetNoOfDisplays( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetDisplaySize
+*
+* DESCRIPTION:
+*   The function GfxSystemGetDisplaySize returns the size of the display mode.
+*   If the UI is rendered at reduced resolution (see DrmEglSetRenderScale()),
+*   the framebuffer is smaller than the display.
+*
+* ARGUMENTS:
+*   aIndex   - Index of the display (0 .. GfxSystemGetNoOfDisplays() - 1).
+*   aWidth   - Pointer to return the width of the display in pixel.
+*   aHeight  - Pointer to return the height of the display in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if there is no such display.
+*
+*******************************************************************************/
+int GfxSystemGetDisplaySize
+(
+  int                         aIndex,
+  int*                        aWidth,
+  int*                        aHeight
+);
+
+
+/*******************************************************************************
+* TYPE:
+*   XDmaBufReleaseProc
+*
+* DESCRIPTION:
+*   The type XDmaBufReleaseProc describes the function, that is called when a
+*   buffer shown by an overlay is not scanned out anymore.
+*
+* ARGUMENTS:
+*   aBuffer   - Handle of the buffer returned by GfxSystemAddDmaBuf().
+*   aUserData - User data passed to GfxSystemAddDmaBuf().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+typedef void (*XDmaBufReleaseProc)
+(
+  int                         aBuffer,
+  void*                       aUserData
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemGetNoOfOverlays
+*
+* DESCRIPTION:
+*   The function GfxSystemGetNoOfOverlays returns the number of hardware overlay
+*   planes, that can show external frame buffers (e.g. video or camera frames)
+*   below or above the UI plane. Overlays are available only with atomic
+*   modesetting and are shown on the first display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the number of overlays.
+*
+*******************************************************************************/
+int GfxSystemGetNoOfOverlays( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemAddDmaBuf
+*
+* DESCRIPTION:
+*   The function GfxSystemAddDmaBuf imports the given dma-buf (e.g. a frame of a
+*   video decoder or camera) as DRM frame buffer, that can be shown by an
+*   overlay. The import is done once - the producer should cycle through a
+*   fixed set of imported buffers.
+*   As soon as a buffer is not scanned out anymore, the given release function
+*   is called and the producer may fill the buffer again.
+*
+* ARGUMENTS:
+*   aFd          - File descriptor of the dma-buf.
+*   aFormat      - DRM fourcc format of the buffer (e.g. DRM_FORMAT_NV12).
+*   aWidth       - Width of the buffer in pixel.
+*   aHeight      - Height of the buffer in pixel.
+*   aNoOfPlanes  - Number of color planes of the format (1 .. 4).
+*   aPitches     - Pitch of each color plane in bytes.
+*   aOffsets     - Offset of each color plane within the dma-buf in bytes.
+*   aReleaseProc - Function to call when the buffer is not scanned out anymore
+*     or NULL.
+*   aUserData    - User data passed to the release function.
+*
+* RETURN VALUE:
+*   Returns the handle of the buffer or 0 if the import has failed.
+*
+*******************************************************************************/
+int GfxSystemAddDmaBuf
+(
+  int                         aFd,
+  unsigned int                aFormat,
+  int                         aWidth,
+  int                         aHeight,
+  int                         aNoOfPlanes,
+  const unsigned int*         aPitches,
+  const unsigned int*         aOffsets,
+  XDmaBufReleaseProc          aReleaseProc,
+  void*                       aUserData
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemRemoveDmaBuf
+*
+* DESCRIPTION:
+*   The function GfxSystemRemoveDmaBuf removes a buffer, that was imported by
+*   GfxSystemAddDmaBuf(). A buffer, that is still used by an overlay, cannot be
+*   removed.
+*
+* ARGUMENTS:
+*   aBuffer - Handle of the buffer.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int GfxSystemRemoveDmaBuf
+(
+  int                         aBuffer
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GfxSystemShowOverlay
+*
+* DESCRIPTION:
+*   The function GfxSystemShowOverlay shows the given buffer by an overlay at
+*   the given position of the screen. The buffer is scaled to the given size by
+*   the display controller. Overlays below the UI plane are visible only where
+*   the UI is transparent.
+*   The change is committed together with the next frame of the UI in one
+*   atomic commit. If no frame is pending, the change is committed immediately.
+*   The function has to be called from the GUI thread.
+*
+* ARGUMENTS:
+*   aOverlay - Index of the overlay (0 .. GfxSystemGetNoOfOverlays() - 1).
+*   aBuffer  - Handle of the buffer to show or 0 to hide the overlay.
+*   aAbove   - 1 to show the overlay above the UI plane, 0 below.
+*   aX, aY   - Top-left corner of the overlay on the screen in pixel.
+*   aWidth   - Width of the overlay on the screen in pixel.
+*   aHeight  - Height of the overlay on the screen in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if the overlay is not available or the display
+*   controller does not support the format, position or scaling.
+*
+*******************************************************************************/
+int GfxSystemShowOverlay
+(
+  int                         aOverlay,
+  int                         aBuffer,
+  int                         aAbove,
+  int                         aX,
+  int                         aY,
+  int                         aWidth,
+  int                         aHeight
+);
+
+
 /*******************************************************************************
 * FUNCTION:
 *   DrmEglInit
 *
 * DESCRIPTION:
 *   The function DrmEglInit initializes the display hardware via EGL and
-*   returns the display parameter.
+*   returns the display parameter. All connected displays are initialized -
+*   the returned surface belongs to the first display.
 *
 * ARGUMENTS:
 *   aDisplay - Pointer to return EGL display.
@@ -137,7 +466,7 @@ int DrmEglInit
 *   DrmEglDone
 *
 * DESCRIPTION:
-*   The function DrmEglDone deinitializes EGL.
+*   The function DrmEglDone deinitializes EGL and all displays.
 *
 * ARGUMENTS:
 *   aEglDisplay - EGL display to deinitialize.
@@ -154,6 +483,98 @@ void DrmEglDone
 );
 
 
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglGetSurface
+*
+* DESCRIPTION:
+*   The function DrmEglGetSurface returns the EGL surface of the given display.
+*   All surfaces share the EGL display and context returned by DrmEglInit() -
+*   the surface has to be selected by DrmEglMakeCurrent() before drawing on it.
+*   Each display flips its buffers independently of the other displays.
+*
+* ARGUMENTS:
+*   aIndex       - Index of the display (0 .. GfxSystemGetNoOfDisplays() - 1).
+*   aSurface     - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth       - Pointer to return the width of the framebuffer in pixel.
+*   aHeight      - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 if there is no such display.
+*
+*******************************************************************************/
+int DrmEglGetSurface
+(
+  int                         aIndex,
+  void**                      aSurface,
+  int*                        aFrameBuffer,
+  int*                        aWidth,
+  int*                        aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSetRenderScale
+*
+* DESCRIPTION:
+*   The function DrmEglSetRenderScale changes the resolution, the UI of a
+*   display is rendered with. The UI surface is replaced by a surface with the
+*   given scale of the display mode and the display controller scales it up
+*   to the mode. Thereby the fill rate of the GPU drops with the square of the
+*   scale. The previous surface is destroyed as soon as the first frame of the
+*   new surface is on the screen - its content is lost, so the next frame has
+*   to be drawn completely. The scaling needs atomic modesetting.
+*
+* ARGUMENTS:
+*   aDisplay - EGL display.
+*   aSurface - Pointer to the EGL surface of the display. Returns the new EGL
+*     surface, which is selected for the following drawing operations.
+*   aScale   - Render resolution in percent of the display mode (25 .. 100).
+*   aWidth   - Pointer to return the new width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the new height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if the surface has been replaced, 0 if the scale is unchanged or
+*   not supported.
+*
+*******************************************************************************/
+int DrmEglSetRenderScale
+(
+  void*                       aDisplay,
+  void**                      aSurface,
+  int                         aScale,
+  int*                        aWidth,
+  int*                        aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglProcessHotplug
+*
+* DESCRIPTION:
+*   The function DrmEglProcessHotplug evaluates the pending uevents. If the
+*   kernel reports a change of the DRM connectors, the connectors of all
+*   displays are probed again. The frames of a disconnected display are
+*   dropped. A reconnected display or a display with a new preferred mode gets
+*   its mode with the next frame. If the size of the display has changed, its
+*   surface is replaced - the EGL context and thereby all textures and caches
+*   of the Graphics Engine are kept.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if a display has been reconnected or has changed its mode. The
+*   surfaces have to be queried again (see DrmEglGetSurface()) and the
+*   displays have to be redrawn entirely. Otherwise 0 is returned.
+*
+*******************************************************************************/
+int DrmEglProcessHotplug( void );
+
+
 /*******************************************************************************
 * FUNCTION:
 *   DrmEglSwapBuffers
@@ -162,6 +583,10 @@ void DrmEglDone
 *   The function DrmEglSwapBuffers is called from the completion callback
 *   of the viewport. The function ensures that the screen content is shown by
 *   swapping the EGL buffers.
+*   The page flip is performed asynchronously - up to three buffers are in
+*   flight (scanned out, waiting for the flip and queued for the next flip).
+*   The flip completion is dispatched by GfxSystemProcess(). The function
+*   blocks only if no free buffer is left to render the next frame.
 *
 * ARGUMENTS:
 *   aEglDisplay - EGL display.
@@ -178,6 +603,167 @@ void DrmEglSwapBuffers
 );
 
 
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSwapBuffersWithDamage
+*
+* DESCRIPTION:
+*   The function DrmEglSwapBuffersWithDamage works like DrmEglSwapBuffers, but
+*   informs the display about the area, that has changed since the previous
+*   frame. If EGL_KHR_swap_buffers_with_damage or its EXT variant is missing,
+*   the entire buffer is swapped.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aX, aY      - Top-left corner of the changed area in pixel.
+*   aWidth      - Width of the changed area in pixel.
+*   aHeight     - Height of the changed area in pixel.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglSwapBuffersWithDamage
+(
+  void*                       aDisplay,
+  void*                       aSurface,
+  int                         aX,
+  int                         aY,
+  int                         aWidth,
+  int                         aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglGetBackgroundSurface
+*
+* DESCRIPTION:
+*   The function DrmEglGetBackgroundSurface returns the EGL surface of the
+*   background layer. The background layer is shown by the primary plane below
+*   the UI, which is shown by an overlay plane with transparency. Thereby the
+*   static background has to be drawn only once and is not affected by the
+*   updates of the UI. The background layer is available, if the application
+*   has a background (EW_BACKGROUND_CLASS) and the display controller supports
+*   atomic modesetting with an overlay plane above the primary plane.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the EGL surface or NULL if there is no background layer.
+*
+*******************************************************************************/
+void* DrmEglGetBackgroundSurface( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglMakeCurrent
+*
+* DESCRIPTION:
+*   The function DrmEglMakeCurrent selects the EGL surface for the following
+*   drawing operations. The UI surface and the surface of the background layer
+*   share the same EGL context.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface to draw on.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglMakeCurrent
+(
+  void*                       aDisplay,
+  void*                       aSurface
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSwapBackground
+*
+* DESCRIPTION:
+*   The function DrmEglSwapBackground shows the recently drawn content of the
+*   background layer. The new background is committed together with the next
+*   frame of the UI or immediately, if no frame is pending.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface of the background layer.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglSwapBackground
+(
+  void*                       aDisplay,
+  void*                       aSurface
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglGetBufferAge
+*
+* DESCRIPTION:
+*   The function DrmEglGetBufferAge returns the age of the current back buffer
+*   according to EGL_EXT_buffer_age - the number of frames since its content
+*   was shown on the screen.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   Returns the age of the back buffer, 0 if its content is undefined or -1 if
+*   the buffer age is not supported.
+*
+*******************************************************************************/
+int DrmEglGetBufferAge
+(
+  void*                       aDisplay,
+  void*                       aSurface
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   DrmEglSetDamage
+*
+* DESCRIPTION:
+*   The function DrmEglSetDamage limits the drawing operations of the current
+*   frame to the given area of the back buffer. The area is passed to EGL via
+*   EGL_KHR_partial_update (if available) and restricts the clearing of the
+*   framebuffer until the next swap. The function has to be called after
+*   DrmEglGetBufferAge() and before the first drawing operation of the frame.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aX, aY      - Top-left corner of the area to redraw in pixel.
+*   aWidth      - Width of the area to redraw in pixel.
+*   aHeight     - Height of the area to redraw in pixel.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void DrmEglSetDamage
+(
+  void*                       aDisplay,
+  void*                       aSurface,
+  int                         aX,
+  int                         aY,
+  int                         aWidth,
+  int                         aHeight
+);
+
+
 #ifdef __cplusplus
   }
 #endif
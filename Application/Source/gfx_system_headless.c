@@ -0,0 +1,582 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the graphics subsystem.
+*
+*   This template implements a headless graphics subsystem - the GUI is drawn
+*   into an off-screen EGL surface without any display. It allows to run,
+*   profile and test the GUI application on any Linux system with an EGL
+*   implementation (e.g. on a build server using Mesa llvmpipe).
+*
+*   The headless mode is selected at runtime by the environment variable
+*   EW_HEADLESS. Further environment variables control the headless mode:
+*
+*   EW_HEADLESS_FPS      - Simulated refresh rate of the display in frames per
+*     second. If not set or 0, the frames are rendered unthrottled.
+*   EW_HEADLESS_FRAMES   - Number of frames after which the application is
+*     terminated. If not set or 0, the number of frames is not limited.
+*   EW_HEADLESS_DURATION - Time in milliseconds after which the application is
+*     terminated. If not set or 0, the running time is not limited.
+*   EW_HEADLESS_SNAPSHOT - Path of a PPM file to store the content of the last
+*     frame when the application is terminated.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <GLES2/gl2.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <sys/timerfd.h>
+
+#include "ewrte.h"
+#include "boot_trace.h"
+#include "gfx_system_headless.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+static int                 Width;
+static int                 Height;
+static int64_t             FramePeriod;      /* simulated refresh period in ns */
+static int64_t             NextVBlank;       /* time of the next simulated vblank */
+static int64_t             StartTime;
+static unsigned int        NoOfFrames;
+static unsigned int        MaxNoOfFrames;
+static int                 TimerFd = -1;     /* expires after the running time */
+static int                 Expired;
+static EGLContext          EglContext = EGL_NO_CONTEXT;
+static GLuint              GlFramebuffer;    /* used without pbuffer surface */
+static GLuint              GlTexture;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the current time in nanoseconds
+ */
+static int64_t GetTime( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+
+/*
+ * helper function to read a numeric environment variable
+ */
+static unsigned int GetEnvValue( const char* aName )
+{
+  const char* value = getenv( aName );
+
+  return value ? (unsigned int)strtoul( value, NULL, 10 ) : 0;
+}
+
+
+/*
+ * helper function to wait for the next simulated vblank
+ */
+static void WaitForVBlank( void )
+{
+  struct timespec ts;
+  int64_t         now = GetTime();
+
+  /* a missed vblank is skipped like on a real display */
+  if ( now > NextVBlank )
+    NextVBlank += (( now - NextVBlank ) / FramePeriod + 1 ) * FramePeriod;
+
+  ts.tv_sec  = NextVBlank / NSEC_PER_SEC;
+  ts.tv_nsec = NextVBlank % NSEC_PER_SEC;
+
+  while ( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ))
+    ;
+
+  NextVBlank += FramePeriod;
+}
+
+
+/*
+ * helper function to store the content of the framebuffer as PPM file
+ */
+static void StoreSnapshot( const char* aFileName )
+{
+  unsigned char* pixel = malloc( Width * Height * 4 );
+  FILE*          file  = fopen( aFileName, "wb" );
+  int            x, y;
+
+  if ( pixel && file )
+  {
+    glBindFramebuffer( GL_FRAMEBUFFER, GlFramebuffer );
+    glReadPixels( 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, pixel );
+
+    /* the rows of OpenGL are ordered from bottom to top */
+    fprintf( file, "P6\n%d %d\n255\n", Width, Height );
+
+    for ( y = Height - 1; y >= 0; y-- )
+      for ( x = 0; x < Width; x++ )
+        fwrite( pixel + ( y * Width + x ) * 4, 1, 3, file );
+  }
+  else
+    EwPrint( "HeadlessEglDone: Cannot store snapshot '%s'!\n", aFileName );
+
+  if ( file )
+    fclose( file );
+
+  free( pixel );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemIsEnabled
+*
+* DESCRIPTION:
+*   The function HeadlessSystemIsEnabled determines whether the headless
+*   graphics subsystem shall be used instead of the display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the environment variable EW_HEADLESS is set, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemIsEnabled( void )
+{
+  return getenv( "EW_HEADLESS" ) != NULL;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemInit
+*
+* DESCRIPTION:
+*   The function HeadlessSystemInit prepares the headless graphics subsystem.
+*   The given size is used for the off-screen surface.
+*
+* ARGUMENTS:
+*   aWidth   - Desired width of the GUI application in pixel.
+*   aHeight  - Desired height of the GUI application in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemInit( int aWidth, int aHeight )
+{
+  struct itimerspec timer;
+  unsigned int      fps      = GetEnvValue( "EW_HEADLESS_FPS" );
+  unsigned int      duration = GetEnvValue( "EW_HEADLESS_DURATION" );
+
+  Width         = aWidth;
+  Height        = aHeight;
+  FramePeriod   = fps ? NSEC_PER_SEC / fps : 0;
+  MaxNoOfFrames = GetEnvValue( "EW_HEADLESS_FRAMES" );
+  NoOfFrames    = 0;
+  Expired       = 0;
+  StartTime     = GetTime();
+
+  /* the running time is limited by a timer, which resumes the GUI thread */
+  if ( duration )
+  {
+    TimerFd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+    if ( TimerFd < 0 )
+      return 0;
+
+    memset( &timer, 0, sizeof( timer ));
+    timer.it_value.tv_sec  = duration / 1000;
+    timer.it_value.tv_nsec = ( duration % 1000 ) * 1000000;
+    timerfd_settime( TimerFd, 0, &timer, NULL );
+  }
+
+  EwPrint( "HeadlessSystemInit: %d x %d, %u fps (0 = unthrottled)\n", Width, Height, fps );
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemDone
+*
+* DESCRIPTION:
+*   The function HeadlessSystemDone closes the headless graphics subsystem and
+*   prints the frame statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessSystemDone( void )
+{
+  unsigned int time = (unsigned int)(( GetTime() - StartTime ) / 1000 );
+
+  EwPrint( "HeadlessSystemDone: %u frames in %u ms", NoOfFrames, time / 1000 );
+
+  if ( NoOfFrames )
+    EwPrint( " (%u us per frame)", time / NoOfFrames );
+
+  EwPrint( "\n" );
+
+  if ( TimerFd >= 0 )
+    close( TimerFd );
+
+  TimerFd = -1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemProcess
+*
+* DESCRIPTION:
+*   The function HeadlessSystemProcess checks whether the frame or time limit
+*   of the headless run is reached.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   1, if further processing is needed, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemProcess( void )
+{
+  uint64_t value;
+
+  if (( TimerFd >= 0 ) && ( read( TimerFd, &value, sizeof( value )) == sizeof( value )))
+    Expired = 1;
+
+  if ( MaxNoOfFrames && ( NoOfFrames >= MaxNoOfFrames ))
+    Expired = 1;
+
+  return !Expired;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetEventFd
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetEventFd returns the file descriptor, that
+*   becomes readable as soon as the time limit of the headless run expires.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the running time is not limited.
+*
+*******************************************************************************/
+int HeadlessSystemGetEventFd( void )
+{
+  return TimerFd;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetNextVBlank
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetNextVBlank returns the time of the next
+*   simulated vertical blank, when a frame rendered now would be presented.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the expected presentation time in microseconds (CLOCK_MONOTONIC)
+*   or 0 if the frames are rendered unthrottled.
+*
+*******************************************************************************/
+long long HeadlessSystemGetNextVBlank( void )
+{
+  int64_t now  = GetTime();
+  int64_t next = NextVBlank;
+
+  if ( !FramePeriod )
+    return 0;
+
+  if ( now > next )
+    next += (( now - next ) / FramePeriod + 1 ) * FramePeriod;
+
+  return next / 1000;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetFramePeriod
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetFramePeriod returns the duration of one
+*   simulated frame.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the frame duration in microseconds or 0 if the frames are rendered
+*   unthrottled.
+*
+*******************************************************************************/
+long long HeadlessSystemGetFramePeriod( void )
+{
+  return FramePeriod / 1000;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglInit
+*
+* DESCRIPTION:
+*   The function HeadlessEglInit initializes EGL with an off-screen surface and
+*   returns the display parameter. A pbuffer surface is used if available,
+*   otherwise a surfaceless context draws into a framebuffer object.
+*
+* ARGUMENTS:
+*   aDisplay - Pointer to return EGL display.
+*   aSurface - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth   - Pointer to return the width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessEglInit( void** aDisplay, void** aSurface, int* aFrameBuffer,
+  int* aWidth, int* aHeight )
+{
+  EGLDisplay        eglDisplay        = EGL_NO_DISPLAY;
+  EGLConfig         eglConfig         = 0;
+  EGLSurface        eglSurface        = EGL_NO_SURFACE;
+  EGLint            count             = 0;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = 0;
+  const EGLint      contextAttribs[]  = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+  const EGLint      surfaceAttribs[]  = { EGL_WIDTH, Width, EGL_HEIGHT, Height, EGL_NONE };
+  const char*       eglClientExtensions;
+  const char*       eglDisplayExtensions;
+  EGLint            configAttribs[] =
+  {
+    EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE,        8,
+    EGL_GREEN_SIZE,      8,
+    EGL_BLUE_SIZE,       8,
+    EGL_NONE
+  };
+
+  /* prefer the surfaceless platform - it works without any display server */
+  eglClientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+  if ( eglClientExtensions && strstr( eglClientExtensions, "EGL_EXT_platform_base" ))
+    eglGetPlatformDisplayEXT = (void*)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+
+  if ( eglGetPlatformDisplayEXT && strstr( eglClientExtensions, "EGL_MESA_platform_surfaceless" ))
+    eglDisplay = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+
+  if ( eglDisplay == EGL_NO_DISPLAY )
+    eglDisplay = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+
+  if ( !eglInitialize( eglDisplay, 0, 0 ))
+  {
+    EwPrint( "HeadlessEglInit: Cannot initialize EGL!\n" );
+    return 0;
+  }
+
+  eglBindAPI( EGL_OPENGL_ES_API );
+
+  /* try to draw into a pbuffer surface */
+  if ( eglChooseConfig( eglDisplay, configAttribs, &eglConfig, 1, &count ) && count )
+    eglSurface = eglCreatePbufferSurface( eglDisplay, eglConfig, surfaceAttribs );
+
+  /* otherwise a context without any surface is needed */
+  if ( eglSurface == EGL_NO_SURFACE )
+  {
+    eglDisplayExtensions = eglQueryString( eglDisplay, EGL_EXTENSIONS );
+    configAttribs[ 1 ]   = 0;
+
+    if ( !eglDisplayExtensions || !strstr( eglDisplayExtensions, "EGL_KHR_surfaceless_context" ) ||
+         !eglChooseConfig( eglDisplay, configAttribs, &eglConfig, 1, &count ) || !count )
+    {
+      EwPrint( "HeadlessEglInit: Neither pbuffer nor surfaceless context available!\n" );
+      eglTerminate( eglDisplay );
+      return 0;
+    }
+  }
+
+  EglContext = eglCreateContext( eglDisplay, eglConfig, EGL_NO_CONTEXT, contextAttribs );
+
+  if (( EglContext == EGL_NO_CONTEXT ) ||
+      !eglMakeCurrent( eglDisplay, eglSurface, eglSurface, EglContext ))
+  {
+    EwPrint( "HeadlessEglInit: Cannot create OpenGL ES 2.0 context!\n" );
+    HeadlessEglDone( eglDisplay, eglSurface );
+    return 0;
+  }
+
+  /* without surface, the GUI is drawn into a texture via framebuffer object */
+  if ( eglSurface == EGL_NO_SURFACE )
+  {
+    glGenTextures( 1, &GlTexture );
+    glBindTexture( GL_TEXTURE_2D, GlTexture );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    glGenFramebuffers( 1, &GlFramebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER, GlFramebuffer );
+    glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, GlTexture, 0 );
+
+    if ( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
+    {
+      EwPrint( "HeadlessEglInit: Cannot create framebuffer object!\n" );
+      HeadlessEglDone( eglDisplay, eglSurface );
+      return 0;
+    }
+  }
+
+  /* return EGL display and surface */
+  if ( aDisplay )
+    *aDisplay = eglDisplay;
+  if ( aSurface )
+    *aSurface = eglSurface;
+
+  /* return the framebuffer and its size in pixel */
+  if ( aFrameBuffer )
+    *aFrameBuffer = GlFramebuffer;
+  if ( aWidth )
+    *aWidth = Width;
+  if ( aHeight )
+    *aHeight = Height;
+
+  EwPrint( "HeadlessEglInit: %s - %s\n", glGetString( GL_RENDERER ),
+    ( eglSurface == EGL_NO_SURFACE ) ? "surfaceless" : "pbuffer" );
+
+  /* the frame statistic starts with the first frame */
+  StartTime  = GetTime();
+  NextVBlank = StartTime + FramePeriod;
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglDone
+*
+* DESCRIPTION:
+*   The function HeadlessEglDone stores the last frame (if requested) and
+*   deinitializes EGL.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display to deinitialize.
+*   aEglSurface - EGL surface to deinitialize.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessEglDone( void* aDisplay, void* aSurface )
+{
+  const char* snapshot = getenv( "EW_HEADLESS_SNAPSHOT" );
+
+  if ( EglContext != EGL_NO_CONTEXT )
+  {
+    if ( snapshot && NoOfFrames )
+      StoreSnapshot( snapshot );
+
+    if ( GlFramebuffer )
+      glDeleteFramebuffers( 1, &GlFramebuffer );
+
+    if ( GlTexture )
+      glDeleteTextures( 1, &GlTexture );
+
+    eglMakeCurrent( (EGLDisplay)aDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+    eglDestroyContext( (EGLDisplay)aDisplay, EglContext );
+  }
+
+  if ( (EGLSurface)aSurface != EGL_NO_SURFACE )
+    eglDestroySurface( (EGLDisplay)aDisplay, (EGLSurface)aSurface );
+
+  eglTerminate( (EGLDisplay)aDisplay );
+
+  EglContext    = EGL_NO_CONTEXT;
+  GlFramebuffer = 0;
+  GlTexture     = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglSwapBuffers
+*
+* DESCRIPTION:
+*   The function HeadlessEglSwapBuffers completes the current frame. The
+*   function waits until the GPU has finished the frame and, if a refresh rate
+*   is simulated, until the next simulated vertical blank.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessEglSwapBuffers( void* aDisplay, void* aSurface )
+{
+  /* swapping a pbuffer has no effect - wait for the GPU instead, so the
+     measured frame time includes the rendering */
+  if ( (EGLSurface)aSurface != EGL_NO_SURFACE )
+    eglSwapBuffers( (EGLDisplay)aDisplay, (EGLSurface)aSurface );
+
+  glFinish();
+  NoOfFrames++;
+
+  if ( FramePeriod )
+    WaitForVBlank();
+
+  /* the first frame is considered to be shown with the simulated vblank */
+  if ( NoOfFrames == 1 )
+    BootTraceFirstFlip( GetTime() / 1000 );
+}
+
+
+/* msy */
@@ -0,0 +1,274 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the graphics subsystem.
+*
+*   This template implements a headless graphics subsystem - the GUI is drawn
+*   into an off-screen EGL surface without any display. It allows to run,
+*   profile and test the GUI application on any Linux system with an EGL
+*   implementation (e.g. on a build server using Mesa llvmpipe).
+*
+*   The headless mode is selected at runtime by the environment variable
+*   EW_HEADLESS. Further environment variables control the headless mode:
+*
+*   EW_HEADLESS_FPS      - Simulated refresh rate of the display in frames per
+*     second. If not set or 0, the frames are rendered unthrottled.
+*   EW_HEADLESS_FRAMES   - Number of frames after which the application is
+*     terminated. If not set or 0, the number of frames is not limited.
+*   EW_HEADLESS_DURATION - Time in milliseconds after which the application is
+*     terminated. If not set or 0, the running time is not limited.
+*   EW_HEADLESS_SNAPSHOT - Path of a PPM file to store the content of the last
+*     frame when the application is terminated.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef GFX_SYSTEM_HEADLESS_H
+#define GFX_SYSTEM_HEADLESS_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemIsEnabled
+*
+* DESCRIPTION:
+*   The function HeadlessSystemIsEnabled determines whether the headless
+*   graphics subsystem shall be used instead of the display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the environment variable EW_HEADLESS is set, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemIsEnabled( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemInit
+*
+* DESCRIPTION:
+*   The function HeadlessSystemInit prepares the headless graphics subsystem.
+*   The given size is used for the off-screen surface.
+*
+* ARGUMENTS:
+*   aWidth   - Desired width of the GUI application in pixel.
+*   aHeight  - Desired height of the GUI application in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemInit
+(
+  int                         aWidth,
+  int                         aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemDone
+*
+* DESCRIPTION:
+*   The function HeadlessSystemDone closes the headless graphics subsystem and
+*   prints the frame statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessSystemDone( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemProcess
+*
+* DESCRIPTION:
+*   The function HeadlessSystemProcess checks whether the frame or time limit
+*   of the headless run is reached.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   1, if further processing is needed, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessSystemProcess( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetEventFd
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetEventFd returns the file descriptor, that
+*   becomes readable as soon as the time limit of the headless run expires.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the file descriptor or -1 if the running time is not limited.
+*
+*******************************************************************************/
+int HeadlessSystemGetEventFd( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetNextVBlank
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetNextVBlank returns the time of the next
+*   simulated vertical blank, when a frame rendered now would be presented.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the expected presentation time in microseconds (CLOCK_MONOTONIC)
+*   or 0 if the frames are rendered unthrottled.
+*
+*******************************************************************************/
+long long HeadlessSystemGetNextVBlank( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessSystemGetFramePeriod
+*
+* DESCRIPTION:
+*   The function HeadlessSystemGetFramePeriod returns the duration of one
+*   simulated frame.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the frame duration in microseconds or 0 if the frames are rendered
+*   unthrottled.
+*
+*******************************************************************************/
+long long HeadlessSystemGetFramePeriod( void );
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglInit
+*
+* DESCRIPTION:
+*   The function HeadlessEglInit initializes EGL with an off-screen surface and
+*   returns the display parameter. A pbuffer surface is used if available,
+*   otherwise a surfaceless context draws into a framebuffer object.
+*
+* ARGUMENTS:
+*   aDisplay - Pointer to return EGL display.
+*   aSurface - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth   - Pointer to return the width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int HeadlessEglInit
+(
+  void**                      aDisplay,
+  void**                      aSurface,
+  int*                        aFrameBuffer,
+  int*                        aWidth,
+  int*                        aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglDone
+*
+* DESCRIPTION:
+*   The function HeadlessEglDone stores the last frame (if requested) and
+*   deinitializes EGL.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display to deinitialize.
+*   aEglSurface - EGL surface to deinitialize.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessEglDone
+(
+  void*                       aDisplay,
+  void*                       aSurface
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeadlessEglSwapBuffers
+*
+* DESCRIPTION:
+*   The function HeadlessEglSwapBuffers completes the current frame. The
+*   function waits until the GPU has finished the frame and, if a refresh rate
+*   is simulated, until the next simulated vertical blank.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeadlessEglSwapBuffers
+(
+  void*                       aDisplay,
+  void*                       aSurface
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* GFX_SYSTEM_HEADLESS_H */
+
+
+/* msy */
@@ -0,0 +1,1329 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template reduces the number of OpenGL draw calls and state changes
+*   issued by the OpenGL adaptation of the Graphics Engine. Every drawing task
+*   of an issue results in its own draw call, thereby a list with many small
+*   items produces hundreds of draw calls per frame. The reduction works in two
+*   stages:
+*
+*   - After EwReorderTasks(), compatible tasks of an issue (same operation,
+*     same source surface and same mode) are moved together, as long as they
+*     do not overlap the tasks they are moved across. The appearance of the
+*     frame is not changed.
+*
+*   - Consecutive draw calls with identical OpenGL state are collected in one
+*     vertex buffer and submitted with a single glDrawArrays() call. Calls,
+*     that set the already active state again, are dropped. Any other change
+*     of the state submits the collected vertices first.
+*
+*   The number of the draw calls requested by the Graphics Engine, of the
+*   submitted draw calls and of the state changes is counted per frame and
+*   printed every EW_GPU_BATCH_REPORT_FRAMES frames and on shutdown.
+*
+*   The function EwReorderTasks() and the used OpenGL functions are redirected
+*   by the linker (option --wrap) to the respective __wrap_ functions. Only the
+*   texture unit 0 and client side vertex arrays are supported - as used by
+*   the OpenGL adaptation.
+*
+*   The batching is selected by EW_GPU_BATCHING or at runtime by the
+*   environment variable EW_GPU_BATCHING ("off" or "on"). Without batching,
+*   the calls are only counted.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <GLES2/gl2.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "ewgfxtasks.h"
+#include "texture_atlas.h"
+#include "overdraw_heatmap.h"
+#include "gpu_batch.h"
+
+#ifndef EW_GPU_BATCHING
+  #define EW_GPU_BATCHING             1
+#endif
+
+#ifndef EW_GPU_BATCH_REPORT_FRAMES
+  #define EW_GPU_BATCH_REPORT_FRAMES  600
+#endif
+
+/* capacity of the vertex buffer - a vertex attribute has up to 16 bytes */
+#define MAX_VERTICES                  6144
+#define MAX_ATTRIBUTE_SIZE            16
+#define MAX_ATTRIBUTES                8
+
+/* number of following tasks examined for compatible tasks */
+#define MAX_LOOKAHEAD                 16
+
+/* number of cached capabilities and uniform values */
+#define NO_OF_CAPS                    8
+#define NO_OF_UNIFORMS                8
+
+/* the original functions of the Graphics Engine and OpenGL */
+void __real_EwReorderTasks( XIssue* aIssue );
+void __real_glDrawArrays( GLenum aMode, GLint aFirst, GLsizei aCount );
+void __real_glVertexAttribPointer( GLuint aIndex, GLint aSize, GLenum aType,
+  GLboolean aNormalized, GLsizei aStride, const void* aPointer );
+void __real_glEnableVertexAttribArray( GLuint aIndex );
+void __real_glUseProgram( GLuint aProgram );
+void __real_glDeleteProgram( GLuint aProgram );
+void __real_glBindTexture( GLenum aTarget, GLuint aTexture );
+void __real_glBlendFunc( GLenum aSrc, GLenum aDst );
+void __real_glBlendEquation( GLenum aMode );
+void __real_glEnable( GLenum aCap );
+void __real_glDisable( GLenum aCap );
+void __real_glViewport( GLint aX, GLint aY, GLsizei aWidth, GLsizei aHeight );
+void __real_glBindFramebuffer( GLenum aTarget, GLuint aFramebuffer );
+void __real_glFramebufferTexture2D( GLenum aTarget, GLenum aAttachment,
+  GLenum aTexTarget, GLuint aTexture, GLint aLevel );
+void __real_glDeleteFramebuffers( GLsizei aCount, const GLuint* aFramebuffers );
+void __real_glUniform1i( GLint aLocation, GLint aValue );
+void __real_glUniformMatrix4fv( GLint aLocation, GLsizei aCount,
+  GLboolean aTranspose, const GLfloat* aValue );
+void __real_glTexImage2D( GLenum aTarget, GLint aLevel, GLint aInternalFormat,
+  GLsizei aWidth, GLsizei aHeight, GLint aBorder, GLenum aFormat, GLenum aType,
+  const void* aPixels );
+void __real_glTexSubImage2D( GLenum aTarget, GLint aLevel, GLint aX, GLint aY,
+  GLsizei aWidth, GLsizei aHeight, GLenum aFormat, GLenum aType,
+  const void* aPixels );
+void __real_glTexParameteri( GLenum aTarget, GLenum aName, GLint aParam );
+void __real_glDeleteTextures( GLsizei aCount, const GLuint* aTextures );
+void __real_glFlush( void );
+void __real_glFinish( void );
+
+typedef struct
+{
+  GLint         Size;
+  GLenum        Type;
+  GLboolean     Normalized;
+  GLsizei       Stride;
+  const char*   Pointer;
+} XAttribute;
+
+typedef struct
+{
+  GLenum        Cap;
+  int           State;
+} XCap;
+
+typedef struct
+{
+  GLuint        Program;
+  GLint         Location;
+  GLfloat       Value[ 16 ];
+} XUniform;
+
+typedef struct
+{
+  unsigned int  Requested;     /* draw calls of the Graphics Engine */
+  unsigned int  Submitted;     /* draw calls passed to OpenGL */
+  unsigned int  StateChanges;  /* state changes passed to OpenGL */
+  unsigned int  Redundant;     /* dropped state changes */
+  unsigned int  Regrouped;     /* tasks moved to a compatible task */
+} XBatchStatistic;
+
+static int             Enabled = 0;
+
+/* the vertex attributes as specified by the OpenGL adaptation */
+static XAttribute      Attributes[ MAX_ATTRIBUTES ];
+static unsigned int    EnabledAttributes;
+
+/* the collected vertices - one packed array per attribute */
+static char*           Vertices[ MAX_ATTRIBUTES ];
+static XAttribute      Layout[ MAX_ATTRIBUTES ];
+static unsigned int    LayoutAttributes;
+static int             NoOfVertices;
+
+/* the current OpenGL state - the initial state is unknown */
+static GLuint          Program;
+static GLuint          Texture;
+static GLuint          Framebuffer;
+static GLenum          BlendSrc;
+static GLenum          BlendDst;
+static GLenum          BlendMode;
+static GLint           Viewport[ 4 ];
+static XCap            Caps[ NO_OF_CAPS ];
+static int             NoOfCaps;
+static XUniform        Uniforms[ NO_OF_UNIFORMS ];
+static int             NextUniform;
+
+static XBatchStatistic Frame;
+static XBatchStatistic Period;
+static XBatchStatistic Total;
+static unsigned int    NoOfFrames;
+static unsigned int    NoOfPeriodFrames;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to return the size of one vertex attribute in bytes or 0 if
+ * the attribute can not be collected
+ */
+static int GetAttributeSize( const XAttribute* aAttribute )
+{
+  int size = 0;
+
+  switch ( aAttribute->Type )
+  {
+    case GL_BYTE           :
+    case GL_UNSIGNED_BYTE  : size = 1; break;
+    case GL_SHORT          :
+    case GL_UNSIGNED_SHORT : size = 2; break;
+    case GL_FIXED          :
+    case GL_FLOAT          : size = 4; break;
+  }
+
+  size *= aAttribute->Size;
+
+  return ( size <= MAX_ATTRIBUTE_SIZE ) ? size : 0;
+}
+
+
+/*
+ * helper function to pass the collected vertices to OpenGL with one draw call
+ */
+static void Submit( void )
+{
+  int i;
+
+  if ( !NoOfVertices )
+    return;
+
+  for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+    if ( LayoutAttributes & ( 1 << i ))
+      __real_glVertexAttribPointer( i, Layout[ i ].Size, Layout[ i ].Type,
+        Layout[ i ].Normalized, 0, Vertices[ i ]);
+
+  __real_glDrawArrays( GL_TRIANGLES, 0, NoOfVertices );
+
+  Frame.Submitted++;
+  NoOfVertices = 0;
+}
+
+
+/*
+ * helper function to record a state change - the collected vertices are
+ * drawn with the previous state
+ */
+static void ChangeState( void )
+{
+  Submit();
+  Frame.StateChanges++;
+}
+
+
+/*
+ * helper function to find out whether a state change can be dropped - the
+ * state is only tracked while batching
+ */
+static int IsRedundant( int aUnchanged )
+{
+  if ( Enabled && aUnchanged )
+  {
+    Frame.Redundant++;
+    return 1;
+  }
+
+  ChangeState();
+  return 0;
+}
+
+
+/*
+ * helper function to find out whether a uniform of the current program has
+ * already the given value - otherwise the value is cached
+ */
+static int IsSameUniform( GLint aLocation, const GLfloat* aValue, int aSize )
+{
+  XUniform* uniform = NULL;
+  int       i;
+
+  for ( i = 0; ( i < NO_OF_UNIFORMS ) && !uniform; i++ )
+    if (( Uniforms[ i ].Program == Program ) && ( Uniforms[ i ].Location == aLocation ))
+      uniform = &Uniforms[ i ];
+
+  if ( uniform && !memcmp( uniform->Value, aValue, aSize * sizeof( GLfloat )))
+    return 1;
+
+  if ( !uniform )
+    uniform = &Uniforms[ NextUniform++ % NO_OF_UNIFORMS ];
+
+  uniform->Program  = Program;
+  uniform->Location = aLocation;
+  memcpy( uniform->Value, aValue, aSize * sizeof( GLfloat ));
+
+  return 0;
+}
+
+
+/*
+ * helper function to find out whether the current vertex attributes match the
+ * layout of the collected vertices
+ */
+static int IsSameLayout( void )
+{
+  int i;
+
+  if ( EnabledAttributes != LayoutAttributes )
+    return 0;
+
+  for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+    if (( EnabledAttributes & ( 1 << i )) &&
+       (( Attributes[ i ].Size       != Layout[ i ].Size ) ||
+        ( Attributes[ i ].Type       != Layout[ i ].Type ) ||
+        ( Attributes[ i ].Normalized != Layout[ i ].Normalized )))
+      return 0;
+
+  return 1;
+}
+
+
+/*
+ * helper function to start a new vertex buffer with the current layout -
+ * returns 0 if the vertices can not be collected
+ */
+static int BeginLayout( void )
+{
+  int i;
+
+  for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+  {
+    if ( !( EnabledAttributes & ( 1 << i )))
+      continue;
+
+    if ( !GetAttributeSize( &Attributes[ i ]) || !Attributes[ i ].Pointer )
+      return 0;
+
+    if ( !Vertices[ i ])
+      Vertices[ i ] = malloc( MAX_VERTICES * MAX_ATTRIBUTE_SIZE );
+
+    if ( !Vertices[ i ])
+      return 0;
+
+    Layout[ i ] = Attributes[ i ];
+  }
+
+  LayoutAttributes = EnabledAttributes;
+  return 1;
+}
+
+
+/*
+ * helper function to append one vertex of the client arrays to the collected
+ * vertices
+ */
+static void AppendVertex( int aIndex )
+{
+  int i;
+  int size;
+  int stride;
+
+  for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+  {
+    if ( !( LayoutAttributes & ( 1 << i )))
+      continue;
+
+    size   = GetAttributeSize( &Attributes[ i ]);
+    stride = Attributes[ i ].Stride ? Attributes[ i ].Stride : size;
+
+    memcpy( Vertices[ i ] + NoOfVertices * size, Attributes[ i ].Pointer +
+      aIndex * stride, size );
+  }
+
+  NoOfVertices++;
+}
+
+
+/*
+ * helper function to find out whether a task can be moved to a compatible
+ * task - the texture of the source surface is compared for the copy operations
+ */
+static unsigned long GetSourceTexture( XTask* aTask )
+{
+  XSurface* surface = NULL;
+
+  switch ( aTask->Token )
+  {
+    case EW_TASKID_COPY_SURFACE :
+      surface = ((XCopySurface*)aTask->Data )->Surface;
+      break;
+
+    case EW_TASKID_TILE_SURFACE :
+      surface = ((XTileSurface*)aTask->Data )->Surface;
+      break;
+
+    case EW_TASKID_WARP_PERSP_SURFACE  :
+    case EW_TASKID_WARP_AFFINE_SURFACE :
+    case EW_TASKID_WARP_SCALE_SURFACE  :
+      surface = ((XWarpSurface*)aTask->Data )->Surface;
+      break;
+  }
+
+  /* the bitmaps within the same atlas page share their texture */
+  return surface ? TextureAtlasGetTexture( surface->Handle ) : 0;
+}
+
+
+/*
+ * helper function to find out whether two tasks result in the same OpenGL
+ * state - the lines and polygons and the emulated tasks are not moved
+ */
+static int IsCompatible( XTask* aTask1, XTask* aTask2 )
+{
+  if (( aTask1->Token == EW_TASKID_DRAW_LINE ) ||
+      ( aTask1->Token == EW_TASKID_FILL_POLYGON ) ||
+      ( aTask1->Flags & EW_TASK_EMULATION ))
+    return 0;
+
+  return ( aTask1->Token == aTask2->Token ) &&
+    (( aTask1->Flags & ( EW_TASK_MODE_MASK | EW_TASK_EMULATION )) ==
+     ( aTask2->Flags & ( EW_TASK_MODE_MASK | EW_TASK_EMULATION ))) &&
+    ( GetSourceTexture( aTask1 ) == GetSourceTexture( aTask2 ));
+}
+
+
+/*
+ * helper function to find out whether a task overlaps one of the given tasks
+ * - touching areas are considered as overlapping
+ */
+static int Overlaps( XTask* aTask, XTask** aTasks, int aCount )
+{
+  int i;
+
+  for ( i = 0; i < aCount; i++ )
+    if (( aTask->X1 <= aTasks[ i ]->X2 ) && ( aTasks[ i ]->X1 <= aTask->X2 ) &&
+        ( aTask->Y1 <= aTasks[ i ]->Y2 ) && ( aTasks[ i ]->Y1 <= aTask->Y2 ))
+      return 1;
+
+  return 0;
+}
+
+
+/*
+ * helper function to move the compatible tasks of an issue together - a task
+ * is only moved across tasks, it does not overlap, so the order of all the
+ * overlapping tasks remains unchanged
+ */
+static void GroupTasks( XIssue* aIssue )
+{
+  XTask* between[ MAX_LOOKAHEAD ];
+  XTask* task;
+  XTask* last;
+  XTask* prev;
+  XTask* next;
+  int    count;
+
+  for ( task = aIssue->Tasks; task; task = last->Next )
+  {
+    last  = task;
+    prev  = task;
+    next  = task->Next;
+    count = 0;
+
+    while ( next && ( count < MAX_LOOKAHEAD ))
+    {
+      /* the task is not compatible or has to stay behind the tasks between */
+      if ( !IsCompatible( task, next ) || Overlaps( next, between, count ))
+      {
+        between[ count++ ] = next;
+        prev = next;
+        next = next->Next;
+        continue;
+      }
+
+      /* move the task to the end of the group */
+      if ( prev != last )
+      {
+        prev->Next = next->Next;
+        next->Next = last->Next;
+        last->Next = next;
+        Frame.Regrouped++;
+      }
+      else
+        prev = next;
+
+      last = next;
+      next = prev->Next;
+    }
+  }
+}
+
+
+/*
+ * helper function to add the statistic of a frame
+ */
+static void AddStatistic( XBatchStatistic* aSum, XBatchStatistic* aFrame )
+{
+  aSum->Requested    += aFrame->Requested;
+  aSum->Submitted    += aFrame->Submitted;
+  aSum->StateChanges += aFrame->StateChanges;
+  aSum->Redundant    += aFrame->Redundant;
+  aSum->Regrouped    += aFrame->Regrouped;
+}
+
+
+/*
+ * helper function to print the average values per frame
+ */
+static void PrintStatistic( const char* aTitle, XBatchStatistic* aSum,
+  unsigned int aFrames )
+{
+  if ( !aFrames )
+    return;
+
+  EwPrint( "GpuBatch: %s %u frames, per frame: %u draw calls requested, %u "
+    "submitted, %u state changes, %u dropped, %u tasks regrouped\n", aTitle,
+    aFrames, aSum->Requested / aFrames, aSum->Submitted / aFrames,
+    aSum->StateChanges / aFrames, aSum->Redundant / aFrames,
+    aSum->Regrouped / aFrames );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchInit
+*
+* DESCRIPTION:
+*   The function GpuBatchInit selects whether the draw calls are collected and
+*   resets the statistic. It has to be called before the Graphics Engine is
+*   initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchInit( void )
+{
+  Enabled = EwGetEnvSwitch( "EW_GPU_BATCHING", EW_GPU_BATCHING );
+
+  EnabledAttributes = 0;
+  LayoutAttributes  = 0;
+  NoOfVertices      = 0;
+  NoOfCaps          = 0;
+  NextUniform       = 0;
+  NoOfFrames        = 0;
+  NoOfPeriodFrames  = 0;
+
+  /* the state is unknown until it is set the first time */
+  Program     = (GLuint)-1;
+  Texture     = (GLuint)-1;
+  Framebuffer = (GLuint)-1;
+  BlendSrc    = (GLenum)-1;
+  BlendDst    = (GLenum)-1;
+  BlendMode   = (GLenum)-1;
+
+  memset( Viewport, 0xFF, sizeof( Viewport ));
+  memset( Uniforms, 0xFF, sizeof( Uniforms ));
+  memset( &Frame, 0, sizeof( Frame ));
+  memset( &Period, 0, sizeof( Period ));
+  memset( &Total, 0, sizeof( Total ));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchDone
+*
+* DESCRIPTION:
+*   The function GpuBatchDone prints the statistic of all frames and releases
+*   the vertex buffers.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchDone( void )
+{
+  int i;
+
+  PrintStatistic( "all", &Total, NoOfFrames );
+
+  for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+  {
+    free( Vertices[ i ]);
+    Vertices[ i ] = NULL;
+  }
+
+  NoOfVertices = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchFlush
+*
+* DESCRIPTION:
+*   The function GpuBatchFlush passes the collected vertices to OpenGL. It has
+*   to be called before the content of the framebuffer is presented or read.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchFlush( void )
+{
+  Submit();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchEndFrame
+*
+* DESCRIPTION:
+*   The function GpuBatchEndFrame has to be called after a frame has been
+*   drawn. The counted draw calls and state changes are added to the statistic
+*   and printed every EW_GPU_BATCH_REPORT_FRAMES frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchEndFrame( void )
+{
+  Submit();
+
+  AddStatistic( &Period, &Frame );
+  AddStatistic( &Total, &Frame );
+  memset( &Frame, 0, sizeof( Frame ));
+
+  NoOfFrames++;
+  NoOfPeriodFrames++;
+
+  if (( EW_GPU_BATCH_REPORT_FRAMES > 0 ) && ( NoOfPeriodFrames >= EW_GPU_BATCH_REPORT_FRAMES ))
+  {
+    PrintStatistic( "last", &Period, NoOfPeriodFrames );
+    memset( &Period, 0, sizeof( Period ));
+    NoOfPeriodFrames = 0;
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwReorderTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwReorderTasks replaces EwReorderTasks() of the
+*   Graphics Engine. After the original reordering, the compatible tasks are
+*   moved together, so their draw calls can be collected.
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to change the order.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwReorderTasks( XIssue* aIssue )
+{
+  __real_EwReorderTasks( aIssue );
+
+  if ( Enabled )
+    GroupTasks( aIssue );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDrawArrays
+*
+* DESCRIPTION:
+*   The function __wrap_glDrawArrays replaces glDrawArrays() of the OpenGL
+*   adaptation. Triangles, triangle strips and triangle fans are converted to
+*   triangles and appended to the collected vertices. Other primitives are
+*   drawn immediately.
+*
+* ARGUMENTS:
+*   See glDrawArrays().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDrawArrays( GLenum aMode, GLint aFirst, GLsizei aCount )
+{
+  int count = 0;
+  int i;
+
+  Frame.Requested++;
+
+  /* number of vertices as separate triangles */
+  if (( aMode == GL_TRIANGLES ) && ( aCount >= 3 ))
+    count = aCount / 3 * 3;
+  else if ((( aMode == GL_TRIANGLE_STRIP ) || ( aMode == GL_TRIANGLE_FAN )) && ( aCount >= 3 ))
+    count = ( aCount - 2 ) * 3;
+
+  if ( NoOfVertices && ( !IsSameLayout() || ( NoOfVertices + count > MAX_VERTICES )))
+    Submit();
+
+  /* the primitives are drawn with the client arrays of the OpenGL adaptation */
+  if ( !Enabled || !count || ( count > MAX_VERTICES ) || ( !NoOfVertices && !BeginLayout()))
+  {
+    Submit();
+
+    for ( i = 0; i < MAX_ATTRIBUTES; i++ )
+      if ( EnabledAttributes & ( 1 << i ))
+        __real_glVertexAttribPointer( i, Attributes[ i ].Size, Attributes[ i ].Type,
+          Attributes[ i ].Normalized, Attributes[ i ].Stride, Attributes[ i ].Pointer );
+
+    __real_glDrawArrays( aMode, aFirst, aCount );
+    Frame.Submitted++;
+    return;
+  }
+
+  /* without face culling, the winding of the triangles does not matter */
+  if ( aMode == GL_TRIANGLES )
+    for ( i = 0; i < count; i++ )
+      AppendVertex( aFirst + i );
+
+  else if ( aMode == GL_TRIANGLE_STRIP )
+    for ( i = 0; i < aCount - 2; i++ )
+    {
+      AppendVertex( aFirst + i );
+      AppendVertex( aFirst + i + 1 );
+      AppendVertex( aFirst + i + 2 );
+    }
+
+  else
+    for ( i = 0; i < aCount - 2; i++ )
+    {
+      AppendVertex( aFirst );
+      AppendVertex( aFirst + i + 1 );
+      AppendVertex( aFirst + i + 2 );
+    }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glVertexAttribPointer
+*
+* DESCRIPTION:
+*   The function __wrap_glVertexAttribPointer replaces glVertexAttribPointer()
+*   of the OpenGL adaptation. The client array is recorded and passed to OpenGL
+*   with the next draw call.
+*
+* ARGUMENTS:
+*   See glVertexAttribPointer().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glVertexAttribPointer( GLuint aIndex, GLint aSize, GLenum aType,
+  GLboolean aNormalized, GLsizei aStride, const void* aPointer )
+{
+  if ( aIndex >= MAX_ATTRIBUTES )
+  {
+    __real_glVertexAttribPointer( aIndex, aSize, aType, aNormalized, aStride, aPointer );
+    return;
+  }
+
+  Attributes[ aIndex ].Size       = aSize;
+  Attributes[ aIndex ].Type       = aType;
+  Attributes[ aIndex ].Normalized = aNormalized;
+  Attributes[ aIndex ].Stride     = aStride;
+  Attributes[ aIndex ].Pointer    = aPointer;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glEnableVertexAttribArray
+*
+* DESCRIPTION:
+*   The function __wrap_glEnableVertexAttribArray replaces the function
+*   glEnableVertexAttribArray() of the OpenGL adaptation and records the
+*   enabled attributes.
+*
+* ARGUMENTS:
+*   See glEnableVertexAttribArray().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glEnableVertexAttribArray( GLuint aIndex )
+{
+  if (( aIndex < MAX_ATTRIBUTES ) && ( EnabledAttributes & ( 1 << aIndex )))
+  {
+    Frame.Redundant++;
+    return;
+  }
+
+  ChangeState();
+
+  if ( aIndex < MAX_ATTRIBUTES )
+    EnabledAttributes |= 1 << aIndex;
+
+  __real_glEnableVertexAttribArray( aIndex );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glUseProgram
+*
+* DESCRIPTION:
+*   The function __wrap_glUseProgram replaces glUseProgram() of the OpenGL
+*   adaptation. The collected vertices are drawn before the program changes.
+*
+* ARGUMENTS:
+*   See glUseProgram().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glUseProgram( GLuint aProgram )
+{
+  if ( IsRedundant( aProgram == Program ))
+    return;
+
+  Program = aProgram;
+  __real_glUseProgram( aProgram );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDeleteProgram
+*
+* DESCRIPTION:
+*   The function __wrap_glDeleteProgram replaces glDeleteProgram() of the
+*   OpenGL adaptation. The collected vertices are drawn before. The cached
+*   uniform values of the program are discarded, since OpenGL may reuse its
+*   name for a new program.
+*
+* ARGUMENTS:
+*   See glDeleteProgram().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDeleteProgram( GLuint aProgram )
+{
+  int i;
+
+  ChangeState();
+
+  for ( i = 0; i < NO_OF_UNIFORMS; i++ )
+    if ( Uniforms[ i ].Program == aProgram )
+      memset( &Uniforms[ i ], 0xFF, sizeof( XUniform ));
+
+  if ( aProgram == Program )
+    Program = (GLuint)-1;
+
+  __real_glDeleteProgram( aProgram );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glBindTexture
+*
+* DESCRIPTION:
+*   The function __wrap_glBindTexture replaces glBindTexture() of the OpenGL
+*   adaptation. The collected vertices are drawn before the texture changes.
+*
+* ARGUMENTS:
+*   See glBindTexture().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glBindTexture( GLenum aTarget, GLuint aTexture )
+{
+  if ( IsRedundant(( aTarget == GL_TEXTURE_2D ) && ( aTexture == Texture )))
+    return;
+
+  if ( aTarget == GL_TEXTURE_2D )
+    Texture = aTexture;
+
+  __real_glBindTexture( aTarget, aTexture );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glBlendFunc
+*
+* DESCRIPTION:
+*   The function __wrap_glBlendFunc replaces glBlendFunc() of the OpenGL
+*   adaptation. The collected vertices are drawn before the blending changes.
+*
+* ARGUMENTS:
+*   See glBlendFunc().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glBlendFunc( GLenum aSrc, GLenum aDst )
+{
+  if ( IsRedundant(( aSrc == BlendSrc ) && ( aDst == BlendDst )))
+    return;
+
+  BlendSrc = aSrc;
+  BlendDst = aDst;
+  __real_glBlendFunc( aSrc, aDst );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glBlendEquation
+*
+* DESCRIPTION:
+*   The function __wrap_glBlendEquation replaces glBlendEquation() of the
+*   OpenGL adaptation. The collected vertices are drawn before the blending
+*   changes.
+*
+* ARGUMENTS:
+*   See glBlendEquation().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glBlendEquation( GLenum aMode )
+{
+  if ( IsRedundant( aMode == BlendMode ))
+    return;
+
+  BlendMode = aMode;
+  __real_glBlendEquation( aMode );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glEnable
+*
+* DESCRIPTION:
+*   The function __wrap_glEnable replaces glEnable() of the OpenGL adaptation.
+*   The collected vertices are drawn before the capability changes.
+*
+* ARGUMENTS:
+*   See glEnable().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glEnable( GLenum aCap )
+{
+  XCap* cap = Caps;
+
+  while (( cap < Caps + NoOfCaps ) && ( cap->Cap != aCap ))
+    cap++;
+
+  if ( IsRedundant(( cap < Caps + NoOfCaps ) && cap->State ))
+    return;
+
+  if (( cap == Caps + NoOfCaps ) && ( NoOfCaps < NO_OF_CAPS ))
+    Caps[ NoOfCaps++ ].Cap = aCap;
+
+  if ( cap < Caps + NoOfCaps )
+    cap->State = 1;
+
+  __real_glEnable( aCap );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDisable
+*
+* DESCRIPTION:
+*   The function __wrap_glDisable replaces glDisable() of the OpenGL
+*   adaptation. The collected vertices are drawn before the capability
+*   changes.
+*
+* ARGUMENTS:
+*   See glDisable().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDisable( GLenum aCap )
+{
+  XCap* cap = Caps;
+
+  while (( cap < Caps + NoOfCaps ) && ( cap->Cap != aCap ))
+    cap++;
+
+  if ( IsRedundant(( cap < Caps + NoOfCaps ) && !cap->State ))
+    return;
+
+  if (( cap == Caps + NoOfCaps ) && ( NoOfCaps < NO_OF_CAPS ))
+    Caps[ NoOfCaps++ ].Cap = aCap;
+
+  if ( cap < Caps + NoOfCaps )
+    cap->State = 0;
+
+  __real_glDisable( aCap );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glViewport
+*
+* DESCRIPTION:
+*   The function __wrap_glViewport replaces glViewport() of the OpenGL
+*   adaptation. The collected vertices are drawn before the viewport changes.
+*
+* ARGUMENTS:
+*   See glViewport().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glViewport( GLint aX, GLint aY, GLsizei aWidth, GLsizei aHeight )
+{
+  if ( IsRedundant(( aX == Viewport[ 0 ]) && ( aY == Viewport[ 1 ]) &&
+      ( aWidth == Viewport[ 2 ]) && ( aHeight == Viewport[ 3 ])))
+    return;
+
+  Viewport[ 0 ] = aX;
+  Viewport[ 1 ] = aY;
+  Viewport[ 2 ] = aWidth;
+  Viewport[ 3 ] = aHeight;
+  __real_glViewport( aX, aY, aWidth, aHeight );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glBindFramebuffer
+*
+* DESCRIPTION:
+*   The function __wrap_glBindFramebuffer replaces glBindFramebuffer() of the
+*   OpenGL adaptation. The collected vertices are drawn into the previous
+*   framebuffer. While the overdraw heatmap is shown, the framebuffer of the
+*   screen is replaced by the offscreen buffer counting the overdraw.
+*
+* ARGUMENTS:
+*   See glBindFramebuffer().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glBindFramebuffer( GLenum aTarget, GLuint aFramebuffer )
+{
+  aFramebuffer = OverdrawHeatmapGetFramebuffer( aFramebuffer );
+
+  if ( IsRedundant( aFramebuffer == Framebuffer ))
+    return;
+
+  Framebuffer = aFramebuffer;
+  __real_glBindFramebuffer( aTarget, aFramebuffer );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glFramebufferTexture2D
+*
+* DESCRIPTION:
+*   The function __wrap_glFramebufferTexture2D replaces the function
+*   glFramebufferTexture2D() of the OpenGL adaptation. The collected vertices
+*   are drawn into the previous attachment.
+*
+* ARGUMENTS:
+*   See glFramebufferTexture2D().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glFramebufferTexture2D( GLenum aTarget, GLenum aAttachment,
+  GLenum aTexTarget, GLuint aTexture, GLint aLevel )
+{
+  ChangeState();
+  __real_glFramebufferTexture2D( aTarget, aAttachment, aTexTarget, aTexture, aLevel );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDeleteFramebuffers
+*
+* DESCRIPTION:
+*   The function __wrap_glDeleteFramebuffers replaces glDeleteFramebuffers()
+*   of the OpenGL adaptation. The collected vertices are drawn before. The
+*   deletion of the bound framebuffer binds the default framebuffer.
+*
+* ARGUMENTS:
+*   See glDeleteFramebuffers().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDeleteFramebuffers( GLsizei aCount, const GLuint* aFramebuffers )
+{
+  int i;
+
+  ChangeState();
+
+  for ( i = 0; i < aCount; i++ )
+    if ( aFramebuffers[ i ] == Framebuffer )
+      Framebuffer = 0;
+
+  __real_glDeleteFramebuffers( aCount, aFramebuffers );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glUniform1i
+*
+* DESCRIPTION:
+*   The function __wrap_glUniform1i replaces glUniform1i() of the OpenGL
+*   adaptation. The values of the uniforms are cached per program, so setting
+*   the same value again does not interrupt the batch.
+*
+* ARGUMENTS:
+*   See glUniform1i().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glUniform1i( GLint aLocation, GLint aValue )
+{
+  GLfloat value = (GLfloat)aValue;
+
+  if ( IsRedundant( IsSameUniform( aLocation, &value, 1 )))
+    return;
+
+  __real_glUniform1i( aLocation, aValue );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glUniformMatrix4fv
+*
+* DESCRIPTION:
+*   The function __wrap_glUniformMatrix4fv replaces glUniformMatrix4fv() of
+*   the OpenGL adaptation. The values of the uniforms are cached per program,
+*   so setting the same matrix again does not interrupt the batch.
+*
+* ARGUMENTS:
+*   See glUniformMatrix4fv().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glUniformMatrix4fv( GLint aLocation, GLsizei aCount,
+  GLboolean aTranspose, const GLfloat* aValue )
+{
+  if ( IsRedundant(( aCount == 1 ) && IsSameUniform( aLocation, aValue, 16 )))
+    return;
+
+  __real_glUniformMatrix4fv( aLocation, aCount, aTranspose, aValue );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glTexImage2D
+*
+* DESCRIPTION:
+*   The function __wrap_glTexImage2D replaces glTexImage2D() of the OpenGL
+*   adaptation. The collected vertices are drawn before the texture is loaded.
+*
+* ARGUMENTS:
+*   See glTexImage2D().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glTexImage2D( GLenum aTarget, GLint aLevel, GLint aInternalFormat,
+  GLsizei aWidth, GLsizei aHeight, GLint aBorder, GLenum aFormat, GLenum aType,
+  const void* aPixels )
+{
+  ChangeState();
+  __real_glTexImage2D( aTarget, aLevel, aInternalFormat, aWidth, aHeight, aBorder,
+    aFormat, aType, aPixels );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glTexSubImage2D
+*
+* DESCRIPTION:
+*   The function __wrap_glTexSubImage2D replaces glTexSubImage2D() of the
+*   OpenGL adaptation. The collected vertices are drawn before the texture is
+*   modified - they may still refer to its previous content.
+*
+* ARGUMENTS:
+*   See glTexSubImage2D().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glTexSubImage2D( GLenum aTarget, GLint aLevel, GLint aX, GLint aY,
+  GLsizei aWidth, GLsizei aHeight, GLenum aFormat, GLenum aType,
+  const void* aPixels )
+{
+  ChangeState();
+  __real_glTexSubImage2D( aTarget, aLevel, aX, aY, aWidth, aHeight, aFormat,
+    aType, aPixels );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glTexParameteri
+*
+* DESCRIPTION:
+*   The function __wrap_glTexParameteri replaces glTexParameteri() of the
+*   OpenGL adaptation. The collected vertices are drawn before the sampling of
+*   the texture changes.
+*
+* ARGUMENTS:
+*   See glTexParameteri().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glTexParameteri( GLenum aTarget, GLenum aName, GLint aParam )
+{
+  ChangeState();
+  __real_glTexParameteri( aTarget, aName, aParam );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDeleteTextures
+*
+* DESCRIPTION:
+*   The function __wrap_glDeleteTextures replaces glDeleteTextures() of the
+*   OpenGL adaptation. The collected vertices are drawn before. The deletion
+*   of the bound texture binds the default texture.
+*
+* ARGUMENTS:
+*   See glDeleteTextures().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDeleteTextures( GLsizei aCount, const GLuint* aTextures )
+{
+  int i;
+
+  ChangeState();
+
+  for ( i = 0; i < aCount; i++ )
+    if ( aTextures[ i ] == Texture )
+      Texture = 0;
+
+  __real_glDeleteTextures( aCount, aTextures );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glFlush
+*
+* DESCRIPTION:
+*   The function __wrap_glFlush replaces glFlush() of the OpenGL adaptation.
+*   The collected vertices are drawn before.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glFlush( void )
+{
+  Submit();
+  __real_glFlush();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glFinish
+*
+* DESCRIPTION:
+*   The function __wrap_glFinish replaces glFinish() of the OpenGL adaptation.
+*   The collected vertices are drawn before.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glFinish( void )
+{
+  Submit();
+  __real_glFinish();
+}
+
+
+/* msy */
@@ -0,0 +1,341 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template reduces the number of OpenGL draw calls and state changes
+*   issued by the OpenGL adaptation of the Graphics Engine. Compatible tasks
+*   of an issue are moved together and consecutive draw calls with identical
+*   OpenGL state are submitted with a single glDrawArrays() call. Calls, that
+*   set the already active state again, are dropped.
+*
+*   The function EwReorderTasks() and the used OpenGL functions are redirected
+*   by the linker (option --wrap) to the respective __wrap_ functions. The
+*   batching is selected by EW_GPU_BATCHING or at runtime by the environment
+*   variable EW_GPU_BATCHING ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef GPU_BATCH_H
+#define GPU_BATCH_H
+
+#include <GLES2/gl2.h>
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/* issue of the Graphics Engine, see ewgfxcore.h */
+struct XIssue;
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchInit
+*
+* DESCRIPTION:
+*   The function GpuBatchInit selects whether the draw calls are collected and
+*   resets the statistic. It has to be called before the Graphics Engine is
+*   initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchDone
+*
+* DESCRIPTION:
+*   The function GpuBatchDone prints the statistic of all frames and releases
+*   the vertex buffers.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchFlush
+*
+* DESCRIPTION:
+*   The function GpuBatchFlush passes the collected vertices to OpenGL. It has
+*   to be called before the content of the framebuffer is presented or read.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchFlush
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   GpuBatchEndFrame
+*
+* DESCRIPTION:
+*   The function GpuBatchEndFrame has to be called after a frame has been
+*   drawn. The counted draw calls and state changes are added to the statistic
+*   and printed every EW_GPU_BATCH_REPORT_FRAMES frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void GpuBatchEndFrame
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwReorderTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwReorderTasks replaces EwReorderTasks() of the
+*   Graphics Engine. After the original reordering, the compatible tasks are
+*   moved together, so their draw calls can be collected.
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to change the order.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwReorderTasks
+(
+  struct XIssue*              aIssue
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDrawArrays ... __wrap_glFinish
+*
+* DESCRIPTION:
+*   The following functions replace the respective OpenGL functions of the
+*   OpenGL adaptation. The draw calls are collected, the calls setting the
+*   active state again are dropped and any other state change draws the
+*   collected vertices first.
+*
+* ARGUMENTS:
+*   See the respective OpenGL function.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDrawArrays
+(
+  GLenum                      aMode,
+  GLint                       aFirst,
+  GLsizei                     aCount
+);
+
+void __wrap_glVertexAttribPointer
+(
+  GLuint                      aIndex,
+  GLint                       aSize,
+  GLenum                      aType,
+  GLboolean                   aNormalized,
+  GLsizei                     aStride,
+  const void*                 aPointer
+);
+
+void __wrap_glEnableVertexAttribArray
+(
+  GLuint                      aIndex
+);
+
+void __wrap_glUseProgram
+(
+  GLuint                      aProgram
+);
+
+void __wrap_glDeleteProgram
+(
+  GLuint                      aProgram
+);
+
+void __wrap_glBindTexture
+(
+  GLenum                      aTarget,
+  GLuint                      aTexture
+);
+
+void __wrap_glBlendFunc
+(
+  GLenum                      aSrc,
+  GLenum                      aDst
+);
+
+void __wrap_glBlendEquation
+(
+  GLenum                      aMode
+);
+
+void __wrap_glEnable
+(
+  GLenum                      aCap
+);
+
+void __wrap_glDisable
+(
+  GLenum                      aCap
+);
+
+void __wrap_glViewport
+(
+  GLint                       aX,
+  GLint                       aY,
+  GLsizei                     aWidth,
+  GLsizei                     aHeight
+);
+
+void __wrap_glBindFramebuffer
+(
+  GLenum                      aTarget,
+  GLuint                      aFramebuffer
+);
+
+void __wrap_glFramebufferTexture2D
+(
+  GLenum                      aTarget,
+  GLenum                      aAttachment,
+  GLenum                      aTexTarget,
+  GLuint                      aTexture,
+  GLint                       aLevel
+);
+
+void __wrap_glDeleteFramebuffers
+(
+  GLsizei                     aCount,
+  const GLuint*               aFramebuffers
+);
+
+void __wrap_glUniform1i
+(
+  GLint                       aLocation,
+  GLint                       aValue
+);
+
+void __wrap_glUniformMatrix4fv
+(
+  GLint                       aLocation,
+  GLsizei                     aCount,
+  GLboolean                   aTranspose,
+  const GLfloat*              aValue
+);
+
+void __wrap_glTexImage2D
+(
+  GLenum                      aTarget,
+  GLint                       aLevel,
+  GLint                       aInternalFormat,
+  GLsizei                     aWidth,
+  GLsizei                     aHeight,
+  GLint                       aBorder,
+  GLenum                      aFormat,
+  GLenum                      aType,
+  const void*                 aPixels
+);
+
+void __wrap_glTexSubImage2D
+(
+  GLenum                      aTarget,
+  GLint                       aLevel,
+  GLint                       aX,
+  GLint                       aY,
+  GLsizei                     aWidth,
+  GLsizei                     aHeight,
+  GLenum                      aFormat,
+  GLenum                      aType,
+  const void*                 aPixels
+);
+
+void __wrap_glTexParameteri
+(
+  GLenum                      aTarget,
+  GLenum                      aName,
+  GLint                       aParam
+);
+
+void __wrap_glDeleteTextures
+(
+  GLsizei                     aCount,
+  const GLuint*               aTextures
+);
+
+void __wrap_glFlush
+(
+  void
+);
+
+void __wrap_glFinish
+(
+  void
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* GPU_BATCH_H */
+
+
+/* msy */
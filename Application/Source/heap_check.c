@@ -0,0 +1,311 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides the memory of the Embedded Wizard heap manager to
+*   the Runtime Environment and Graphics Engine and checks the integrity of
+*   the heap according to the selected mode.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "gc_scheduler.h"
+#include "heap_check.h"
+
+#ifndef EW_HEAP_CHECK_MODE
+  #define EW_HEAP_CHECK_MODE          HEAP_CHECK_SAMPLED
+#endif
+
+#ifndef EW_HEAP_CHECK_INTERVAL
+  #define EW_HEAP_CHECK_INTERVAL      60
+#endif
+
+/* number of memory pools and recent allocations */
+#define NO_OF_POOLS                   2
+#define NO_OF_ALLOCATIONS             16
+
+/* the original functions of the Runtime Environment */
+void* __real_EwAlloc( int aSize );
+void  __real_EwFree( void* aMemory );
+
+typedef struct
+{
+  char*         Start;
+  char*         End;
+} XPool;
+
+typedef struct
+{
+  void*         Memory;    /* address of the allocated memory block */
+  void*         Caller;    /* return address of the EwAlloc() call */
+  int           Size;      /* size of the memory block in bytes */
+  unsigned int  Frame;     /* frame number of the allocation */
+} XAllocation;
+
+static int          Mode = HEAP_CHECK_OFF;
+static XPool        Pools[ NO_OF_POOLS ];
+static int          NoOfPools = 0;
+static int          UsePools  = 0;  /* EwAlloc() takes the memory from the pools */
+static XAllocation  Allocations[ NO_OF_ALLOCATIONS ];
+static unsigned int NoOfAllocations = 0;
+static unsigned int Frame = 0;
+static unsigned int VerifiedFrame = 0; /* last frame with a coherent heap */
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to find out whether the memory belongs to a memory pool
+ */
+static int IsPoolMemory( void* aMemory )
+{
+  int i;
+
+  for ( i = 0; i < NoOfPools; i++ )
+    if (((char*)aMemory >= Pools[ i ].Start ) && ((char*)aMemory < Pools[ i ].End ))
+      return 1;
+
+  return 0;
+}
+
+
+/*
+ * helper function to report a heap corruption with the recent allocations
+ */
+static void ReportCorruption( void )
+{
+  unsigned int count = ( NoOfAllocations < NO_OF_ALLOCATIONS ) ? NoOfAllocations : NO_OF_ALLOCATIONS;
+  unsigned int i;
+  XAllocation* allocation;
+
+  EwPrint( "HeapCheck: Heap corrupted in frame %u (last coherent in frame %u)!\n",
+    Frame, VerifiedFrame );
+  EwPrint( "HeapCheck: Recent allocations (resolve callers with addr2line):\n" );
+
+  for ( i = 0; i < count; i++ )
+  {
+    allocation = &Allocations[ ( NoOfAllocations - count + i ) % NO_OF_ALLOCATIONS ];
+
+    EwPrint( "  frame %6u  %8d bytes at %p  caller %p\n", allocation->Frame,
+      allocation->Size, allocation->Memory, allocation->Caller );
+  }
+
+  EwDumpHeap( 0 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckInit
+*
+* DESCRIPTION:
+*   The function HeapCheckInit selects the mode of the heap verification and
+*   resets the recorded allocations. It has to be called before the memory
+*   pools are registered.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckInit( void )
+{
+  /* the names in the order of HEAP_CHECK_OFF .. HEAP_CHECK_FULL */
+  static const char* const modes[] = { "off", "sampled", "full", NULL };
+
+  Mode = EwGetEnvOption( "EW_HEAP_CHECK", modes, EW_HEAP_CHECK_MODE );
+
+  NoOfPools       = 0;
+  UsePools        = 0;
+  NoOfAllocations = 0;
+  Frame           = 0;
+  VerifiedFrame   = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckDone
+*
+* DESCRIPTION:
+*   The function HeapCheckDone stops the allocation from the memory pools. It
+*   has to be called before the heap manager is deinitialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckDone( void )
+{
+  UsePools = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckAddPool
+*
+* DESCRIPTION:
+*   The function HeapCheckAddPool registers a memory area, that has been added
+*   to the heap manager by EwAddHeapMemoryPool(). Afterwards EwAlloc() takes
+*   the memory from the heap manager.
+*
+* ARGUMENTS:
+*   aAddress - The start address of the memory area.
+*   aSize    - The size of the memory area in bytes.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckAddPool( void* aAddress, long aSize )
+{
+  if ( NoOfPools >= NO_OF_POOLS )
+    return;
+
+  Pools[ NoOfPools ].Start = (char*)aAddress;
+  Pools[ NoOfPools ].End   = (char*)aAddress + aSize;
+  NoOfPools++;
+  UsePools = 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckProcess
+*
+* DESCRIPTION:
+*   The function HeapCheckProcess has to be called after every processed frame.
+*   Depending on the selected mode, the heap is verified. If a corruption is
+*   found, the frame number and the recent allocations are reported.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 0 if a corruption has been found, 1 otherwise.
+*
+*******************************************************************************/
+int HeapCheckProcess( void )
+{
+  Frame++;
+
+  if (( Mode == HEAP_CHECK_OFF ) ||
+     (( Mode == HEAP_CHECK_SAMPLED ) && ( Frame % EW_HEAP_CHECK_INTERVAL )))
+    return 1;
+
+  if ( !EwVerifyHeap())
+  {
+    ReportCorruption();
+    return 0;
+  }
+
+  VerifiedFrame = Frame;
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwAlloc
+*
+* DESCRIPTION:
+*   The function __wrap_EwAlloc replaces EwAlloc() of the Runtime Environment.
+*   The memory is taken from the registered memory pools or, if not available,
+*   from the system heap. The allocation is recorded for the heap check.
+*
+* ARGUMENTS:
+*   aSize - Desired size of the new memory block in bytes.
+*
+* RETURN VALUE:
+*   Returns a pointer to the reserved memory block or NULL if there is no
+*   memory available.
+*
+*******************************************************************************/
+void* __wrap_EwAlloc( int aSize )
+{
+  void*        memory = UsePools ? EwAllocHeapBlock( aSize ) : 0;
+  XAllocation* allocation;
+
+  /* the memory pools are exhausted - continue with the system heap */
+  if ( !memory )
+    memory = __real_EwAlloc( aSize );
+
+  /* the new memory block is potential garbage */
+  if ( memory )
+    GcSchedulerCountAlloc( aSize );
+
+  if ( Mode != HEAP_CHECK_OFF )
+  {
+    allocation = &Allocations[ NoOfAllocations++ % NO_OF_ALLOCATIONS ];
+    allocation->Memory = memory;
+    allocation->Caller = __builtin_return_address( 0 );
+    allocation->Size   = aSize;
+    allocation->Frame  = Frame;
+  }
+
+  return memory;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwFree
+*
+* DESCRIPTION:
+*   The function __wrap_EwFree replaces EwFree() of the Runtime Environment and
+*   releases the memory block to the memory pool or system heap it was taken
+*   from.
+*
+* ARGUMENTS:
+*   aMemory - Address of the memory block to release.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwFree( void* aMemory )
+{
+  /* after the deinitialization of the heap manager, the memory pools are not
+     accessed anymore */
+  if ( !IsPoolMemory( aMemory ))
+    __real_EwFree( aMemory );
+  else if ( UsePools )
+    EwFreeHeapBlock( aMemory );
+}
+
+
+/* msy */
@@ -0,0 +1,204 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides the memory of the Embedded Wizard heap manager to
+*   the Runtime Environment and Graphics Engine and checks the integrity of
+*   the heap. The functions EwAlloc() and EwFree() are redirected by the linker
+*   (option --wrap) to __wrap_EwAlloc() and __wrap_EwFree(). They allocate the
+*   memory from the registered memory pools and continue with the system heap,
+*   if the pools are exhausted. The recent allocations are recorded in order
+*   to report them in case of a heap corruption.
+*
+*   The heap verification is selected by EW_HEAP_CHECK_MODE or at runtime by
+*   the environment variable EW_HEAP_CHECK ("off", "sampled" or "full"):
+*
+*   HEAP_CHECK_OFF     - The heap is not verified.
+*   HEAP_CHECK_SAMPLED - The heap is verified every EW_HEAP_CHECK_INTERVAL-th
+*     frame. Corruptions are detected with a delay, but without a heap walk
+*     per frame.
+*   HEAP_CHECK_FULL    - The heap is verified after every frame.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef HEAP_CHECK_H
+#define HEAP_CHECK_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/* modes of the heap verification */
+#define HEAP_CHECK_OFF                0
+#define HEAP_CHECK_SAMPLED            1
+#define HEAP_CHECK_FULL               2
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckInit
+*
+* DESCRIPTION:
+*   The function HeapCheckInit selects the mode of the heap verification and
+*   resets the recorded allocations. It has to be called before the memory
+*   pools are registered.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckDone
+*
+* DESCRIPTION:
+*   The function HeapCheckDone stops the allocation from the memory pools. It
+*   has to be called before the heap manager is deinitialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckAddPool
+*
+* DESCRIPTION:
+*   The function HeapCheckAddPool registers a memory area, that has been added
+*   to the heap manager by EwAddHeapMemoryPool(). Afterwards EwAlloc() takes
+*   the memory from the heap manager.
+*
+* ARGUMENTS:
+*   aAddress - The start address of the memory area.
+*   aSize    - The size of the memory area in bytes.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void HeapCheckAddPool
+(
+  void*                       aAddress,
+  long                        aSize
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   HeapCheckProcess
+*
+* DESCRIPTION:
+*   The function HeapCheckProcess has to be called after every processed frame.
+*   Depending on the selected mode, the heap is verified. If a corruption is
+*   found, the frame number and the recent allocations are reported.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 0 if a corruption has been found, 1 otherwise.
+*
+*******************************************************************************/
+int HeapCheckProcess
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwAlloc
+*
+* DESCRIPTION:
+*   The function __wrap_EwAlloc replaces EwAlloc() of the Runtime Environment.
+*   The memory is taken from the registered memory pools or, if not available,
+*   from the system heap. The allocation is recorded for the heap check.
+*
+* ARGUMENTS:
+*   aSize - Desired size of the new memory block in bytes.
+*
+* RETURN VALUE:
+*   Returns a pointer to the reserved memory block or NULL if there is no
+*   memory available.
+*
+*******************************************************************************/
+void* __wrap_EwAlloc
+(
+  int                         aSize
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwFree
+*
+* DESCRIPTION:
+*   The function __wrap_EwFree replaces EwFree() of the Runtime Environment and
+*   releases the memory block to the memory pool or system heap it was taken
+*   from.
+*
+* ARGUMENTS:
+*   aMemory - Address of the memory block to release.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwFree
+(
+  void*                       aMemory
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* HEAP_CHECK_H */
+
+
+/* msy */
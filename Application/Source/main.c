@@ -41,7 +41,9 @@
 #include "ewrte.h"
 #include "ew_bsp_console.h"
 
+#include "boot_trace.h"
 #include "gfx_system_drm.h"
+#include "gfx_system_headless.h"
 
 /*******************************************************************************
 * FUNCTION:
@@ -50,6 +52,9 @@
 * DESCRIPTION:
 *   The main function for running Embedded Wizard generated GUI applications on
 *   a dedicated target using the Linux operating system.
+*   If the environment variable EW_HEADLESS is set, the GUI application runs
+*   without display (see gfx_system_headless.h). Otherwise, the boot splash
+*   is shown until the first frame is ready (see GfxSystemShowSplash()).
 *
 * ARGUMENTS:
 *   None
@@ -60,11 +65,38 @@
 *******************************************************************************/
 int main( void )
 {
+  int headless;
+  int bootPhase;
+
+  /* the boot trace records the startup until the first frame is shown */
+  BootTraceInit();
+  headless = HeadlessSystemIsEnabled();
+
   /* initialize console interface for debug messages */
+  bootPhase = BootTraceBegin( "Console" );
   EwBspConsoleInit();
+  BootTraceEnd( bootPhase );
 
   /* initialize the graphics subsystem */
-  GfxSystemInit( FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT );
+  bootPhase = BootTraceBegin( "Graphics subsystem" );
+
+  if ( headless )
+  {
+    if ( !HeadlessSystemInit( FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT ))
+    {
+      EwPrint( "Cannot initialize the headless graphics subsystem!\n" );
+      EwBspConsoleDone();
+      return 1;
+    }
+  }
+  else if ( GfxSystemInit( FRAME_BUFFER_WIDTH, FRAME_BUFFER_HEIGHT ))
+  {
+    BootTraceEnd( bootPhase );
+    bootPhase = BootTraceBegin( "Boot splash" );
+    GfxSystemShowSplash();
+  }
+
+  BootTraceEnd( bootPhase );
 
   /* initialize Embedded Wizard application */
   if ( EwInit() == 0 )
@@ -73,14 +105,21 @@ int main( void )
   EwPrintSystemInfo();
 
   /* process the graphics subsystem and the Embedded Wizard main loop */
-  while( GfxSystemProcess() && EwProcess())
+  while(( headless ? HeadlessSystemProcess() : GfxSystemProcess()) && EwProcess())
     ;
 
+  /* keep the final frame as boot splash for the next start */
+  if ( !headless )
+    GfxSystemSaveSplash();
+
   /* de-initialize Embedded Wizard application */
   EwDone();
 
   /* de-initialize graphics subsystem */
-  GfxSystemDone();
+  if ( headless )
+    HeadlessSystemDone();
+  else
+    GfxSystemDone();
 
   /* restore console */
   EwBspConsoleDone();
@@ -0,0 +1,486 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template removes the hidden parts of the drawing tasks, before they
+*   are executed. The Graphics Engine eliminates only the tasks behind the
+*   front-most opaque task of an issue - with layered screens the overdraw
+*   remains high, e.g. a gradient is drawn completely and then covered by a
+*   full screen image.
+*
+*   After the original elimination, the tasks of every issue are evaluated from
+*   the front to the back. The area of the tasks covering their area entirely
+*   opaque is collected - the opaque parts of the bitmaps, the opaque bitmaps
+*   drawn without blending (see opaque_bitmap.h) and the fills with opaque
+*   colors. Up to MAX_OCCLUDERS of the largest areas are kept. A task within
+*   one of these areas is hidden and removed. A task partly hidden by an area
+*   covering its entire width or height is clipped.
+*
+*   The number of hidden and clipped tasks and the drawn pixel - as overdraw
+*   factor of the area affected by the issues - are counted per frame and
+*   printed every EW_OCCLUSION_REPORT_FRAMES frames and on shutdown.
+*
+*   The functions EwEliminateTasks() and EwExecuteTasks() are redirected by the
+*   linker (option --wrap) to the respective __wrap_ functions.
+*
+*   The culling is selected by EW_OCCLUSION_CULLING or at runtime by the
+*   environment variable EW_OCCLUSION_CULLING ("off" or "on"). Without culling,
+*   the overdraw is only counted.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "ewgfxtasks.h"
+#include "opaque_bitmap.h"
+#include "occlusion.h"
+
+#ifndef EW_OCCLUSION_CULLING
+  #define EW_OCCLUSION_CULLING        1
+#endif
+
+#ifndef EW_OCCLUSION_REPORT_FRAMES
+  #define EW_OCCLUSION_REPORT_FRAMES  600
+#endif
+
+/* number of collected opaque areas and their minimum width and height */
+#define MAX_OCCLUDERS                 16
+#define MIN_OCCLUDER_SIZE             16
+
+/* the original functions of the Graphics Engine */
+void __real_EwEliminateTasks( XIssue* aIssue );
+void __real_EwExecuteTasks( XIssue* aIssue );
+
+typedef struct
+{
+  int           X1;
+  int           Y1;
+  int           X2;
+  int           Y2;
+} XOccluder;
+
+typedef struct
+{
+  unsigned int        Tasks;     /* tasks after the original elimination */
+  unsigned int        Hidden;    /* removed tasks */
+  unsigned int        Clipped;   /* partly hidden tasks */
+  unsigned long long  Area;      /* area affected by the issues in pixel */
+  unsigned long long  Requested; /* pixel of the tasks before the culling */
+  unsigned long long  Drawn;     /* pixel of the tasks after the culling */
+} XOcclusionStatistic;
+
+static int                 Enabled = 0;
+static XOccluder           Occluders[ MAX_OCCLUDERS ];
+static int                 NoOfOccluders;
+
+/* statistic of the overdraw */
+static XOcclusionStatistic Frame;
+static XOcclusionStatistic Period;
+static XOcclusionStatistic Total;
+static unsigned int        NoOfFrames;
+static unsigned int        NoOfPeriodFrames;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the size of the task area in pixel
+ */
+static unsigned int GetArea( XTask* aTask )
+{
+  if (( aTask->X2 <= aTask->X1 ) || ( aTask->Y2 <= aTask->Y1 ))
+    return 0;
+
+  return ( aTask->X2 - aTask->X1 ) * ( aTask->Y2 - aTask->Y1 );
+}
+
+
+/*
+ * helper function to get the size of an occluder in pixel
+ */
+static unsigned int GetOccluderArea( XOccluder* aOccluder )
+{
+  return ( aOccluder->X2 - aOccluder->X1 ) * ( aOccluder->Y2 - aOccluder->Y1 );
+}
+
+
+/*
+ * helper function to find out whether a task covers its entire area with
+ * opaque pixel - the alpha blending of opaque colors has no effect
+ */
+static int IsOccluder( XTask* aTask )
+{
+  XFillRectangle* fill = (XFillRectangle*)aTask->Data;
+  int             i;
+
+  if ( !( aTask->Flags & EW_TASK_ENTIRE_AREA ) ||
+     (( aTask->X2 - aTask->X1 ) < MIN_OCCLUDER_SIZE ) ||
+     (( aTask->Y2 - aTask->Y1 ) < MIN_OCCLUDER_SIZE ))
+    return 0;
+
+  if ( !( aTask->Flags & EW_TASK_ALPHABLEND ))
+    return 1;
+
+  if ( aTask->Token != EW_TASKID_FILL_RECTANGLE )
+    return 0;
+
+  for ( i = 0; i < 4; i++ )
+    if (( fill->Colors[ i ] >> 24 ) != 0xFF )
+      return 0;
+
+  return 1;
+}
+
+
+/*
+ * helper function to keep the area of an occluding task - if all entries are
+ * used, the smallest area is replaced
+ */
+static void AddOccluder( XTask* aTask )
+{
+  XOccluder* occluder = &Occluders[ 0 ];
+  int        i;
+
+  if ( NoOfOccluders < MAX_OCCLUDERS )
+    occluder = &Occluders[ NoOfOccluders++ ];
+  else
+  {
+    for ( i = 1; i < MAX_OCCLUDERS; i++ )
+      if ( GetOccluderArea( &Occluders[ i ]) < GetOccluderArea( occluder ))
+        occluder = &Occluders[ i ];
+
+    if ( GetOccluderArea( occluder ) >= GetArea( aTask ))
+      return;
+  }
+
+  occluder->X1 = aTask->X1;
+  occluder->Y1 = aTask->Y1;
+  occluder->X2 = aTask->X2;
+  occluder->Y2 = aTask->Y2;
+}
+
+
+/*
+ * helper function to remove the parts of a task hidden by the occluders - the
+ * area of a hidden task is made empty. Returns 1 if the task area has been
+ * changed.
+ */
+static int CullTask( XTask* aTask )
+{
+  XOccluder* occluder;
+  int        changed = 0;
+  int        i;
+
+  for ( i = 0; ( i < NoOfOccluders ) && GetArea( aTask ); i++ )
+  {
+    occluder = &Occluders[ i ];
+
+    /* the occluder does not overlap the task */
+    if (( occluder->X1 >= aTask->X2 ) || ( occluder->X2 <= aTask->X1 ) ||
+        ( occluder->Y1 >= aTask->Y2 ) || ( occluder->Y2 <= aTask->Y1 ))
+      continue;
+
+    /* the occluder covers the entire width of the task - clip the top or the
+       bottom edge */
+    if (( occluder->X1 <= aTask->X1 ) && ( occluder->X2 >= aTask->X2 ))
+    {
+      if (( occluder->Y1 <= aTask->Y1 ) && ( occluder->Y2 >= aTask->Y2 ))
+        aTask->Y2 = aTask->Y1;
+      else if ( occluder->Y1 <= aTask->Y1 )
+        aTask->Y1 = occluder->Y2;
+      else if ( occluder->Y2 >= aTask->Y2 )
+        aTask->Y2 = occluder->Y1;
+      else
+        continue;
+
+      changed = 1;
+    }
+
+    /* the occluder covers the entire height of the task - clip the left or
+       the right edge */
+    else if (( occluder->Y1 <= aTask->Y1 ) && ( occluder->Y2 >= aTask->Y2 ))
+    {
+      if ( occluder->X1 <= aTask->X1 )
+        aTask->X1 = occluder->X2;
+      else if ( occluder->X2 >= aTask->X2 )
+        aTask->X2 = occluder->X1;
+      else
+        continue;
+
+      changed = 1;
+    }
+  }
+
+  return changed;
+}
+
+
+/*
+ * helper function to add the counted values of a frame to the statistic
+ */
+static void AddStatistic( XOcclusionStatistic* aSum, XOcclusionStatistic* aFrame )
+{
+  aSum->Tasks     += aFrame->Tasks;
+  aSum->Hidden    += aFrame->Hidden;
+  aSum->Clipped   += aFrame->Clipped;
+  aSum->Area      += aFrame->Area;
+  aSum->Requested += aFrame->Requested;
+  aSum->Drawn     += aFrame->Drawn;
+}
+
+
+/*
+ * helper function to print the average values per frame - the overdraw is
+ * printed in hundredths
+ */
+static void PrintStatistic( const char* aTitle, XOcclusionStatistic* aSum,
+  unsigned int aFrames )
+{
+  unsigned int requested;
+  unsigned int drawn;
+
+  if ( !aFrames || !aSum->Area )
+    return;
+
+  requested = (unsigned int)( aSum->Requested * 100 / aSum->Area );
+  drawn     = (unsigned int)( aSum->Drawn * 100 / aSum->Area );
+
+  EwPrint( "Occlusion: %s %u frames, per frame: %u tasks, %u hidden, %u clipped, "
+    "%u kpixel drawn, overdraw %u.%02u (without culling %u.%02u)\n", aTitle,
+    aFrames, aSum->Tasks / aFrames, aSum->Hidden / aFrames, aSum->Clipped / aFrames,
+    (unsigned int)( aSum->Drawn / aFrames / 1000 ), drawn / 100, drawn % 100,
+    requested / 100, requested % 100 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionInit
+*
+* DESCRIPTION:
+*   The function OcclusionInit selects whether the hidden tasks are removed and
+*   resets the statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionInit( void )
+{
+  Enabled = EwGetEnvSwitch( "EW_OCCLUSION_CULLING", EW_OCCLUSION_CULLING );
+
+  memset( &Frame,  0, sizeof( Frame ));
+  memset( &Period, 0, sizeof( Period ));
+  memset( &Total,  0, sizeof( Total ));
+  NoOfFrames       = 0;
+  NoOfPeriodFrames = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionDone
+*
+* DESCRIPTION:
+*   The function OcclusionDone prints the statistic of all frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionDone( void )
+{
+  PrintStatistic( "all", &Total, NoOfFrames );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionEndFrame
+*
+* DESCRIPTION:
+*   The function OcclusionEndFrame has to be called after a frame has been
+*   drawn. The counted tasks and pixel are added to the statistic and printed
+*   every EW_OCCLUSION_REPORT_FRAMES frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionEndFrame( void )
+{
+  AddStatistic( &Period, &Frame );
+  AddStatistic( &Total, &Frame );
+  memset( &Frame, 0, sizeof( Frame ));
+
+  NoOfFrames++;
+  NoOfPeriodFrames++;
+
+  if (( EW_OCCLUSION_REPORT_FRAMES > 0 ) && ( NoOfPeriodFrames >= EW_OCCLUSION_REPORT_FRAMES ))
+  {
+    PrintStatistic( "last", &Period, NoOfPeriodFrames );
+    memset( &Period, 0, sizeof( Period ));
+    NoOfPeriodFrames = 0;
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwEliminateTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwEliminateTasks replaces EwEliminateTasks() of the
+*   Graphics Engine. After the original elimination, the tasks are evaluated
+*   from the front to the back and their hidden parts are removed.
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to eliminate.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwEliminateTasks( XIssue* aIssue )
+{
+  XTask* task;
+  int    x1 = 0x7FFF;
+  int    y1 = 0x7FFF;
+  int    x2 = -0x7FFF;
+  int    y2 = -0x7FFF;
+
+  /* the opaque bitmaps are drawn without blending - also the original
+     elimination takes them into account */
+  OpaqueBitmapPrepareTasks( aIssue );
+
+  __real_EwEliminateTasks( aIssue );
+
+  /* the pending tasks are stored from the front to the back */
+  NoOfOccluders = 0;
+
+  for ( task = aIssue->Tasks; task; task = task->Next )
+  {
+    if ( !GetArea( task ))
+      continue;
+
+    /* the area affected by the issue */
+    x1 = ( task->X1 < x1 ) ? task->X1 : x1;
+    y1 = ( task->Y1 < y1 ) ? task->Y1 : y1;
+    x2 = ( task->X2 > x2 ) ? task->X2 : x2;
+    y2 = ( task->Y2 > y2 ) ? task->Y2 : y2;
+
+    Frame.Tasks++;
+    Frame.Requested += GetArea( task );
+
+    if ( Enabled && CullTask( task ))
+    {
+      if ( GetArea( task ))
+        Frame.Clipped++;
+      else
+        Frame.Hidden++;
+    }
+
+    Frame.Drawn += GetArea( task );
+
+    if ( Enabled && GetArea( task ) && IsOccluder( task ))
+      AddOccluder( task );
+  }
+
+  if (( x2 > x1 ) && ( y2 > y1 ))
+    Frame.Area += ( x2 - x1 ) * ( y2 - y1 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwExecuteTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwExecuteTasks replaces EwExecuteTasks() of the
+*   Graphics Engine. The tasks with an empty area are not executed. Afterwards
+*   they are appended to the end of the list again, so their resources are
+*   released by EwCompleteTasks().
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to execute.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwExecuteTasks( XIssue* aIssue )
+{
+  XTask*  hidden = NULL;
+  XTask** tail   = &aIssue->Tasks;
+  XTask*  task   = aIssue->Tasks;
+  XTask*  next;
+
+  /* move the tasks with an empty area to an own list */
+  while ( task )
+  {
+    next = task->Next;
+
+    if ( !GetArea( task ))
+    {
+      task->Next = hidden;
+      hidden     = task;
+    }
+    else
+    {
+      *tail = task;
+      tail  = &task->Next;
+    }
+
+    task = next;
+  }
+
+  *tail = NULL;
+
+  __real_EwExecuteTasks( aIssue );
+
+  /* find the end of the list again - the executed tasks may be changed */
+  for ( tail = &aIssue->Tasks; *tail; tail = &(*tail)->Next )
+    ;
+
+  *tail = hidden;
+}
+
+
+/* msy */
@@ -0,0 +1,183 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template removes the hidden parts of the drawing tasks, before they
+*   are executed. The Graphics Engine eliminates only the tasks behind the
+*   front-most opaque task of an issue - with layered screens the overdraw
+*   remains high, e.g. a gradient is drawn completely and then covered by a
+*   full screen image.
+*
+*   After the original elimination, the tasks of every issue are evaluated from
+*   the front to the back. The area of the tasks covering their area entirely
+*   opaque is collected - the opaque parts of the bitmaps, the opaque bitmaps
+*   drawn without blending (see opaque_bitmap.h) and the fills with opaque
+*   colors. Up to MAX_OCCLUDERS of the largest areas are kept. A task within
+*   one of these areas is hidden and removed. A task partly hidden by an area
+*   covering its entire width or height is clipped.
+*
+*   The number of hidden and clipped tasks and the drawn pixel - as overdraw
+*   factor of the area affected by the issues - are counted per frame and
+*   printed every EW_OCCLUSION_REPORT_FRAMES frames and on shutdown.
+*
+*   The functions EwEliminateTasks() and EwExecuteTasks() are redirected by the
+*   linker (option --wrap) to the respective __wrap_ functions.
+*
+*   The culling is selected by EW_OCCLUSION_CULLING or at runtime by the
+*   environment variable EW_OCCLUSION_CULLING ("off" or "on"). Without culling,
+*   the overdraw is only counted.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+struct XIssue;
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionInit
+*
+* DESCRIPTION:
+*   The function OcclusionInit selects whether the hidden tasks are removed and
+*   resets the statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionDone
+*
+* DESCRIPTION:
+*   The function OcclusionDone prints the statistic of all frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OcclusionEndFrame
+*
+* DESCRIPTION:
+*   The function OcclusionEndFrame has to be called after a frame has been
+*   drawn. The counted tasks and pixel are added to the statistic and printed
+*   every EW_OCCLUSION_REPORT_FRAMES frames.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OcclusionEndFrame
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwEliminateTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwEliminateTasks replaces EwEliminateTasks() of the
+*   Graphics Engine. After the original elimination, the tasks are evaluated
+*   from the front to the back and their hidden parts are removed.
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to eliminate.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwEliminateTasks
+(
+  struct XIssue*              aIssue
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwExecuteTasks
+*
+* DESCRIPTION:
+*   The function __wrap_EwExecuteTasks replaces EwExecuteTasks() of the
+*   Graphics Engine. The tasks with an empty area are not executed. Afterwards
+*   they are appended to the end of the list again, so their resources are
+*   released by EwCompleteTasks().
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to execute.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwExecuteTasks
+(
+  struct XIssue*              aIssue
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* OCCLUSION_H */
+
+
+/* msy */
@@ -0,0 +1,350 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template stores the opaque bitmap resources in the RGB565 format.
+*   Otherwise, every bitmap resource is loaded as RGBA8888 texture - even if
+*   the opaque area of its frames covers the entire frame, e.g. the full screen
+*   backgrounds. With half of the bytes per pixel, such textures need half of
+*   the memory bandwidth, when they are drawn.
+*
+*   After a bitmap resource has been loaded by EwLoadBitmap() (see the wrapper
+*   in texture_atlas.c), its frames are verified. If all frames are entirely
+*   opaque, a new bitmap in the RGB565 format is created - its surfaces are
+*   provided by the RGB565 surface functions of the OpenGL adaptation. The
+*   pixel are converted with an ordered dithering, so gradients do not show
+*   bands. Afterwards the original bitmap is released.
+*
+*   The copy, tile and warp tasks of RGB565 bitmaps are performed without
+*   blending, unless the pixel are modulated by a translucent color. The
+*   number of converted bitmaps and the saved texture memory are printed on
+*   shutdown.
+*
+*   The conversion is selected by EW_OPAQUE_BITMAPS or at runtime by the
+*   environment variable EW_OPAQUE_BITMAPS ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "ewextpxl_RGBA8888.h"
+#include "ewgfxtasks.h"
+#include "opaque_bitmap.h"
+
+#ifndef EW_OPAQUE_BITMAPS
+  #define EW_OPAQUE_BITMAPS           1
+#endif
+
+/* threshold matrix of the ordered dithering */
+static const unsigned char Dither[ 4 ][ 4 ] =
+{
+  {  0,  8,  2, 10 },
+  { 12,  4, 14,  6 },
+  {  3, 11,  1,  9 },
+  { 15,  7, 13,  5 }
+};
+
+static int          Enabled = 0;
+
+/* statistic of the conversion */
+static unsigned int NoOfBitmaps;
+static unsigned int NoOfSavedBytes;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to find out whether all frames of a bitmap are entirely
+ * opaque
+ */
+static int IsOpaque( XBitmap* aBitmap )
+{
+  XRect rect;
+  int   i;
+
+  for ( i = 0; i < aBitmap->NoOfFrames; i++ )
+  {
+    rect = aBitmap->Frames[ i ].OpaqueRect;
+
+    if (( rect.Point1.X > 0 ) || ( rect.Point1.Y > 0 ) ||
+        ( rect.Point2.X < aBitmap->FrameSize.X ) ||
+        ( rect.Point2.Y < aBitmap->FrameSize.Y ))
+      return 0;
+  }
+
+  return 1;
+}
+
+
+/*
+ * helper function to reduce a color channel to the given number of bits -
+ * the remainder is compared with the dithering threshold
+ */
+static unsigned int ReduceChannel( unsigned int aValue, int aBits, int aThreshold )
+{
+  unsigned int value = aValue * (( 1 << aBits ) - 1 ) * 16 / 255;
+
+  return ( value >> 4 ) + (( value & 15 ) > (unsigned int)aThreshold );
+}
+
+
+/*
+ * helper function to convert the pixel of a frame from the native format to
+ * the RGB565 format
+ */
+static void ConvertFrame( XBitmapLock* aSrc, XBitmapLock* aDst, int aWidth,
+  int aHeight )
+{
+  unsigned int*   src;
+  unsigned short* dst;
+  unsigned int    pixel;
+  int             threshold;
+  int             x;
+  int             y;
+
+  for ( y = 0; y < aHeight; y++ )
+  {
+    src = (unsigned int*)((char*)aSrc->Pixel1 + y * aSrc->Pitch1Y );
+    dst = (unsigned short*)((char*)aDst->Pixel1 + y * aDst->Pitch1Y );
+
+    for ( x = 0; x < aWidth; x++ )
+    {
+      pixel     = src[ x ];
+      threshold = Dither[ y & 3 ][ x & 3 ];
+
+      dst[ x ] = (unsigned short)(
+        ( ReduceChannel(( pixel >> EW_COLOR_CHANNEL_BIT_OFFSET_RED   ) & 0xFF, 5,
+          threshold ) << EW_RGB565_COLOR_CHANNEL_BIT_OFFSET_RED   ) |
+        ( ReduceChannel(( pixel >> EW_COLOR_CHANNEL_BIT_OFFSET_GREEN ) & 0xFF, 6,
+          threshold ) << EW_RGB565_COLOR_CHANNEL_BIT_OFFSET_GREEN ) |
+        ( ReduceChannel(( pixel >> EW_COLOR_CHANNEL_BIT_OFFSET_BLUE  ) & 0xFF, 5,
+          threshold ) << EW_RGB565_COLOR_CHANNEL_BIT_OFFSET_BLUE  ));
+    }
+  }
+}
+
+
+/*
+ * helper function to find out whether the task modulates the pixel with a
+ * translucent color
+ */
+static int IsTranslucent( XTask* aTask, unsigned int* aColors )
+{
+  int mode = aTask->Flags & EW_TASK_LINEAR_GRADIENT;
+  int i;
+
+  if ( mode == EW_TASK_SOLID )
+    return ( aColors[ 0 ] >> 24 ) != 0xFF;
+
+  for ( i = 0; mode && ( i < 4 ); i++ )
+    if (( aColors[ i ] >> 24 ) != 0xFF )
+      return 1;
+
+  return 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapInit
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapInit selects whether the opaque bitmap resources
+*   are stored in the RGB565 format and resets the statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapInit( void )
+{
+  Enabled = EwGetEnvSwitch( "EW_OPAQUE_BITMAPS", EW_OPAQUE_BITMAPS );
+
+  NoOfBitmaps    = 0;
+  NoOfSavedBytes = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapDone
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapDone prints the number of converted bitmaps and
+*   the saved texture memory.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapDone( void )
+{
+  if ( Enabled )
+    EwPrint( "OpaqueBitmap: %u bitmaps stored as RGB565, %u KB texture memory "
+      "saved\n", NoOfBitmaps, NoOfSavedBytes / 1024 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapConvert
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapConvert verifies whether all frames of a loaded
+*   bitmap are entirely opaque. In this case, a new bitmap in the RGB565 format
+*   is created with the converted pixel and the given bitmap is released.
+*
+* ARGUMENTS:
+*   aBitmap - Bitmap loaded by EwLoadBitmap() or NULL.
+*
+* RETURN VALUE:
+*   Returns the new RGB565 bitmap or aBitmap, if the bitmap is not converted.
+*
+*******************************************************************************/
+XBitmap* OpaqueBitmapConvert( XBitmap* aBitmap )
+{
+  XBitmap*     bitmap;
+  XBitmapLock* src;
+  XBitmapLock* dst;
+  XRect        area;
+  int          i;
+
+  /* the mapping of the virtual frames can not be taken over */
+  if ( !Enabled || !aBitmap || ( aBitmap->Format != EW_PIXEL_FORMAT_NATIVE ) ||
+       aBitmap->Mapping || !IsOpaque( aBitmap ))
+    return aBitmap;
+
+  bitmap = EwCreateBitmap( EW_PIXEL_FORMAT_RGB565, aBitmap->FrameSize,
+    aBitmap->FrameDelay, aBitmap->NoOfFrames );
+
+  if ( !bitmap )
+    return aBitmap;
+
+  area = EwNewRect( 0, 0, aBitmap->FrameSize.X, aBitmap->FrameSize.Y );
+
+  for ( i = 0; i < aBitmap->NoOfFrames; i++ )
+  {
+    src = EwLockBitmap( aBitmap, i, area, 1, 0 );
+    dst = src ? EwLockBitmap( bitmap, i, area, 0, 1 ) : NULL;
+
+    if ( dst )
+    {
+      ConvertFrame( src, dst, area.Point2.X, area.Point2.Y );
+      EwUnlockBitmap( dst );
+    }
+
+    if ( src )
+      EwUnlockBitmap( src );
+
+    /* the surface memory is exhausted - keep the original bitmap */
+    if ( !dst )
+    {
+      EwFreeBitmap( bitmap );
+      return aBitmap;
+    }
+
+    bitmap->Frames[ i ].OpaqueRect = area;
+  }
+
+  NoOfBitmaps++;
+  NoOfSavedBytes += aBitmap->NoOfFrames * area.Point2.X * area.Point2.Y * 2;
+
+  EwFreeBitmap( aBitmap );
+  return bitmap;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapPrepareTasks
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapPrepareTasks switches off the blending for the
+*   copy, tile and warp tasks with a RGB565 source surface, unless the pixel
+*   are modulated by a translucent color. It has to be called before the tasks
+*   of an issue are eliminated (see occlusion.c).
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to prepare.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapPrepareTasks( struct XIssue* aIssue )
+{
+  XTask*        task;
+  XSurface*     surface;
+  unsigned int* colors;
+
+  if ( !Enabled )
+    return;
+
+  for ( task = aIssue->Tasks; task; task = task->Next )
+  {
+    if ( !( task->Flags & EW_TASK_ALPHABLEND ) || ( task->Flags & EW_TASK_EMULATION ))
+      continue;
+
+    switch ( task->Token )
+    {
+      case EW_TASKID_COPY_SURFACE :
+        surface = ((XCopySurface*)task->Data )->Surface;
+        colors  = ((XCopySurface*)task->Data )->Colors;
+        break;
+
+      case EW_TASKID_TILE_SURFACE :
+        surface = ((XTileSurface*)task->Data )->Surface;
+        colors  = ((XTileSurface*)task->Data )->Colors;
+        break;
+
+      case EW_TASKID_WARP_PERSP_SURFACE  :
+      case EW_TASKID_WARP_AFFINE_SURFACE :
+      case EW_TASKID_WARP_SCALE_SURFACE  :
+        surface = ((XWarpSurface*)task->Data )->Surface;
+        colors  = ((XWarpSurface*)task->Data )->Colors;
+        break;
+
+      default :
+        continue;
+    }
+
+    if (( surface->Format == EW_PIXEL_FORMAT_RGB565 ) && !IsTranslucent( task, colors ))
+      task->Flags &= ~EW_TASK_ALPHABLEND;
+  }
+}
+
+
+/* msy */
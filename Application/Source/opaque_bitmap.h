@@ -0,0 +1,160 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template stores the opaque bitmap resources in the RGB565 format.
+*   Otherwise, every bitmap resource is loaded as RGBA8888 texture - even if
+*   the opaque area of its frames covers the entire frame, e.g. the full screen
+*   backgrounds. With half of the bytes per pixel, such textures need half of
+*   the memory bandwidth, when they are drawn.
+*
+*   After a bitmap resource has been loaded by EwLoadBitmap() (see the wrapper
+*   in texture_atlas.c), its frames are verified. If all frames are entirely
+*   opaque, a new bitmap in the RGB565 format is created - its surfaces are
+*   provided by the RGB565 surface functions of the OpenGL adaptation. The
+*   pixel are converted with an ordered dithering, so gradients do not show
+*   bands. Afterwards the original bitmap is released.
+*
+*   The copy, tile and warp tasks of RGB565 bitmaps are performed without
+*   blending, unless the pixel are modulated by a translucent color. The
+*   number of converted bitmaps and the saved texture memory are printed on
+*   shutdown.
+*
+*   The conversion is selected by EW_OPAQUE_BITMAPS or at runtime by the
+*   environment variable EW_OPAQUE_BITMAPS ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef OPAQUE_BITMAP_H
+#define OPAQUE_BITMAP_H
+
+#include "ewgfx.h"
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+struct XIssue;
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapInit
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapInit selects whether the opaque bitmap resources
+*   are stored in the RGB565 format and resets the statistic.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapDone
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapDone prints the number of converted bitmaps and
+*   the saved texture memory.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapConvert
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapConvert verifies whether all frames of a loaded
+*   bitmap are entirely opaque. In this case, a new bitmap in the RGB565 format
+*   is created with the converted pixel and the given bitmap is released.
+*
+* ARGUMENTS:
+*   aBitmap - Bitmap loaded by EwLoadBitmap() or NULL.
+*
+* RETURN VALUE:
+*   Returns the new RGB565 bitmap or aBitmap, if the bitmap is not converted.
+*
+*******************************************************************************/
+XBitmap* OpaqueBitmapConvert
+(
+  XBitmap*                    aBitmap
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OpaqueBitmapPrepareTasks
+*
+* DESCRIPTION:
+*   The function OpaqueBitmapPrepareTasks switches off the blending for the
+*   copy, tile and warp tasks with a RGB565 source surface, unless the pixel
+*   are modulated by a translucent color. It has to be called before the tasks
+*   of an issue are eliminated (see occlusion.c).
+*
+* ARGUMENTS:
+*   aIssue - Issue containing the tasks to prepare.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OpaqueBitmapPrepareTasks
+(
+  struct XIssue*              aIssue
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* OPAQUE_BITMAP_H */
+
+
+/* msy */
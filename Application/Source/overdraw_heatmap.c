@@ -0,0 +1,764 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides a debug mode visualizing the overdraw of the screen
+*   updates as heatmap. While the mode is active, the drawing operations of the
+*   viewports (see EwBeginUpdate() and EwEndUpdate()) are redirected into an
+*   offscreen buffer. Its stencil buffer is incremented by every drawn pixel,
+*   so after the update it contains the number of layers drawn per pixel.
+*
+*   Before the screen is flipped, the counts are translated into colors and
+*   drawn on the screen instead of the UI:
+*
+*     not drawn - black
+*     1 layer   - blue
+*     2 layers  - green
+*     3 layers  - yellow
+*     4 layers  - orange
+*     5 layers  - red
+*     6 layers  - magenta
+*     8 layers and more - white
+*
+*   The counts are read back to calculate the average overdraw factor - the
+*   drawn pixel divided by the pixel drawn at least once. The factor of the
+*   last frame is available by OverdrawHeatmapGetFactor() and the average is
+*   printed every EW_OVERDRAW_HEATMAP_REPORT_FRAMES frames. While the mode is
+*   active, every screen update redraws the entire screen.
+*
+*   Only the drawing operations into the framebuffer are counted - the content
+*   of buffered components is drawn once into offscreen bitmaps and counted
+*   as one layer, when it is copied to the screen.
+*
+*   The functions EwBeginUpdate() and EwBeginUpdateArea() are redirected by the
+*   linker (option --wrap) to the respective __wrap_ functions.
+*
+*   The mode is selected by EW_OVERDRAW_HEATMAP or at runtime by the environment
+*   variable EW_OVERDRAW_HEATMAP ("off" or "on") and toggled by SIGUSR2.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "gpu_batch.h"
+#include "overdraw_heatmap.h"
+
+#ifndef EW_OVERDRAW_HEATMAP
+  #define EW_OVERDRAW_HEATMAP         0
+#endif
+
+#ifndef EW_OVERDRAW_HEATMAP_REPORT_FRAMES
+  #define EW_OVERDRAW_HEATMAP_REPORT_FRAMES 60
+#endif
+
+/* number of distinguished layers - the deeper layers are counted as the last
+   one */
+#define MAX_LEVEL                     8
+
+/* the original functions of the Graphics Engine */
+XBitmap* __real_EwBeginUpdate( XViewport* aViewport );
+XBitmap* __real_EwBeginUpdateArea( XViewport* aViewport, XRect aArea );
+
+/* the full screen quad is drawn directly - the batching of the OpenGL
+   adaptation would take the vertices from its own client arrays */
+void __real_glVertexAttribPointer( GLuint aIndex, GLint aSize, GLenum aType,
+  GLboolean aNormalized, GLsizei aStride, const void* aPointer );
+void __real_glDrawArrays( GLenum aMode, GLint aFirst, GLsizei aCount );
+
+typedef struct
+{
+  unsigned long long  Area;      /* pixel of the screen */
+  unsigned long long  Touched;   /* pixel drawn at least once */
+  unsigned long long  Drawn;     /* drawn pixel of all layers */
+} XHeatmapStatistic;
+
+/* the heatmap is drawn with one full screen quad per layer, the layers are
+   selected by the stencil test */
+static const char* VertexShader =
+  "attribute vec2 aPosition;\n"
+  "varying vec2 vTexCoord;\n"
+  "void main()\n"
+  "{\n"
+  "  vTexCoord   = aPosition * 0.5 + 0.5;\n"
+  "  gl_Position = vec4( aPosition, 0.0, 1.0 );\n"
+  "}\n";
+
+static const char* FragmentShader =
+  "precision mediump float;\n"
+  "uniform sampler2D uTexture;\n"
+  "uniform int uLevel;\n"
+  "varying vec2 vTexCoord;\n"
+  "void main()\n"
+  "{\n"
+  "  float n = texture2D( uTexture, vTexCoord ).r * 255.0;\n"
+  "  vec3  c = vec3( 0.0 );\n"
+  "  if ( uLevel > 0 )\n"
+  "  {\n"
+  "    gl_FragColor = vec4( float( uLevel ) / 255.0, 0.0, 0.0, 1.0 );\n"
+  "    return;\n"
+  "  }\n"
+  "  if ( n > 0.5 ) c = vec3( 0.0, 0.0, 1.0 );\n"
+  "  if ( n > 1.5 ) c = vec3( 0.0, 1.0, 0.0 );\n"
+  "  if ( n > 2.5 ) c = vec3( 1.0, 1.0, 0.0 );\n"
+  "  if ( n > 3.5 ) c = vec3( 1.0, 0.5, 0.0 );\n"
+  "  if ( n > 4.5 ) c = vec3( 1.0, 0.0, 0.0 );\n"
+  "  if ( n > 5.5 ) c = vec3( 1.0, 0.0, 1.0 );\n"
+  "  if ( n > 7.5 ) c = vec3( 1.0, 1.0, 1.0 );\n"
+  "  gl_FragColor = vec4( c, 1.0 );\n"
+  "}\n";
+
+static const GLfloat Quad[] =
+{
+  -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f
+};
+
+static volatile sig_atomic_t ToggleRequest  = 0;
+static int                   Active         = 0;
+
+/* the offscreen buffer with the counts in its stencil buffer */
+static GLuint                Program        = 0;
+static GLint                 LevelUniform   = -1;
+static GLint                 TextureUniform = -1;
+static GLuint                Framebuffer    = 0;
+static GLuint                Texture        = 0;
+static GLuint                Renderbuffer   = 0;
+static int                   Width          = 0;
+static int                   Height         = 0;
+static unsigned char*        Pixels         = NULL;
+
+/* the viewport, whose update is currently counted */
+static XViewport*            Counting       = NULL;
+static int                   Factor         = 0;
+
+/* statistic of the overdraw */
+static XHeatmapStatistic     Period;
+static XHeatmapStatistic     Total;
+static unsigned int          NoOfFrames;
+static unsigned int          NoOfPeriodFrames;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * signal handler of SIGUSR2 - the mode is toggled by the GUI thread
+ */
+static void SignalHandler( int aSignal )
+{
+  /* suppress 'unused parameter' warnings */
+  (void)aSignal;
+
+  ToggleRequest = 1;
+}
+
+
+/*
+ * helper function to compile one shader of the heatmap program
+ */
+static GLuint CompileShader( GLenum aType, const char* aSource )
+{
+  GLuint shader = glCreateShader( aType );
+  GLint  status = GL_FALSE;
+
+  if ( !shader )
+    return 0;
+
+  glShaderSource( shader, 1, &aSource, NULL );
+  glCompileShader( shader );
+  glGetShaderiv( shader, GL_COMPILE_STATUS, &status );
+
+  if ( status != GL_TRUE )
+  {
+    glDeleteShader( shader );
+    return 0;
+  }
+
+  return shader;
+}
+
+
+/*
+ * helper function to create the program drawing the layers and the heatmap
+ */
+static int CreateProgram( void )
+{
+  GLuint vertexShader   = CompileShader( GL_VERTEX_SHADER, VertexShader );
+  GLuint fragmentShader = CompileShader( GL_FRAGMENT_SHADER, FragmentShader );
+  GLint  status         = GL_FALSE;
+
+  if ( vertexShader && fragmentShader )
+    Program = glCreateProgram();
+
+  if ( Program )
+  {
+    glAttachShader( Program, vertexShader );
+    glAttachShader( Program, fragmentShader );
+    glBindAttribLocation( Program, 0, "aPosition" );
+    glLinkProgram( Program );
+    glGetProgramiv( Program, GL_LINK_STATUS, &status );
+  }
+
+  /* the shaders are released together with the program */
+  if ( vertexShader )
+    glDeleteShader( vertexShader );
+  if ( fragmentShader )
+    glDeleteShader( fragmentShader );
+
+  if ( Program && ( status != GL_TRUE ))
+  {
+    glDeleteProgram( Program );
+    Program = 0;
+  }
+
+  if ( !Program )
+    return 0;
+
+  LevelUniform   = glGetUniformLocation( Program, "uLevel" );
+  TextureUniform = glGetUniformLocation( Program, "uTexture" );
+  return 1;
+}
+
+
+/*
+ * helper function to release the offscreen buffer
+ */
+static void ReleaseBuffer( void )
+{
+  if ( Framebuffer )
+    glDeleteFramebuffers( 1, &Framebuffer );
+  if ( Renderbuffer )
+    glDeleteRenderbuffers( 1, &Renderbuffer );
+  if ( Texture )
+    glDeleteTextures( 1, &Texture );
+
+  free( Pixels );
+
+  Framebuffer  = 0;
+  Renderbuffer = 0;
+  Texture      = 0;
+  Pixels       = NULL;
+  Width        = 0;
+  Height       = 0;
+}
+
+
+/*
+ * helper function to create the offscreen buffer with the given size - the
+ * color buffer is a texture, so it can be drawn on the screen
+ */
+static int CreateBuffer( int aWidth, int aHeight )
+{
+  GLint  texture     = 0;
+  GLint  framebuffer = 0;
+  GLenum status;
+
+  ReleaseBuffer();
+
+  Pixels = malloc((size_t)aWidth * aHeight * 4 );
+
+  if ( !Pixels )
+    return 0;
+
+  glGetIntegerv( GL_TEXTURE_BINDING_2D, &texture );
+  glGetIntegerv( GL_FRAMEBUFFER_BINDING, &framebuffer );
+
+  glGenTextures( 1, &Texture );
+  glBindTexture( GL_TEXTURE_2D, Texture );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, aWidth, aHeight, 0, GL_RGBA,
+    GL_UNSIGNED_BYTE, NULL );
+
+  glGenFramebuffers( 1, &Framebuffer );
+  glBindFramebuffer( GL_FRAMEBUFFER, Framebuffer );
+  glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+    Texture, 0 );
+
+  glGenRenderbuffers( 1, &Renderbuffer );
+  glBindRenderbuffer( GL_RENDERBUFFER, Renderbuffer );
+  glRenderbufferStorage( GL_RENDERBUFFER, GL_STENCIL_INDEX8, aWidth, aHeight );
+  glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+    GL_RENDERBUFFER, Renderbuffer );
+  status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+
+  /* many GPUs support the stencil buffer only combined with a depth buffer */
+  #ifdef GL_DEPTH24_STENCIL8_OES
+    if ( status != GL_FRAMEBUFFER_COMPLETE )
+    {
+      glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, aWidth, aHeight );
+      glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+        GL_RENDERBUFFER, Renderbuffer );
+      status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+    }
+  #endif
+
+  glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+  glBindTexture( GL_TEXTURE_2D, texture );
+
+  if ( status != GL_FRAMEBUFFER_COMPLETE )
+  {
+    ReleaseBuffer();
+    return 0;
+  }
+
+  Width  = aWidth;
+  Height = aHeight;
+  return 1;
+}
+
+
+/*
+ * helper function to draw the full screen quad with the given level - the
+ * collected vertices of the OpenGL adaptation have to be drawn before
+ */
+static void DrawQuad( int aLevel )
+{
+  glUniform1i( LevelUniform, aLevel );
+  __real_glVertexAttribPointer( 0, 2, GL_FLOAT, GL_FALSE, 0, Quad );
+  __real_glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+}
+
+
+/*
+ * helper function to evaluate the counts of the offscreen buffer - the red
+ * channel contains the number of layers
+ */
+static void CountLayers( void )
+{
+  unsigned long long touched = 0;
+  unsigned long long drawn   = 0;
+  int                count   = Width * Height;
+  int                i;
+
+  glReadPixels( 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, Pixels );
+
+  for ( i = 0; i < count; i++ )
+    if ( Pixels[ i * 4 ])
+    {
+      touched++;
+      drawn += Pixels[ i * 4 ];
+    }
+
+  Factor = touched ? (int)( drawn * 100 / touched ) : 0;
+
+  Period.Area    += count;
+  Period.Touched += touched;
+  Period.Drawn   += drawn;
+  Total.Area     += count;
+  Total.Touched  += touched;
+  Total.Drawn    += drawn;
+}
+
+
+/*
+ * helper function to print the average overdraw - the overdraw is printed in
+ * hundredths
+ */
+static void PrintStatistic( const char* aTitle, XHeatmapStatistic* aSum,
+  unsigned int aFrames )
+{
+  unsigned int touched;
+  unsigned int drawn;
+
+  if ( !aFrames || !aSum->Touched )
+    return;
+
+  touched = (unsigned int)( aSum->Touched * 100 / aSum->Area );
+  drawn   = (unsigned int)( aSum->Drawn * 100 / aSum->Touched );
+
+  EwPrint( "OverdrawHeatmap: %s %u frames, %u %% of the screen drawn, overdraw "
+    "%u.%02u\n", aTitle, aFrames, touched, drawn / 100, drawn % 100 );
+}
+
+
+/*
+ * helper function to start counting the drawing operations of a viewport
+ */
+static void BeginCounting( XViewport* aViewport )
+{
+  GLfloat color[ 4 ];
+  int     width  = aViewport->Surface.Width  ? aViewport->Surface.Width  : aViewport->Size.X;
+  int     height = aViewport->Surface.Height ? aViewport->Surface.Height : aViewport->Size.Y;
+
+  if ( !Program && !CreateProgram())
+  {
+    EwPrint( "OverdrawHeatmap: The heatmap program can not be created\n" );
+    Active = 0;
+    return;
+  }
+
+  if ((( width != Width ) || ( height != Height )) && !CreateBuffer( width, height ))
+  {
+    EwPrint( "OverdrawHeatmap: The offscreen buffer can not be created\n" );
+    Active = 0;
+    return;
+  }
+
+  /* from now on, the framebuffer of the screen is replaced */
+  GpuBatchFlush();
+  Counting = aViewport;
+  glBindFramebuffer( GL_FRAMEBUFFER, Framebuffer );
+
+  glGetFloatv( GL_COLOR_CLEAR_VALUE, color );
+  glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+  glClearStencil( 0 );
+  glClear( GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT );
+  glClearColor( color[ 0 ], color[ 1 ], color[ 2 ], color[ 3 ]);
+
+  /* every drawn pixel increments its count */
+  glEnable( GL_STENCIL_TEST );
+  glStencilFunc( GL_ALWAYS, 0, 0xFF );
+  glStencilOp( GL_KEEP, GL_INCR, GL_INCR );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapInit
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapInit selects whether the heatmap is shown,
+*   resets the statistic and installs the SIGUSR2 handler to toggle the mode.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapInit( void )
+{
+  struct sigaction action;
+
+  Active = EwGetEnvSwitch( "EW_OVERDRAW_HEATMAP", EW_OVERDRAW_HEATMAP );
+
+  ToggleRequest    = 0;
+  Counting         = NULL;
+  Factor           = 0;
+  NoOfFrames       = 0;
+  NoOfPeriodFrames = 0;
+
+  memset( &Period, 0, sizeof( Period ));
+  memset( &Total,  0, sizeof( Total ));
+
+  /* without SA_RESTART, a pending EwBspEventWait() returns on the signal */
+  memset( &action, 0, sizeof( action ));
+  action.sa_handler = SignalHandler;
+  sigemptyset( &action.sa_mask );
+  sigaction( SIGUSR2, &action, NULL );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapDone
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapDone prints the statistic of all frames drawn
+*   as heatmap, releases the offscreen buffer and restores the default SIGUSR2
+*   handler. It has to be called while the OpenGL context is still valid.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapDone( void )
+{
+  signal( SIGUSR2, SIG_DFL );
+
+  PrintStatistic( "all", &Total, NoOfFrames );
+  ReleaseBuffer();
+
+  if ( Program )
+    glDeleteProgram( Program );
+
+  Program  = 0;
+  Active   = 0;
+  Counting = NULL;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapProcess
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapProcess has to be called once per main loop
+*   cycle, before the screen is updated. A pending request to toggle the mode
+*   is applied.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the mode has been changed and the entire screen has to be
+*   redrawn, 0 otherwise.
+*
+*******************************************************************************/
+int OverdrawHeatmapProcess( void )
+{
+  if ( !ToggleRequest )
+    return 0;
+
+  ToggleRequest = 0;
+  Active        = !Active;
+  Factor        = 0;
+
+  EwPrint( "OverdrawHeatmap: %s\n", Active ? "on" : "off" );
+
+  /* the memory of the offscreen buffer is only needed for the heatmap */
+  if ( !Active )
+  {
+    PrintStatistic( "last", &Period, NoOfPeriodFrames );
+    memset( &Period, 0, sizeof( Period ));
+    NoOfPeriodFrames = 0;
+    ReleaseBuffer();
+  }
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapIsActive
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapIsActive returns whether the heatmap is shown.
+*   In this case, every screen update has to redraw the entire screen.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the heatmap is shown, 0 otherwise.
+*
+*******************************************************************************/
+int OverdrawHeatmapIsActive( void )
+{
+  return Active;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapGetFactor
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapGetFactor returns the average overdraw factor
+*   of the last frame drawn as heatmap - the drawn pixel divided by the pixel
+*   drawn at least once.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the overdraw factor in hundredths or 0, if the heatmap is not shown.
+*
+*******************************************************************************/
+int OverdrawHeatmapGetFactor( void )
+{
+  return Active ? Factor : 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapGetFramebuffer
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapGetFramebuffer returns the framebuffer to bind
+*   instead of the given one. While an update is counted, the framebuffer of
+*   the screen is replaced by the offscreen buffer.
+*
+* ARGUMENTS:
+*   aFramebuffer - The framebuffer to bind.
+*
+* RETURN VALUE:
+*   Returns the framebuffer to bind in fact.
+*
+*******************************************************************************/
+unsigned int OverdrawHeatmapGetFramebuffer( unsigned int aFramebuffer )
+{
+  return ( Counting && !aFramebuffer ) ? Framebuffer : aFramebuffer;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapEndUpdate
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapEndUpdate has to be called by the completion
+*   callback of a viewport, before the screen is flipped. If the update has
+*   been counted, the heatmap is drawn on the screen and the overdraw factor
+*   is evaluated.
+*
+* ARGUMENTS:
+*   aViewport - The viewport, whose update is completed.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapEndUpdate( XViewport* aViewport )
+{
+  GLint     program;
+  GLint     texture;
+  GLint     unit;
+  GLint     viewport[ 4 ];
+  GLboolean blend;
+  int       i;
+
+  if ( !Counting || ( Counting != aViewport ))
+    return;
+
+  /* the drawing operations of the update are completed */
+  GpuBatchFlush();
+  Counting = NULL;
+
+  /* the state of the OpenGL adaptation is restored afterwards */
+  glGetIntegerv( GL_CURRENT_PROGRAM, &program );
+  glGetIntegerv( GL_ACTIVE_TEXTURE, &unit );
+  glGetIntegerv( GL_VIEWPORT, viewport );
+  blend = glIsEnabled( GL_BLEND );
+
+  glActiveTexture( GL_TEXTURE0 );
+  glGetIntegerv( GL_TEXTURE_BINDING_2D, &texture );
+
+  glUseProgram( Program );
+  glUniform1i( TextureUniform, 0 );
+  glEnableVertexAttribArray( 0 );
+  glDisable( GL_BLEND );
+
+  /* translate the counts of the stencil buffer into levels */
+  glBindFramebuffer( GL_FRAMEBUFFER, Framebuffer );
+  glViewport( 0, 0, Width, Height );
+  glStencilOp( GL_KEEP, GL_KEEP, GL_KEEP );
+
+  for ( i = 1; i <= MAX_LEVEL; i++ )
+  {
+    glStencilFunc(( i < MAX_LEVEL ) ? GL_EQUAL : GL_LEQUAL, i, 0xFF );
+    DrawQuad( i );
+  }
+
+  glDisable( GL_STENCIL_TEST );
+  CountLayers();
+
+  /* draw the levels as heatmap on the screen */
+  glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+  glBindTexture( GL_TEXTURE_2D, Texture );
+  DrawQuad( 0 );
+
+  glBindTexture( GL_TEXTURE_2D, texture );
+  glActiveTexture( unit );
+  glViewport( viewport[ 0 ], viewport[ 1 ], viewport[ 2 ], viewport[ 3 ]);
+  glUseProgram( program );
+
+  if ( blend )
+    glEnable( GL_BLEND );
+
+  NoOfFrames++;
+  NoOfPeriodFrames++;
+
+  if (( EW_OVERDRAW_HEATMAP_REPORT_FRAMES > 0 ) &&
+      ( NoOfPeriodFrames >= EW_OVERDRAW_HEATMAP_REPORT_FRAMES ))
+  {
+    PrintStatistic( "last", &Period, NoOfPeriodFrames );
+    memset( &Period, 0, sizeof( Period ));
+    NoOfPeriodFrames = 0;
+  }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwBeginUpdate
+*
+* DESCRIPTION:
+*   The function __wrap_EwBeginUpdate replaces EwBeginUpdate() of the Graphics
+*   Engine. While the heatmap is shown, the following drawing operations are
+*   counted in the offscreen buffer.
+*
+* ARGUMENTS:
+*   See EwBeginUpdate().
+*
+* RETURN VALUE:
+*   See EwBeginUpdate().
+*
+*******************************************************************************/
+XBitmap* __wrap_EwBeginUpdate( XViewport* aViewport )
+{
+  XBitmap* bitmap = __real_EwBeginUpdate( aViewport );
+
+  if ( bitmap && Active )
+    BeginCounting( aViewport );
+
+  return bitmap;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwBeginUpdateArea
+*
+* DESCRIPTION:
+*   The function __wrap_EwBeginUpdateArea replaces EwBeginUpdateArea() of the
+*   Graphics Engine. While the heatmap is shown, the following drawing
+*   operations are counted in the offscreen buffer.
+*
+* ARGUMENTS:
+*   See EwBeginUpdateArea().
+*
+* RETURN VALUE:
+*   See EwBeginUpdateArea().
+*
+*******************************************************************************/
+XBitmap* __wrap_EwBeginUpdateArea( XViewport* aViewport, XRect aArea )
+{
+  XBitmap* bitmap = __real_EwBeginUpdateArea( aViewport, aArea );
+
+  if ( bitmap && Active )
+    BeginCounting( aViewport );
+
+  return bitmap;
+}
+
+
+/* msy */
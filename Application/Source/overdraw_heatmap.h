@@ -0,0 +1,282 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides a debug mode visualizing the overdraw of the screen
+*   updates as heatmap. While the mode is active, the drawing operations of the
+*   viewports (see EwBeginUpdate() and EwEndUpdate()) are redirected into an
+*   offscreen buffer. Its stencil buffer is incremented by every drawn pixel,
+*   so after the update it contains the number of layers drawn per pixel.
+*
+*   Before the screen is flipped, the counts are translated into colors and
+*   drawn on the screen instead of the UI:
+*
+*     not drawn - black
+*     1 layer   - blue
+*     2 layers  - green
+*     3 layers  - yellow
+*     4 layers  - orange
+*     5 layers  - red
+*     6 layers  - magenta
+*     8 layers and more - white
+*
+*   The counts are read back to calculate the average overdraw factor - the
+*   drawn pixel divided by the pixel drawn at least once. The factor of the
+*   last frame is available by OverdrawHeatmapGetFactor() and the average is
+*   printed every EW_OVERDRAW_HEATMAP_REPORT_FRAMES frames. While the mode is
+*   active, every screen update redraws the entire screen.
+*
+*   Only the drawing operations into the framebuffer are counted - the content
+*   of buffered components is drawn once into offscreen bitmaps and counted
+*   as one layer, when it is copied to the screen.
+*
+*   The functions EwBeginUpdate() and EwBeginUpdateArea() are redirected by the
+*   linker (option --wrap) to the respective __wrap_ functions.
+*
+*   The mode is selected by EW_OVERDRAW_HEATMAP or at runtime by the environment
+*   variable EW_OVERDRAW_HEATMAP ("off" or "on") and toggled by SIGUSR2.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef OVERDRAW_HEATMAP_H
+#define OVERDRAW_HEATMAP_H
+
+#include "ewgfx.h"
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapInit
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapInit selects whether the heatmap is shown,
+*   resets the statistic and installs the SIGUSR2 handler to toggle the mode.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapDone
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapDone prints the statistic of all frames drawn
+*   as heatmap, releases the offscreen buffer and restores the default SIGUSR2
+*   handler. It has to be called while the OpenGL context is still valid.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapProcess
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapProcess has to be called once per main loop
+*   cycle, before the screen is updated. A pending request to toggle the mode
+*   is applied.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the mode has been changed and the entire screen has to be
+*   redrawn, 0 otherwise.
+*
+*******************************************************************************/
+int OverdrawHeatmapProcess
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapIsActive
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapIsActive returns whether the heatmap is shown.
+*   In this case, every screen update has to redraw the entire screen.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the heatmap is shown, 0 otherwise.
+*
+*******************************************************************************/
+int OverdrawHeatmapIsActive
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapGetFactor
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapGetFactor returns the average overdraw factor
+*   of the last frame drawn as heatmap - the drawn pixel divided by the pixel
+*   drawn at least once.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the overdraw factor in hundredths or 0, if the heatmap is not shown.
+*
+*******************************************************************************/
+int OverdrawHeatmapGetFactor
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapGetFramebuffer
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapGetFramebuffer returns the framebuffer to bind
+*   instead of the given one. While an update is counted, the framebuffer of
+*   the screen is replaced by the offscreen buffer.
+*
+* ARGUMENTS:
+*   aFramebuffer - The framebuffer to bind.
+*
+* RETURN VALUE:
+*   Returns the framebuffer to bind in fact.
+*
+*******************************************************************************/
+unsigned int OverdrawHeatmapGetFramebuffer
+(
+  unsigned int                aFramebuffer
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   OverdrawHeatmapEndUpdate
+*
+* DESCRIPTION:
+*   The function OverdrawHeatmapEndUpdate has to be called by the completion
+*   callback of a viewport, before the screen is flipped. If the update has
+*   been counted, the heatmap is drawn on the screen and the overdraw factor
+*   is evaluated.
+*
+* ARGUMENTS:
+*   aViewport - The viewport, whose update is completed.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void OverdrawHeatmapEndUpdate
+(
+  XViewport*                  aViewport
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwBeginUpdate
+*
+* DESCRIPTION:
+*   The function __wrap_EwBeginUpdate replaces EwBeginUpdate() of the Graphics
+*   Engine. While the heatmap is shown, the following drawing operations are
+*   counted in the offscreen buffer.
+*
+* ARGUMENTS:
+*   See EwBeginUpdate().
+*
+* RETURN VALUE:
+*   See EwBeginUpdate().
+*
+*******************************************************************************/
+XBitmap* __wrap_EwBeginUpdate
+(
+  XViewport*                  aViewport
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwBeginUpdateArea
+*
+* DESCRIPTION:
+*   The function __wrap_EwBeginUpdateArea replaces EwBeginUpdateArea() of the
+*   Graphics Engine. While the heatmap is shown, the following drawing
+*   operations are counted in the offscreen buffer.
+*
+* ARGUMENTS:
+*   See EwBeginUpdateArea().
+*
+* RETURN VALUE:
+*   See EwBeginUpdateArea().
+*
+*******************************************************************************/
+XBitmap* __wrap_EwBeginUpdateArea
+(
+  XViewport*                  aViewport,
+  XRect                       aArea
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* OVERDRAW_HEATMAP_H */
+
+
+/* msy */
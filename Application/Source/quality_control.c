@@ -0,0 +1,440 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template adapts the rendering quality to the load of the system by a
+*   ladder of quality levels, which is stepped down if frames miss their budget
+*   and stepped up again if there is enough headroom.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "quality_control.h"
+
+#ifndef EW_QUALITY_CONTROL
+  #define EW_QUALITY_CONTROL          1
+#endif
+
+#ifndef EW_QUALITY_HEADROOM
+  #define EW_QUALITY_HEADROOM         60
+#endif
+
+#ifndef EW_QUALITY_RECOVERY_FRAMES
+  #define EW_QUALITY_RECOVERY_FRAMES  120
+#endif
+
+/* budget of a frame in us, if the time of the vertical blank is unknown */
+#define DEFAULT_BUDGET                16667
+
+/* a level is lowered, if NO_OF_MISSES of the recent NO_OF_FRAMES frames missed
+   their budget - but not before MIN_FRAMES frames were drawn on the level */
+#define NO_OF_FRAMES                  8
+#define NO_OF_MISSES                  3
+#define MIN_FRAMES                    15
+
+/* if a raised level fails within PROBATION_FRAMES frames, the recovery from
+   the lower level takes twice as long - up to MAX_BACKOFF times */
+#define PROBATION_FRAMES              60
+#define MAX_BACKOFF                   16
+
+/* the original function of the Graphics Engine */
+void __real_EwWarpBitmap( XBitmap* aDst, XBitmap* aSrc, XInt32 aDstFrameNo,
+  XInt32 aSrcFrameNo, XRect aClipRect, XFloat aDstX1, XFloat aDstY1, XFloat aDstW1,
+  XFloat aDstX2, XFloat aDstY2, XFloat aDstW2, XFloat aDstX3, XFloat aDstY3,
+  XFloat aDstW3, XFloat aDstX4, XFloat aDstY4, XFloat aDstW4, XRect aSrcRect,
+  XColor aColor1, XColor aColor2, XColor aColor3, XColor aColor4, XBool aBlend,
+  XBool aFilter );
+
+typedef struct
+{
+  int           RenderScale;   /* render resolution in percent */
+  int           Filter;        /* bi-linear filtering of warped bitmaps */
+  int           Defer;         /* reduced update rate of additional displays */
+  int           FrameInterval; /* number of vertical blanks per frame */
+  const char*   Name;
+} XQualityLevel;
+
+static const XQualityLevel Levels[] =
+{
+  { 100, 1, 0, 1, "full quality"         },
+  {  75, 1, 0, 1, "reduced resolution"   },
+  {  75, 0, 0, 1, "unfiltered warps"     },
+  {  75, 0, 1, 1, "deferred redraws"     },
+  {  50, 0, 1, 1, "low resolution"       },
+  {  50, 0, 1, 2, "reduced frame rate"   }
+};
+
+#define NO_OF_LEVELS ((int)( sizeof( Levels ) / sizeof( Levels[ 0 ])))
+
+static int          Enabled = 0;
+static int          Level   = 0;
+static int          BaseScale = 100;       /* render scale at full quality */
+static long long    FrameStart;            /* start of the current frame in us */
+static long long    FrameBudget;           /* budget of the current frame in us */
+static long long    FrameTimes[ NO_OF_FRAMES ];
+static int          Misses[ NO_OF_FRAMES ];
+static unsigned int NoOfFrames;            /* frames drawn on the current level */
+static unsigned int Headroom;              /* frames in a row with headroom */
+static long long    MaxHeadroomTime;       /* longest of these frames in us */
+static int          RaisedFrom;            /* level left upward or -1 */
+static unsigned int RecoveryFrames[ NO_OF_LEVELS ];
+static unsigned int VBlanks;
+
+/* statistic of the quality levels */
+static unsigned int FramesPerLevel[ NO_OF_LEVELS ];
+static unsigned int NoOfTransitions;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the current time in microseconds
+ */
+static long long GetTime( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+
+  return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+
+/*
+ * helper function to select a new quality level and to report the transition
+ * with its reason - returns 1 if the render scale has changed
+ */
+static int SetLevel( int aLevel, const char* aReason )
+{
+  int oldScale = Levels[ Level ].RenderScale;
+
+  EwPrint( "QualityControl: level %d (%s) -> %d (%s): %s\n", Level,
+    Levels[ Level ].Name, aLevel, Levels[ aLevel ].Name, aReason );
+
+  /* a raised level failed shortly after the transition - wait longer before
+     trying it again */
+  if (( aLevel > Level ) && ( RaisedFrom == aLevel ) && ( NoOfFrames < PROBATION_FRAMES ) &&
+      ( RecoveryFrames[ aLevel ] < EW_QUALITY_RECOVERY_FRAMES * MAX_BACKOFF ))
+    RecoveryFrames[ aLevel ] *= 2;
+
+  RaisedFrom = ( aLevel < Level ) ? Level : -1;
+  Level      = aLevel;
+  NoOfFrames = 0;
+  Headroom   = 0;
+
+  MaxHeadroomTime = 0;
+  NoOfTransitions++;
+  memset( Misses, 0, sizeof( Misses ));
+  memset( FrameTimes, 0, sizeof( FrameTimes ));
+
+  return Levels[ Level ].RenderScale != oldScale;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlInit
+*
+* DESCRIPTION:
+*   The function QualityControlInit starts the quality control with full
+*   quality and resets the statistic.
+*
+* ARGUMENTS:
+*   aRenderScale - Render resolution in percent of the display size, the UI is
+*     rendered with at full quality.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlInit( int aRenderScale )
+{
+  int i;
+
+  Enabled = EwGetEnvSwitch( "EW_QUALITY_CONTROL", EW_QUALITY_CONTROL );
+
+  Level           = 0;
+  BaseScale       = aRenderScale;
+  NoOfFrames      = 0;
+  Headroom        = 0;
+  MaxHeadroomTime = 0;
+  RaisedFrom      = -1;
+  VBlanks         = 0;
+  NoOfTransitions = 0;
+
+  memset( Misses, 0, sizeof( Misses ));
+  memset( FrameTimes, 0, sizeof( FrameTimes ));
+  memset( FramesPerLevel, 0, sizeof( FramesPerLevel ));
+
+  for ( i = 0; i < NO_OF_LEVELS; i++ )
+    RecoveryFrames[ i ] = EW_QUALITY_RECOVERY_FRAMES;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlDone
+*
+* DESCRIPTION:
+*   The function QualityControlDone prints the statistic of the quality levels.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlDone( void )
+{
+  int i;
+
+  if ( !Enabled )
+    return;
+
+  EwPrint( "Quality levels: %u transitions, frames per level:", NoOfTransitions );
+
+  for ( i = 0; i < NO_OF_LEVELS; i++ )
+    EwPrint( " %u", FramesPerLevel[ i ]);
+
+  EwPrint( "\n" );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlBeginFrame
+*
+* DESCRIPTION:
+*   The function QualityControlBeginFrame has to be called before a frame is
+*   drawn. It starts the measurement of the frame.
+*
+* ARGUMENTS:
+*   aVBlank - Time of the vertical blank, the frame is presented with, in
+*     microseconds (CLOCK_MONOTONIC) or 0 if unknown.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlBeginFrame( long long aVBlank )
+{
+  FrameStart  = GetTime();
+  FrameBudget = DEFAULT_BUDGET;
+
+  /* the frame has to be completed before its vertical blank */
+  if ( aVBlank > FrameStart )
+    FrameBudget = aVBlank - FrameStart;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlEndFrame
+*
+* DESCRIPTION:
+*   The function QualityControlEndFrame has to be called after a frame has been
+*   drawn. The duration of the frame is evaluated and, if necessary, the next
+*   quality level is selected.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the render scale has been changed and has to be applied (see
+*   QualityControlGetRenderScale()), 0 otherwise.
+*
+*******************************************************************************/
+int QualityControlEndFrame( void )
+{
+  long long time    = GetTime() - FrameStart;
+  int       index   = NoOfFrames % NO_OF_FRAMES;
+  int       misses  = 0;
+  long long maxTime = 0;
+  char      reason[ 128 ];
+  int       i;
+
+  if ( !Enabled )
+    return 0;
+
+  FramesPerLevel[ Level ]++;
+  FrameTimes[ index ] = time;
+  Misses[ index ]     = time > FrameBudget;
+  NoOfFrames++;
+
+  /* frames with headroom in a row */
+  if ( time * 100 <= FrameBudget * EW_QUALITY_HEADROOM )
+  {
+    Headroom++;
+    if ( time > MaxHeadroomTime )
+      MaxHeadroomTime = time;
+  }
+  else
+  {
+    Headroom        = 0;
+    MaxHeadroomTime = 0;
+  }
+
+  for ( i = 0; i < NO_OF_FRAMES; i++ )
+  {
+    misses += Misses[ i ];
+    if ( FrameTimes[ i ] > maxTime )
+      maxTime = FrameTimes[ i ];
+  }
+
+  /* the frames miss their budget repeatedly - lower the quality */
+  if (( misses >= NO_OF_MISSES ) && ( NoOfFrames >= MIN_FRAMES ) &&
+      ( Level < NO_OF_LEVELS - 1 ))
+  {
+    snprintf( reason, sizeof( reason ),
+      "%d of %d frames over budget (max %u us, budget %u us)", misses, NO_OF_FRAMES,
+      (unsigned int)maxTime, (unsigned int)FrameBudget );
+    return SetLevel( Level + 1, reason );
+  }
+
+  /* enough headroom for a longer period - try the higher quality */
+  if (( Headroom >= RecoveryFrames[ Level ]) && ( Level > 0 ))
+  {
+    snprintf( reason, sizeof( reason ), "%u frames below %d%% of budget (max %u us)",
+      Headroom, EW_QUALITY_HEADROOM, (unsigned int)MaxHeadroomTime );
+    return SetLevel( Level - 1, reason );
+  }
+
+  return 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlSkipFrame
+*
+* DESCRIPTION:
+*   The function QualityControlSkipFrame has to be called when a frame is due.
+*   With reduced frame rate, every second vertical blank is left out - the
+*   changes are drawn with the following one.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the frame should be left out, 0 otherwise.
+*
+*******************************************************************************/
+int QualityControlSkipFrame( void )
+{
+  if ( !Enabled || ( Levels[ Level ].FrameInterval <= 1 ))
+    return 0;
+
+  return ( VBlanks++ % Levels[ Level ].FrameInterval ) != 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlDefersRedraws
+*
+* DESCRIPTION:
+*   The function QualityControlDefersRedraws returns whether the additional
+*   displays are updated with reduced rate.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the redraws of the additional displays are deferred, 0
+*   otherwise.
+*
+*******************************************************************************/
+int QualityControlDefersRedraws( void )
+{
+  return Enabled && Levels[ Level ].Defer;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlGetRenderScale
+*
+* DESCRIPTION:
+*   The function QualityControlGetRenderScale returns the render resolution of
+*   the current quality level.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the render resolution in percent of the display size.
+*
+*******************************************************************************/
+int QualityControlGetRenderScale( void )
+{
+  return ( BaseScale * Levels[ Enabled ? Level : 0 ].RenderScale + 50 ) / 100;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwWarpBitmap
+*
+* DESCRIPTION:
+*   The function __wrap_EwWarpBitmap replaces EwWarpBitmap() of the Graphics
+*   Engine. On the reduced quality levels, the bi-linear filtering is switched
+*   off. Otherwise the parameters are passed unchanged.
+*
+* ARGUMENTS:
+*   See EwWarpBitmap().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwWarpBitmap( XBitmap* aDst, XBitmap* aSrc, XInt32 aDstFrameNo,
+  XInt32 aSrcFrameNo, XRect aClipRect, XFloat aDstX1, XFloat aDstY1, XFloat aDstW1,
+  XFloat aDstX2, XFloat aDstY2, XFloat aDstW2, XFloat aDstX3, XFloat aDstY3,
+  XFloat aDstW3, XFloat aDstX4, XFloat aDstY4, XFloat aDstW4, XRect aSrcRect,
+  XColor aColor1, XColor aColor2, XColor aColor3, XColor aColor4, XBool aBlend,
+  XBool aFilter )
+{
+  /* without filtering, the Graphics Engine creates no EW_TASK_HIGH_QUALITY
+     tasks for the warp */
+  if ( Enabled && !Levels[ Level ].Filter )
+    aFilter = 0;
+
+  __real_EwWarpBitmap( aDst, aSrc, aDstFrameNo, aSrcFrameNo, aClipRect, aDstX1,
+    aDstY1, aDstW1, aDstX2, aDstY2, aDstW2, aDstX3, aDstY3, aDstW3, aDstX4, aDstY4,
+    aDstW4, aSrcRect, aColor1, aColor2, aColor3, aColor4, aBlend, aFilter );
+}
+
+
+/* msy */
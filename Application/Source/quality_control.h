@@ -0,0 +1,272 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template adapts the rendering quality to the load of the system. The
+*   duration of every drawn frame is compared with its budget - the time until
+*   the vertical blank, the frame is presented with. If frames miss their
+*   budget repeatedly, the quality is lowered by one level of the following
+*   ladder. After a longer period with enough headroom, the quality is raised
+*   again by one level. Each transition is reported with its reason.
+*
+*   Level 0 - Full quality.
+*   Level 1 - The UI is rendered at 75 % of the resolution (see
+*     EwSetRenderScale()).
+*   Level 2 - Additionally, warped bitmaps are drawn without bi-linear
+*     filtering (no EW_TASK_HIGH_QUALITY tasks).
+*   Level 3 - Additionally, the additional displays are updated only every
+*     QUALITY_DEFER_INTERVAL-th frame.
+*   Level 4 - Additionally, the UI is rendered at 50 % of the resolution.
+*   Level 5 - Additionally, only every second vertical blank gets a frame. The
+*     animations keep their speed, but have half the number of frames.
+*
+*   The function EwWarpBitmap() is redirected by the linker (option --wrap) to
+*   __wrap_EwWarpBitmap().
+*
+*   The quality control is selected by EW_QUALITY_CONTROL or at runtime by the
+*   environment variable EW_QUALITY_CONTROL ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef QUALITY_CONTROL_H
+#define QUALITY_CONTROL_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/* the additional displays are updated every n-th frame on level 3 and above */
+#define QUALITY_DEFER_INTERVAL        4
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlInit
+*
+* DESCRIPTION:
+*   The function QualityControlInit starts the quality control with full
+*   quality and resets the statistic.
+*
+* ARGUMENTS:
+*   aRenderScale - Render resolution in percent of the display size, the UI is
+*     rendered with at full quality.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlInit
+(
+  int                         aRenderScale
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlDone
+*
+* DESCRIPTION:
+*   The function QualityControlDone prints the statistic of the quality levels.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlBeginFrame
+*
+* DESCRIPTION:
+*   The function QualityControlBeginFrame has to be called before a frame is
+*   drawn. It starts the measurement of the frame.
+*
+* ARGUMENTS:
+*   aVBlank - Time of the vertical blank, the frame is presented with, in
+*     microseconds (CLOCK_MONOTONIC) or 0 if unknown.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void QualityControlBeginFrame
+(
+  long long                   aVBlank
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlEndFrame
+*
+* DESCRIPTION:
+*   The function QualityControlEndFrame has to be called after a frame has been
+*   drawn. The duration of the frame is evaluated and, if necessary, the next
+*   quality level is selected.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the render scale has been changed and has to be applied (see
+*   QualityControlGetRenderScale()), 0 otherwise.
+*
+*******************************************************************************/
+int QualityControlEndFrame
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlSkipFrame
+*
+* DESCRIPTION:
+*   The function QualityControlSkipFrame has to be called when a frame is due.
+*   With reduced frame rate, every second vertical blank is left out - the
+*   changes are drawn with the following one.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the frame should be left out, 0 otherwise.
+*
+*******************************************************************************/
+int QualityControlSkipFrame
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlDefersRedraws
+*
+* DESCRIPTION:
+*   The function QualityControlDefersRedraws returns whether the additional
+*   displays are updated with reduced rate.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the redraws of the additional displays are deferred, 0
+*   otherwise.
+*
+*******************************************************************************/
+int QualityControlDefersRedraws
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   QualityControlGetRenderScale
+*
+* DESCRIPTION:
+*   The function QualityControlGetRenderScale returns the render resolution of
+*   the current quality level.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the render resolution in percent of the display size.
+*
+*******************************************************************************/
+int QualityControlGetRenderScale
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwWarpBitmap
+*
+* DESCRIPTION:
+*   The function __wrap_EwWarpBitmap replaces EwWarpBitmap() of the Graphics
+*   Engine. On the reduced quality levels, the bi-linear filtering is switched
+*   off. Otherwise the parameters are passed unchanged.
+*
+* ARGUMENTS:
+*   See EwWarpBitmap().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_EwWarpBitmap
+(
+  XBitmap*                    aDst,
+  XBitmap*                    aSrc,
+  XInt32                      aDstFrameNo,
+  XInt32                      aSrcFrameNo,
+  XRect                       aClipRect,
+  XFloat                      aDstX1,
+  XFloat                      aDstY1,
+  XFloat                      aDstW1,
+  XFloat                      aDstX2,
+  XFloat                      aDstY2,
+  XFloat                      aDstW2,
+  XFloat                      aDstX3,
+  XFloat                      aDstY3,
+  XFloat                      aDstW3,
+  XFloat                      aDstX4,
+  XFloat                      aDstY4,
+  XFloat                      aDstW4,
+  XRect                       aSrcRect,
+  XColor                      aColor1,
+  XColor                      aColor2,
+  XColor                      aColor3,
+  XColor                      aColor4,
+  XBool                       aBlend,
+  XBool                       aFilter
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* QUALITY_CONTROL_H */
+
+
+/* msy */
@@ -0,0 +1,801 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides a persistent cache of the linked shader programs
+*   of the OpenGL adaptation. With GL_OES_get_program_binary, the binary of
+*   every linked program is stored on disk - the next start loads the binary
+*   instead of compiling and linking the shaders again. This applies to the
+*   programs created by OpenGLInit() as well as to the shader variants, that
+*   are created on their first use.
+*
+*   The compilation of a shader is deferred until the program is linked. If
+*   the cache contains a binary for the program, the shaders are never
+*   compiled. The binaries are identified by the OpenGL vendor, renderer and
+*   version and by a hash of the sources of the attached shaders - a driver
+*   update invalidates the cache.
+*
+*   At startup, all stored binaries are loaded into memory by a boot task, so
+*   the variants, that are created later, are available without any access to
+*   the storage. The binaries of newly linked programs are written by a worker
+*   thread, started in the idle time of the GUI thread (ShaderCacheFlush()).
+*   Each file is written under a temporary name, synchronized and renamed, so
+*   a power loss never leaves a truncated binary.
+*
+*   The OpenGL functions glShaderSource(), glCompileShader(), glGetShaderiv(),
+*   glLinkProgram() and glDeleteShader() are redirected by the linker (option
+*   --wrap) to the respective __wrap_ functions.
+*
+*   The shader cache is selected by EW_SHADER_CACHE or at runtime by the
+*   environment variable EW_SHADER_CACHE ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <EGL/egl.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "shader_cache.h"
+
+#ifndef EW_SHADER_CACHE
+  #define EW_SHADER_CACHE             1
+#endif
+
+#ifndef EW_SHADER_CACHE_DIR
+  #define EW_SHADER_CACHE_DIR         "/var/cache/embedded-wizard"
+#endif
+
+/* maximum number of tracked shaders and of cached program binaries */
+#define NO_OF_SHADERS                 64
+#define NO_OF_BINARIES                128
+
+/* identification of a program binary file ('EWSC') */
+#define BINARY_MAGIC                  0x43535745
+
+/* the original functions of OpenGL */
+void __real_glShaderSource( GLuint aShader, GLsizei aCount, const GLchar* const* aString,
+  const GLint* aLength );
+void __real_glCompileShader( GLuint aShader );
+void __real_glGetShaderiv( GLuint aShader, GLenum aName, GLint* aParams );
+void __real_glLinkProgram( GLuint aProgram );
+void __real_glDeleteShader( GLuint aShader );
+
+typedef struct
+{
+  GLuint        Id;        /* 0 if the entry is not used */
+  uint64_t      Hash;      /* hash of the source */
+  int           Pending;   /* the compilation is deferred */
+} XShader;
+
+typedef struct
+{
+  uint32_t      Magic;     /* BINARY_MAGIC */
+  uint32_t      Format;    /* binary format of the driver */
+  uint32_t      Length;    /* size of the following binary in bytes */
+  uint32_t      Reserved;
+  uint64_t      Key;       /* hash of the driver and the shader sources */
+} XBinaryHeader;
+
+typedef struct
+{
+  uint64_t      Key;
+  GLenum        Format;
+  GLsizei       Length;
+  void*         Data;
+  int           Dirty;     /* not yet written to the storage */
+} XBinary;
+
+static int          Enabled      = 0;
+static int          Supported    = -1;  /* GL_OES_get_program_binary, -1 = not yet queried */
+static uint64_t     DriverHash   = 0;
+static XShader      Shaders[ NO_OF_SHADERS ];
+static XBinary      Binaries[ NO_OF_BINARIES ];
+static int          NoOfBinaries = 0;
+static int          NoOfLoaded   = 0;   /* programs loaded from the cache */
+static int          NoOfLinked   = 0;   /* programs compiled and linked */
+static int          NoOfDirty    = 0;   /* binaries not yet written */
+static XBinary      Pending[ NO_OF_BINARIES ]; /* copies owned by the writer */
+static int          NoOfPending  = 0;
+static pthread_t    Writer;
+static int          WriterStarted;
+static atomic_int   WriterBusy;
+static PFNGLGETPROGRAMBINARYOESPROC GetProgramBinary = 0;
+static PFNGLPROGRAMBINARYOESPROC    ProgramBinary    = 0;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to continue a 64 bit FNV-1a hash with the given data
+ */
+static uint64_t Hash( uint64_t aHash, const void* aData, size_t aSize )
+{
+  const uint8_t* data = (const uint8_t*)aData;
+
+  while ( aSize-- )
+    aHash = ( aHash ^ *data++ ) * 0x100000001B3ULL;
+
+  return aHash;
+}
+
+
+/*
+ * helper function to continue a hash with an OpenGL string
+ */
+static uint64_t HashString( uint64_t aHash, GLenum aName )
+{
+  const char* string = (const char*)glGetString( aName );
+
+  return string ? Hash( aHash, string, strlen( string ) + 1 ) : aHash;
+}
+
+
+/*
+ * helper function to find the entry of a shader - if desired, a new entry is
+ * created
+ */
+static XShader* GetShader( GLuint aShader, int aCreate )
+{
+  XShader* unused = NULL;
+  int      i;
+
+  for ( i = 0; i < NO_OF_SHADERS; i++ )
+  {
+    if ( Shaders[ i ].Id == aShader )
+      return &Shaders[ i ];
+
+    if ( !unused && !Shaders[ i ].Id )
+      unused = &Shaders[ i ];
+  }
+
+  if ( !aCreate || !unused )
+    return NULL;
+
+  memset( unused, 0, sizeof( XShader ));
+  unused->Id = aShader;
+
+  return unused;
+}
+
+
+/*
+ * helper function to determine, whether the driver supports program binaries
+ * - the current OpenGL context is needed
+ */
+static int IsSupported( void )
+{
+  const char* extensions;
+  GLint       formats = 0;
+
+  if ( Supported >= 0 )
+    return Supported;
+
+  extensions = (const char*)glGetString( GL_EXTENSIONS );
+  Supported  = 0;
+
+  if ( extensions && strstr( extensions, "GL_OES_get_program_binary" ))
+    glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats );
+
+  if ( formats > 0 )
+  {
+    GetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress( "glGetProgramBinaryOES" );
+    ProgramBinary    = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress( "glProgramBinaryOES" );
+    Supported        = GetProgramBinary && ProgramBinary;
+  }
+
+  /* the binaries of another driver version are not compatible */
+  DriverHash = 0xCBF29CE484222325ULL;
+  DriverHash = HashString( DriverHash, GL_VENDOR );
+  DriverHash = HashString( DriverHash, GL_RENDERER );
+  DriverHash = HashString( DriverHash, GL_VERSION );
+
+  if ( !Supported )
+    EwPrint( "ShaderCache: Program binaries not supported by the driver\n" );
+
+  return Supported;
+}
+
+
+/*
+ * helper function to find the cached binary of a program
+ */
+static XBinary* FindBinary( uint64_t aKey )
+{
+  int i;
+
+  for ( i = 0; i < NoOfBinaries; i++ )
+    if ( Binaries[ i ].Key == aKey )
+      return &Binaries[ i ];
+
+  return NULL;
+}
+
+
+/*
+ * helper function to load a stored program binary into memory
+ */
+static void LoadBinary( const char* aFileName )
+{
+  XBinaryHeader header;
+  XBinary*      binary = &Binaries[ NoOfBinaries ];
+  FILE*         file   = fopen( aFileName, "rb" );
+  void*         data   = NULL;
+  struct stat   info;
+  int           ok;
+
+  if ( !file )
+    return;
+
+  /* a corrupted header must not reserve more memory than the file contains */
+  ok = !fstat( fileno( file ), &info ) &&
+       ( info.st_size >= (off_t)sizeof( header )) &&
+       ( fread( &header, sizeof( header ), 1, file ) == 1 ) &&
+       ( header.Magic == BINARY_MAGIC ) && header.Length &&
+       ( header.Length <= (uint64_t)info.st_size - sizeof( header )) &&
+       !FindBinary( header.Key );
+
+  if ( ok )
+    data = malloc( header.Length );
+
+  ok = data && ( fread( data, header.Length, 1, file ) == 1 );
+  fclose( file );
+
+  if ( !ok )
+  {
+    free( data );
+    return;
+  }
+
+  binary->Key    = header.Key;
+  binary->Format = header.Format;
+  binary->Length = header.Length;
+  binary->Data   = data;
+  binary->Dirty  = 0;
+  NoOfBinaries++;
+}
+
+
+/*
+ * helper function to read the binary of a linked program into the cache - an
+ * existing, rejected binary is replaced. The binary is written later by
+ * ShaderCacheFlush()
+ */
+static void StoreBinary( uint64_t aKey, GLuint aProgram, XBinary* aBinary )
+{
+  GLint  length = 0;
+  GLenum format = 0;
+  void*  data;
+
+  if ( !aBinary && ( NoOfBinaries >= NO_OF_BINARIES ))
+    return;
+
+  glGetProgramiv( aProgram, GL_PROGRAM_BINARY_LENGTH_OES, &length );
+
+  data = ( length > 0 ) ? malloc( length ) : NULL;
+  if ( !data )
+    return;
+
+  GetProgramBinary( aProgram, length, &length, &format, data );
+
+  if ( !aBinary )
+    aBinary = &Binaries[ NoOfBinaries++ ];
+
+  if ( !aBinary->Dirty )
+    NoOfDirty++;
+
+  free( aBinary->Data );
+  aBinary->Key    = aKey;
+  aBinary->Format = format;
+  aBinary->Length = length;
+  aBinary->Data   = data;
+  aBinary->Dirty  = 1;
+}
+
+
+/*
+ * helper function to write one program binary - the file is written and
+ * synchronized completely, before it replaces the previous one
+ */
+static int WriteBinary( XBinary* aBinary )
+{
+  XBinaryHeader header;
+  char          fileName[ 256 ];
+  char          tmpName[ 256 ];
+  FILE*         file;
+  int           ok;
+
+  snprintf( fileName, sizeof( fileName ), "%s/%016llx.bin", EW_SHADER_CACHE_DIR,
+    (unsigned long long)aBinary->Key );
+  snprintf( tmpName, sizeof( tmpName ), "%s.tmp", fileName );
+
+  header.Magic    = BINARY_MAGIC;
+  header.Format   = aBinary->Format;
+  header.Length   = aBinary->Length;
+  header.Reserved = 0;
+  header.Key      = aBinary->Key;
+
+  file = fopen( tmpName, "wb" );
+  ok   = file && ( fwrite( &header, sizeof( header ), 1, file ) == 1 ) &&
+         ( fwrite( aBinary->Data, aBinary->Length, 1, file ) == 1 ) &&
+         !fflush( file ) && !fsync( fileno( file ));
+
+  if ( file )
+    ok = !fclose( file ) && ok;
+
+  if ( !ok || rename( tmpName, fileName ))
+  {
+    EwPrint( "ShaderCache: Cannot write %s!\n", fileName );
+    unlink( tmpName );
+    return 0;
+  }
+
+  return 1;
+}
+
+
+/*
+ * helper function to write the pending binaries and to synchronize the
+ * directory, so the renamed files survive a power loss
+ */
+static void WritePending( void )
+{
+  int written = 0;
+  int dir;
+  int i;
+
+  for ( i = 0; i < NoOfPending; i++ )
+  {
+    written |= WriteBinary( &Pending[ i ]);
+    free( Pending[ i ].Data );
+  }
+
+  NoOfPending = 0;
+
+  if ( written && (( dir = open( EW_SHADER_CACHE_DIR, O_RDONLY )) >= 0 ))
+  {
+    fsync( dir );
+    close( dir );
+  }
+}
+
+
+/*
+ * thread function of the writer
+ */
+static void* WriterThread( void* aArg )
+{
+  (void)aArg;
+
+  WritePending();
+  atomic_store( &WriterBusy, 0 );
+
+  return NULL;
+}
+
+
+/*
+ * helper function to hand the dirty binaries over to the writer - the writer
+ * gets copies, since a rejected binary may be replaced meanwhile. Returns the
+ * number of pending binaries
+ */
+static int CollectPending( void )
+{
+  int i;
+
+  for ( i = 0; ( i < NoOfBinaries ) && NoOfDirty; i++ )
+  {
+    if ( !Binaries[ i ].Dirty )
+      continue;
+
+    Pending[ NoOfPending ]      = Binaries[ i ];
+    Pending[ NoOfPending ].Data = malloc( Binaries[ i ].Length );
+
+    /* without memory, the binary is written with the next attempt */
+    if ( !Pending[ NoOfPending ].Data )
+      break;
+
+    memcpy( Pending[ NoOfPending++ ].Data, Binaries[ i ].Data, Binaries[ i ].Length );
+    Binaries[ i ].Dirty = 0;
+    NoOfDirty--;
+  }
+
+  return NoOfPending;
+}
+
+
+/*
+ * helper function to wait for the recent writer
+ */
+static void JoinWriter( void )
+{
+  if ( !WriterStarted )
+    return;
+
+  pthread_join( Writer, NULL );
+  WriterStarted = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheInit
+*
+* DESCRIPTION:
+*   The function ShaderCacheInit loads all stored program binaries into
+*   memory. It accesses the storage only - no OpenGL context is needed, thus
+*   the function can be executed by a worker thread. It has to be finished
+*   before the Graphics Engine is initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheInit( void )
+{
+  char           fileName[ 256 ];
+  struct dirent* entry;
+  DIR*           dir;
+  size_t         len;
+
+  Enabled = EwGetEnvSwitch( "EW_SHADER_CACHE", EW_SHADER_CACHE );
+
+  memset( Shaders, 0, sizeof( Shaders ));
+  atomic_store( &WriterBusy, 0 );
+  NoOfBinaries = 0;
+  NoOfDirty    = 0;
+  NoOfPending  = 0;
+  NoOfLoaded   = 0;
+  NoOfLinked   = 0;
+  Supported    = -1;
+
+  if ( !Enabled )
+    return;
+
+  mkdir( EW_SHADER_CACHE_DIR, 0755 );
+
+  dir = opendir( EW_SHADER_CACHE_DIR );
+  if ( !dir )
+    return;
+
+  /* all binaries are loaded - also those of variants created later */
+  while ((( entry = readdir( dir )) != NULL ) && ( NoOfBinaries < NO_OF_BINARIES ))
+  {
+    len = strlen( entry->d_name );
+
+    if (( len > 4 ) && !strcmp( entry->d_name + len - 4, ".bin" ) &&
+        ( snprintf( fileName, sizeof( fileName ), "%s/%s", EW_SHADER_CACHE_DIR,
+          entry->d_name ) < (int)sizeof( fileName )))
+      LoadBinary( fileName );
+  }
+
+  closedir( dir );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheDone
+*
+* DESCRIPTION:
+*   The function ShaderCacheDone writes the remaining program binaries, prints
+*   the statistic of the shader cache and releases the loaded program binaries.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheDone( void )
+{
+  int i;
+
+  /* the binaries, that are not yet stored, are written synchronously */
+  JoinWriter();
+
+  if ( CollectPending())
+    WritePending();
+
+  if ( Enabled )
+    EwPrint( "ShaderCache: %d programs loaded from the cache, %d programs linked\n",
+      NoOfLoaded, NoOfLinked );
+
+  for ( i = 0; i < NoOfBinaries; i++ )
+    free( Binaries[ i ].Data );
+
+  NoOfBinaries = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheFlush
+*
+* DESCRIPTION:
+*   The function ShaderCacheFlush starts a worker thread writing the binaries
+*   of the recently linked programs. It should be called in the idle time of
+*   the GUI thread. If the previous writer is still busy, the binaries are
+*   written with a later call.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheFlush( void )
+{
+  if ( !NoOfDirty || atomic_load( &WriterBusy ))
+    return;
+
+  JoinWriter();
+
+  if ( !CollectPending())
+    return;
+
+  atomic_store( &WriterBusy, 1 );
+
+  /* without a thread, the binaries are written immediately */
+  if ( pthread_create( &Writer, NULL, WriterThread, NULL ))
+  {
+    WritePending();
+    atomic_store( &WriterBusy, 0 );
+  }
+  else
+    WriterStarted = 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glShaderSource
+*
+* DESCRIPTION:
+*   The function __wrap_glShaderSource replaces glShaderSource() of the
+*   Graphics Engine. The hash of the source is recorded for the identification
+*   of the program binaries.
+*
+* ARGUMENTS:
+*   See glShaderSource().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glShaderSource( GLuint aShader, GLsizei aCount, const GLchar* const* aString,
+  const GLint* aLength )
+{
+  XShader* shader = Enabled ? GetShader( aShader, 1 ) : NULL;
+  int      i;
+
+  __real_glShaderSource( aShader, aCount, aString, aLength );
+
+  if ( !shader )
+    return;
+
+  shader->Hash    = 0xCBF29CE484222325ULL;
+  shader->Pending = 0;
+
+  for ( i = 0; i < aCount; i++ )
+    shader->Hash = Hash( shader->Hash, aString[ i ], ( aLength && ( aLength[ i ] >= 0 )) ?
+      (size_t)aLength[ i ] : strlen( aString[ i ]));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glCompileShader
+*
+* DESCRIPTION:
+*   The function __wrap_glCompileShader replaces glCompileShader() of the
+*   Graphics Engine. The compilation is deferred until the program is linked
+*   and no binary is found in the cache.
+*
+* ARGUMENTS:
+*   See glCompileShader().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glCompileShader( GLuint aShader )
+{
+  XShader* shader = Enabled ? GetShader( aShader, 0 ) : NULL;
+
+  if ( shader && IsSupported())
+    shader->Pending = 1;
+  else
+    __real_glCompileShader( aShader );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glGetShaderiv
+*
+* DESCRIPTION:
+*   The function __wrap_glGetShaderiv replaces glGetShaderiv() of the Graphics
+*   Engine. A shader with deferred compilation is reported as compiled without
+*   any messages - errors are reported by the linking of the program.
+*
+* ARGUMENTS:
+*   See glGetShaderiv().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glGetShaderiv( GLuint aShader, GLenum aName, GLint* aParams )
+{
+  XShader* shader = Enabled ? GetShader( aShader, 0 ) : NULL;
+
+  if ( shader && shader->Pending && ( aName == GL_COMPILE_STATUS ))
+    *aParams = GL_TRUE;
+  else if ( shader && shader->Pending && ( aName == GL_INFO_LOG_LENGTH ))
+    *aParams = 0;
+  else
+    __real_glGetShaderiv( aShader, aName, aParams );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glLinkProgram
+*
+* DESCRIPTION:
+*   The function __wrap_glLinkProgram replaces glLinkProgram() of the Graphics
+*   Engine. If the cache contains the binary of the program, it is loaded.
+*   Otherwise, the deferred shaders are compiled, the program is linked and
+*   its binary is stored in the cache.
+*
+* ARGUMENTS:
+*   See glLinkProgram().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glLinkProgram( GLuint aProgram )
+{
+  GLuint   shaders[ 4 ];
+  GLsizei  count   = 0;
+  XShader* shader;
+  XBinary* binary  = NULL;
+  uint64_t key     = 0;
+  GLint    status  = 0;
+  int      cached  = Enabled && IsSupported();
+  int      i;
+
+  if ( !Enabled )
+  {
+    __real_glLinkProgram( aProgram );
+    return;
+  }
+
+  glGetAttachedShaders( aProgram, 4, &count, shaders );
+
+  /* the program is identified by the driver and the sources of its shaders -
+     a shader, that is not tracked, prevents the caching */
+  for ( key = DriverHash, i = 0; cached && ( i < count ); i++ )
+  {
+    shader = GetShader( shaders[ i ], 0 );
+    cached = ( shader != NULL );
+
+    if ( shader )
+      key = Hash( key, &shader->Hash, sizeof( shader->Hash ));
+  }
+
+  if ( cached && (( binary = FindBinary( key )) != NULL ))
+  {
+    ProgramBinary( aProgram, binary->Format, binary->Data, binary->Length );
+    glGetProgramiv( aProgram, GL_LINK_STATUS, &status );
+
+    if ( status )
+    {
+      /* the shaders of the loaded program are never compiled */
+      for ( i = 0; i < count; i++ )
+        if (( shader = GetShader( shaders[ i ], 0 )) != NULL )
+          shader->Pending = 0;
+
+      NoOfLoaded++;
+      return;
+    }
+
+    /* the driver has rejected the binary - it is replaced */
+    EwPrint( "ShaderCache: Program binary %016llx rejected\n", (unsigned long long)key );
+  }
+
+  for ( i = 0; i < count; i++ )
+  {
+    shader = GetShader( shaders[ i ], 0 );
+
+    if ( shader && shader->Pending )
+    {
+      __real_glCompileShader( shader->Id );
+      shader->Pending = 0;
+    }
+  }
+
+  __real_glLinkProgram( aProgram );
+  glGetProgramiv( aProgram, GL_LINK_STATUS, &status );
+  NoOfLinked++;
+
+  if ( status && cached )
+    StoreBinary( key, aProgram, binary );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDeleteShader
+*
+* DESCRIPTION:
+*   The function __wrap_glDeleteShader replaces glDeleteShader() of the
+*   Graphics Engine. The entry of the shader is released, so it is available
+*   for the following shaders and a reused shader name does not inherit the
+*   hash or the deferred compilation. A shader deleted before its program is
+*   linked is compiled first - it remains attached to the program.
+*
+* ARGUMENTS:
+*   See glDeleteShader().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDeleteShader( GLuint aShader )
+{
+  XShader* shader = aShader ? GetShader( aShader, 0 ) : NULL;
+
+  if ( shader && shader->Pending )
+    __real_glCompileShader( aShader );
+
+  if ( shader )
+    memset( shader, 0, sizeof( XShader ));
+
+  __real_glDeleteShader( aShader );
+}
+
+
+/* msy */
@@ -0,0 +1,259 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template provides a persistent cache of the linked shader programs
+*   of the OpenGL adaptation. With GL_OES_get_program_binary, the binary of
+*   every linked program is stored on disk - the next start loads the binary
+*   instead of compiling and linking the shaders again. This applies to the
+*   programs created by OpenGLInit() as well as to the shader variants, that
+*   are created on their first use.
+*
+*   The compilation of a shader is deferred until the program is linked. If
+*   the cache contains a binary for the program, the shaders are never
+*   compiled. The binaries are identified by the OpenGL vendor, renderer and
+*   version and by a hash of the sources of the attached shaders - a driver
+*   update invalidates the cache.
+*
+*   At startup, all stored binaries are loaded into memory by a boot task, so
+*   the variants, that are created later, are available without any access to
+*   the storage. The binaries of newly linked programs are written by a worker
+*   thread in the idle time of the GUI thread.
+*
+*   The OpenGL functions glShaderSource(), glCompileShader(), glGetShaderiv(),
+*   glLinkProgram() and glDeleteShader() are redirected by the linker (option
+*   --wrap) to the respective __wrap_ functions.
+*
+*   The shader cache is selected by EW_SHADER_CACHE or at runtime by the
+*   environment variable EW_SHADER_CACHE ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <GLES2/gl2.h>
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheInit
+*
+* DESCRIPTION:
+*   The function ShaderCacheInit loads all stored program binaries into
+*   memory. It accesses the storage only - no OpenGL context is needed, thus
+*   the function can be executed by a worker thread. It has to be finished
+*   before the Graphics Engine is initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheDone
+*
+* DESCRIPTION:
+*   The function ShaderCacheDone writes the remaining program binaries, prints
+*   the statistic of the shader cache and releases the loaded program binaries.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   ShaderCacheFlush
+*
+* DESCRIPTION:
+*   The function ShaderCacheFlush starts a worker thread writing the binaries
+*   of the recently linked programs. It should be called in the idle time of
+*   the GUI thread. If the previous writer is still busy, the binaries are
+*   written with a later call.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void ShaderCacheFlush
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glShaderSource
+*
+* DESCRIPTION:
+*   The function __wrap_glShaderSource replaces glShaderSource() of the
+*   Graphics Engine. The hash of the source is recorded for the identification
+*   of the program binaries.
+*
+* ARGUMENTS:
+*   See glShaderSource().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glShaderSource
+(
+  GLuint                      aShader,
+  GLsizei                     aCount,
+  const GLchar* const*        aString,
+  const GLint*                aLength
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glCompileShader
+*
+* DESCRIPTION:
+*   The function __wrap_glCompileShader replaces glCompileShader() of the
+*   Graphics Engine. The compilation is deferred until the program is linked
+*   and no binary is found in the cache.
+*
+* ARGUMENTS:
+*   See glCompileShader().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glCompileShader
+(
+  GLuint                      aShader
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glGetShaderiv
+*
+* DESCRIPTION:
+*   The function __wrap_glGetShaderiv replaces glGetShaderiv() of the Graphics
+*   Engine. A shader with deferred compilation is reported as compiled without
+*   any messages - errors are reported by the linking of the program.
+*
+* ARGUMENTS:
+*   See glGetShaderiv().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glGetShaderiv
+(
+  GLuint                      aShader,
+  GLenum                      aName,
+  GLint*                      aParams
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glLinkProgram
+*
+* DESCRIPTION:
+*   The function __wrap_glLinkProgram replaces glLinkProgram() of the Graphics
+*   Engine. If the cache contains the binary of the program, it is loaded.
+*   Otherwise, the deferred shaders are compiled, the program is linked and
+*   its binary is stored in the cache.
+*
+* ARGUMENTS:
+*   See glLinkProgram().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glLinkProgram
+(
+  GLuint                      aProgram
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_glDeleteShader
+*
+* DESCRIPTION:
+*   The function __wrap_glDeleteShader replaces glDeleteShader() of the
+*   Graphics Engine. The entry of the shader is released, so it is available
+*   for the following shaders and a reused shader name does not inherit the
+*   hash or the deferred compilation. A shader deleted before its program is
+*   linked is compiled first - it remains attached to the program.
+*
+* ARGUMENTS:
+*   See glDeleteShader().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_glDeleteShader
+(
+  GLuint                      aShader
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* SHADER_CACHE_H */
+
+
+/* msy */
@@ -0,0 +1,794 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template packs the small bitmap resources into shared textures (atlas
+*   pages). Otherwise, every icon loaded by EwLoadBitmap() gets its own surface
+*   and texture - drawing a list of icons binds a new texture per icon and the
+*   draw calls can not be batched (see gpu_batch.h).
+*
+*   While a bitmap resource is loaded, the native surfaces up to the size of
+*   EW_ATLAS_MAX_BITMAP_SIZE are placed within an atlas page by a first-fit 2D
+*   allocator working on cells of ATLAS_CELL_SIZE pixel. Each bitmap keeps a
+*   transparent border, so the bi-linear filtering of warped bitmaps does not
+*   pick up the neighbours. The surface handle seen by the Graphics Engine
+*   refers to the atlas entry - the lock, copy and warp operations are
+*   redirected to the page with translated coordinates.
+*
+*   The pages are searched in the order of their recent use, so the icons used
+*   together share the same texture. Up to EW_ATLAS_MAX_PAGES pages of the size
+*   EW_ATLAS_PAGE_SIZE are created. If all pages are full, the least recently
+*   used page is evicted - its bitmaps are moved to their own textures and the
+*   page is reused for the new bitmaps. Only if the eviction fails, the new
+*   bitmap gets its own texture as before. The entries are released together
+*   with their surfaces, when the surface cache of the Graphics Engine discards
+*   them. From the empty pages only the recently used one is kept.
+*
+*   The wrapped functions see only the calls from outside the OpenGL adaptation.
+*   The calls within ewextgfx.o (e.g. by OpenGLPolygonDriver()) reach the
+*   original functions directly. Therefore only the native surfaces of bitmap
+*   resources are placed in the atlas - they serve as source of copy and warp
+*   operations only and never reach these internal paths.
+*
+*   The functions EwLoadBitmap(), OpenGLCreateSurface(), OpenGLDestroySurface(),
+*   OpenGLLockSurface(), OpenGLUnlockSurface(), OpenGLCopyDriver() and
+*   OpenGLWarpDriver() are redirected by the linker (option --wrap) to the
+*   respective __wrap_ functions.
+*
+*   The atlas is selected by EW_TEXTURE_ATLAS or at runtime by the environment
+*   variable EW_TEXTURE_ATLAS ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ewrte.h"
+#include "ewmain.h"
+#include "ewgfx.h"
+#include "opaque_bitmap.h"
+#include "texture_atlas.h"
+
+#ifndef EW_TEXTURE_ATLAS
+  #define EW_TEXTURE_ATLAS            1
+#endif
+
+#ifndef EW_ATLAS_MAX_BITMAP_SIZE
+  #define EW_ATLAS_MAX_BITMAP_SIZE    64
+#endif
+
+#ifndef EW_ATLAS_PAGE_SIZE
+  #define EW_ATLAS_PAGE_SIZE          1024
+#endif
+
+#ifndef EW_ATLAS_MAX_PAGES
+  #define EW_ATLAS_MAX_PAGES          4
+#endif
+
+/* granularity of the allocation and transparent border around each bitmap */
+#define ATLAS_CELL_SIZE               8
+#define ATLAS_BORDER                  1
+#define NO_OF_CELLS                   ( EW_ATLAS_PAGE_SIZE / ATLAS_CELL_SIZE )
+
+/* maximum number of bitmaps within all pages */
+#define MAX_NO_OF_ENTRIES             1024
+
+/* the original functions of the Graphics Engine */
+XBitmap* __real_EwLoadBitmap( const struct XBmpRes* aResource );
+unsigned long __real_OpenGLCreateSurface( int aFormat, int aWidth, int aHeight );
+void __real_OpenGLDestroySurface( unsigned long aHandle );
+unsigned long __real_OpenGLLockSurface( unsigned long aHandle, int aX, int aY,
+  int aWidth, int aHeight, int aIndex, int aCount, int aReadPixel,
+  int aWritePixel, int aReadClut, int aWriteClut, XSurfaceMemory* aMemory );
+void __real_OpenGLUnlockSurface( unsigned long aSurfaceHandle,
+  unsigned long aLockHandle, int aX, int aY, int aWidth, int aHeight, int aIndex,
+  int aCount, int aWritePixel, int aWriteClut );
+void __real_OpenGLCopyDriver( unsigned long aDstHandle, unsigned long aSrcHandle,
+  int aDstX, int aDstY, int aSrcX, int aSrcY, int aWidth, int aHeight,
+  int aBlend, unsigned long* aColors );
+void __real_OpenGLWarpDriver( unsigned long aDstHandle, unsigned long aSrcHandle,
+  float aDstX1, float aDstY1, float aDstW1, float aDstX2, float aDstY2,
+  float aDstW2, float aDstX3, float aDstY3, float aDstW3, float aDstX4,
+  float aDstY4, float aDstW4, int aSrcX, int aSrcY, int aSrcWidth,
+  int aSrcHeight, int aClipX, int aClipY, int aClipWidth, int aClipHeight,
+  int aBlend, int aFilter, unsigned long* aColors );
+
+typedef struct
+{
+  unsigned long Handle;        /* surface of the OpenGL adaptation */
+  unsigned int  Stamp;         /* recent use of the page */
+  int           UsedCells;
+  unsigned char Cells[ NO_OF_CELLS ][ NO_OF_CELLS ];
+} XAtlasPage;
+
+typedef struct
+{
+  XAtlasPage*   Page;          /* page containing the bitmap or NULL */
+  unsigned long Surface;       /* own surface of an evicted bitmap or 0 */
+  short         Width;         /* size of the bitmap in pixel */
+  short         Height;
+  short         CellX;
+  short         CellY;
+  short         CellsX;
+  short         CellsY;
+  short         X;             /* origin of the bitmap within the page */
+  short         Y;
+} XAtlasEntry;
+
+static int          Enabled = 0;
+static int          Loading = 0;     /* EwLoadBitmap() is running */
+static int          Shutdown = 0;    /* the empty pages are released at once */
+static XAtlasPage*  Pages[ EW_ATLAS_MAX_PAGES ];
+static XAtlasEntry  Entries[ MAX_NO_OF_ENTRIES ];
+static unsigned int Stamp;
+
+/* statistic of the atlas */
+static unsigned int NoOfEntries;
+static unsigned int MaxNoOfEntries;
+static unsigned int NoOfFallbacks;
+static unsigned int NoOfEvictions;
+static unsigned int MaxNoOfPages;
+
+
+/*******************************************************************************
+ * private functions
+ *******************************************************************************/
+/*
+ * helper function to get the atlas entry of a surface handle or NULL, if the
+ * surface has its own texture
+ */
+static XAtlasEntry* GetEntry( unsigned long aHandle )
+{
+  XAtlasEntry* entry = (XAtlasEntry*)aHandle;
+
+  if (( entry < Entries ) || ( entry >= Entries + MAX_NO_OF_ENTRIES ) ||
+      ( !entry->Page && !entry->Surface ))
+    return NULL;
+
+  return entry;
+}
+
+
+/*
+ * helper function to get the surface of the OpenGL adaptation containing the
+ * pixel of an entry - the coordinates are translated into the surface
+ */
+static unsigned long GetSurface( XAtlasEntry* aEntry, int* aX, int* aY )
+{
+  if ( !aEntry->Page )
+    return aEntry->Surface;
+
+  *aX += aEntry->X;
+  *aY += aEntry->Y;
+
+  return aEntry->Page->Handle;
+}
+
+
+/*
+ * helper function to find out whether an area of cells is free
+ */
+static int IsFree( XAtlasPage* aPage, int aX, int aY, int aWidth, int aHeight )
+{
+  int x;
+  int y;
+
+  for ( y = aY; y < aY + aHeight; y++ )
+    for ( x = aX; x < aX + aWidth; x++ )
+      if ( aPage->Cells[ y ][ x ])
+        return 0;
+
+  return 1;
+}
+
+
+/*
+ * helper function to mark an area of cells as used or free
+ */
+static void MarkCells( XAtlasPage* aPage, XAtlasEntry* aEntry, int aUsed )
+{
+  int y;
+
+  for ( y = aEntry->CellY; y < aEntry->CellY + aEntry->CellsY; y++ )
+    memset( &aPage->Cells[ y ][ aEntry->CellX ], aUsed, aEntry->CellsX );
+
+  aPage->UsedCells += ( aUsed ? 1 : -1 ) * aEntry->CellsX * aEntry->CellsY;
+}
+
+
+/*
+ * helper function to find the first free area of cells within a page - the
+ * rows are searched from the top, so the free space remains at the bottom
+ */
+static int PlaceEntry( XAtlasPage* aPage, XAtlasEntry* aEntry )
+{
+  int x;
+  int y;
+
+  if ( NO_OF_CELLS * NO_OF_CELLS - aPage->UsedCells < aEntry->CellsX * aEntry->CellsY )
+    return 0;
+
+  for ( y = 0; y <= NO_OF_CELLS - aEntry->CellsY; y++ )
+    for ( x = 0; x <= NO_OF_CELLS - aEntry->CellsX; x++ )
+      if ( IsFree( aPage, x, y, aEntry->CellsX, aEntry->CellsY ))
+      {
+        aEntry->CellX = x;
+        aEntry->CellY = y;
+        aEntry->Page  = aPage;
+        MarkCells( aPage, aEntry, 1 );
+        return 1;
+      }
+
+  return 0;
+}
+
+
+/*
+ * helper function to clear the area of an entry including its border - it
+ * may contain the pixel of a previously released bitmap
+ */
+static void ClearEntry( XAtlasEntry* aEntry )
+{
+  XSurfaceMemory memory;
+  unsigned long  lock;
+  int            width  = aEntry->CellsX * ATLAS_CELL_SIZE;
+  int            height = aEntry->CellsY * ATLAS_CELL_SIZE;
+  int            y;
+
+  lock = __real_OpenGLLockSurface( aEntry->Page->Handle, aEntry->CellX * ATLAS_CELL_SIZE,
+    aEntry->CellY * ATLAS_CELL_SIZE, width, height, 0, 0, 0, 1, 0, 0, &memory );
+
+  if ( !lock )
+    return;
+
+  for ( y = 0; y < height; y++ )
+    memset((char*)memory.Pixel1 + y * memory.Pitch1Y, 0, width * memory.Pitch1X );
+
+  __real_OpenGLUnlockSurface( aEntry->Page->Handle, lock, aEntry->CellX * ATLAS_CELL_SIZE,
+    aEntry->CellY * ATLAS_CELL_SIZE, width, height, 0, 0, 1, 0 );
+}
+
+
+/*
+ * helper function to move the bitmap of an entry from its page to an own
+ * surface - the handle of the entry remains valid
+ */
+static int MoveEntry( XAtlasEntry* aEntry )
+{
+  XAtlasPage*    page = aEntry->Page;
+  XSurfaceMemory src;
+  XSurfaceMemory dst;
+  unsigned long  srcLock;
+  unsigned long  dstLock = 0;
+  unsigned long  surface;
+  int            y;
+
+  surface = __real_OpenGLCreateSurface( EW_PIXEL_FORMAT_NATIVE, aEntry->Width,
+    aEntry->Height );
+
+  if ( !surface )
+    return 0;
+
+  srcLock = __real_OpenGLLockSurface( page->Handle, aEntry->X, aEntry->Y,
+    aEntry->Width, aEntry->Height, 0, 0, 1, 0, 0, 0, &src );
+
+  if ( srcLock )
+    dstLock = __real_OpenGLLockSurface( surface, 0, 0, aEntry->Width, aEntry->Height,
+      0, 0, 0, 1, 0, 0, &dst );
+
+  if ( dstLock )
+  {
+    for ( y = 0; y < aEntry->Height; y++ )
+      memcpy((char*)dst.Pixel1 + y * dst.Pitch1Y, (char*)src.Pixel1 + y * src.Pitch1Y,
+        aEntry->Width * src.Pitch1X );
+
+    __real_OpenGLUnlockSurface( surface, dstLock, 0, 0, aEntry->Width, aEntry->Height,
+      0, 0, 1, 0 );
+  }
+
+  if ( srcLock )
+    __real_OpenGLUnlockSurface( page->Handle, srcLock, aEntry->X, aEntry->Y,
+      aEntry->Width, aEntry->Height, 0, 0, 0, 0 );
+
+  if ( !dstLock )
+  {
+    __real_OpenGLDestroySurface( surface );
+    return 0;
+  }
+
+  MarkCells( page, aEntry, 0 );
+  aEntry->Page    = NULL;
+  aEntry->Surface = surface;
+
+  return 1;
+}
+
+
+/*
+ * helper function to evict the least recently used page - its bitmaps are
+ * moved to own surfaces, so the page can be reused
+ */
+static XAtlasPage* EvictPage( void )
+{
+  XAtlasPage* page = NULL;
+  int         i;
+
+  for ( i = 0; i < EW_ATLAS_MAX_PAGES; i++ )
+    if ( Pages[ i ] && ( !page || ( Pages[ i ]->Stamp < page->Stamp )))
+      page = Pages[ i ];
+
+  if ( !page )
+    return NULL;
+
+  for ( i = 0; i < MAX_NO_OF_ENTRIES; i++ )
+    if (( Entries[ i ].Page == page ) && !MoveEntry( &Entries[ i ]))
+      return NULL;
+
+  page->Stamp = ++Stamp;
+  NoOfEvictions++;
+
+  return page;
+}
+
+
+/*
+ * helper function to place a new entry within the recently used page with
+ * enough space - if necessary, a new page is created or the least recently
+ * used page is evicted
+ */
+static int AllocEntry( XAtlasEntry* aEntry )
+{
+  XAtlasPage* tried[ EW_ATLAS_MAX_PAGES ];
+  XAtlasPage* page;
+  int         noOfTried = 0;
+  int         i;
+  int         j;
+
+  /* try the pages in the order of their recent use */
+  for ( i = 0; i < EW_ATLAS_MAX_PAGES; i++ )
+  {
+    page = NULL;
+
+    for ( j = 0; j < EW_ATLAS_MAX_PAGES; j++ )
+      if ( Pages[ j ] && ( !page || ( Pages[ j ]->Stamp > page->Stamp )) &&
+         ( !noOfTried || ( Pages[ j ]->Stamp < tried[ noOfTried - 1 ]->Stamp ) ||
+         (( Pages[ j ]->Stamp == tried[ noOfTried - 1 ]->Stamp ) && ( Pages[ j ] > tried[ noOfTried - 1 ]))))
+        page = Pages[ j ];
+
+    if ( !page )
+      break;
+
+    if ( PlaceEntry( page, aEntry ))
+      return 1;
+
+    tried[ noOfTried++ ] = page;
+  }
+
+  /* all pages are full - start a new one */
+  for ( i = 0; ( i < EW_ATLAS_MAX_PAGES ) && Pages[ i ]; i++ )
+    ;
+
+  if ( i == EW_ATLAS_MAX_PAGES )
+    return (( page = EvictPage()) != NULL ) && PlaceEntry( page, aEntry );
+
+  page = calloc( 1, sizeof( XAtlasPage ));
+
+  if ( page )
+    page->Handle = __real_OpenGLCreateSurface( EW_PIXEL_FORMAT_NATIVE,
+      EW_ATLAS_PAGE_SIZE, EW_ATLAS_PAGE_SIZE );
+
+  if ( !page || !page->Handle )
+  {
+    free( page );
+    return 0;
+  }
+
+  page->Stamp = ++Stamp;
+  Pages[ i ]  = page;
+
+  for ( i = 0, j = 0; i < EW_ATLAS_MAX_PAGES; i++ )
+    j += Pages[ i ] != NULL;
+
+  if ( j > (int)MaxNoOfPages )
+    MaxNoOfPages = j;
+
+  return PlaceEntry( page, aEntry );
+}
+
+
+/*
+ * helper function to release a page without entries - from the empty pages
+ * only the recently used one is kept, unless the atlas is shut down
+ */
+static void ReleasePages( void )
+{
+  XAtlasPage* keep = NULL;
+  int         i;
+
+  if ( !Shutdown )
+    for ( i = 0; i < EW_ATLAS_MAX_PAGES; i++ )
+      if ( Pages[ i ] && !Pages[ i ]->UsedCells && ( !keep || ( Pages[ i ]->Stamp > keep->Stamp )))
+        keep = Pages[ i ];
+
+  for ( i = 0; i < EW_ATLAS_MAX_PAGES; i++ )
+    if ( Pages[ i ] && !Pages[ i ]->UsedCells && ( Pages[ i ] != keep ))
+    {
+      __real_OpenGLDestroySurface( Pages[ i ]->Handle );
+      free( Pages[ i ]);
+      Pages[ i ] = NULL;
+    }
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasInit
+*
+* DESCRIPTION:
+*   The function TextureAtlasInit selects whether the small bitmap resources
+*   are packed into atlas pages and resets the statistic. It has to be called
+*   before the Graphics Engine is initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void TextureAtlasInit( void )
+{
+
+  Enabled = EwGetEnvSwitch( "EW_TEXTURE_ATLAS", EW_TEXTURE_ATLAS );
+
+  Loading        = 0;
+  Shutdown       = 0;
+  Stamp          = 0;
+  NoOfEntries    = 0;
+  MaxNoOfEntries = 0;
+  NoOfFallbacks  = 0;
+  NoOfEvictions  = 0;
+  MaxNoOfPages   = 0;
+
+  memset( Pages, 0, sizeof( Pages ));
+  memset( Entries, 0, sizeof( Entries ));
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasDone
+*
+* DESCRIPTION:
+*   The function TextureAtlasDone prints the statistic of the atlas. Afterwards
+*   the pages are released as soon as their last bitmap is released. It has to
+*   be called before the Graphics Engine is deinitialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void TextureAtlasDone( void )
+{
+  if ( Enabled )
+    EwPrint( "TextureAtlas: %u bitmaps in %u pages at most, %u pages evicted, %u "
+      "bitmaps with own texture\n", MaxNoOfEntries, MaxNoOfPages, NoOfEvictions,
+      NoOfFallbacks );
+
+  Shutdown = 1;
+  ReleasePages();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasGetTexture
+*
+* DESCRIPTION:
+*   The function TextureAtlasGetTexture returns the surface of the OpenGL
+*   adaptation, that contains the pixel of the given surface. Surfaces with
+*   the same texture can be drawn with one draw call.
+*
+* ARGUMENTS:
+*   aHandle - Handle of the surface as stored in XSurface.
+*
+* RETURN VALUE:
+*   Returns the handle of the atlas page or of the own surface of an evicted
+*   bitmap or aHandle, if the surface has its own texture.
+*
+*******************************************************************************/
+unsigned long TextureAtlasGetTexture( unsigned long aHandle )
+{
+  XAtlasEntry* entry = GetEntry( aHandle );
+  int          x     = 0;
+  int          y     = 0;
+
+  return entry ? GetSurface( entry, &x, &y ) : aHandle;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwLoadBitmap
+*
+* DESCRIPTION:
+*   The function __wrap_EwLoadBitmap replaces EwLoadBitmap() of the Graphics
+*   Engine. The surfaces created while the resource is loaded are candidates
+*   for the atlas. Afterwards the opaque bitmaps outside the atlas are
+*   converted to the RGB565 format (see opaque_bitmap.h).
+*
+* ARGUMENTS:
+*   aResource - Descriptor of the bitmap resource to load.
+*
+* RETURN VALUE:
+*   If successful, returns the new bitmap, otherwise NULL.
+*
+*******************************************************************************/
+XBitmap* __wrap_EwLoadBitmap( const struct XBmpRes* aResource )
+{
+  XBitmap* bitmap;
+
+  Loading++;
+  bitmap = __real_EwLoadBitmap( aResource );
+  Loading--;
+
+  /* the bitmaps within the atlas pages are batched - only the bitmaps with
+     their own texture are converted. An evicted bitmap keeps its format */
+  if ( bitmap && bitmap->NoOfSurfaces && GetEntry( bitmap->Surfaces[ 0 ]->Handle ))
+    return bitmap;
+
+  return OpaqueBitmapConvert( bitmap );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLCreateSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLCreateSurface replaces OpenGLCreateSurface() of
+*   the OpenGL adaptation. Small native surfaces of bitmap resources are placed
+*   within an atlas page. Otherwise the surface gets its own texture.
+*
+* ARGUMENTS:
+*   aFormat - Pixel format of the surface.
+*   aWidth,
+*   aHeight - Size of the surface in pixel.
+*
+* RETURN VALUE:
+*   Returns the handle of the surface or 0 if failed.
+*
+*******************************************************************************/
+unsigned long __wrap_OpenGLCreateSurface( int aFormat, int aWidth, int aHeight )
+{
+  XAtlasEntry* entry = Entries;
+
+  if ( !Enabled || !Loading || ( aFormat != EW_PIXEL_FORMAT_NATIVE ) ||
+     ( aWidth > EW_ATLAS_MAX_BITMAP_SIZE ) || ( aHeight > EW_ATLAS_MAX_BITMAP_SIZE ))
+    return __real_OpenGLCreateSurface( aFormat, aWidth, aHeight );
+
+  while (( entry < Entries + MAX_NO_OF_ENTRIES ) && ( entry->Page || entry->Surface ))
+    entry++;
+
+  /* the size including the transparent border in cells */
+  if ( entry < Entries + MAX_NO_OF_ENTRIES )
+  {
+    entry->Width  = aWidth;
+    entry->Height = aHeight;
+    entry->CellsX = ( aWidth  + 2 * ATLAS_BORDER + ATLAS_CELL_SIZE - 1 ) / ATLAS_CELL_SIZE;
+    entry->CellsY = ( aHeight + 2 * ATLAS_BORDER + ATLAS_CELL_SIZE - 1 ) / ATLAS_CELL_SIZE;
+  }
+
+  if (( entry == Entries + MAX_NO_OF_ENTRIES ) || !AllocEntry( entry ))
+  {
+    NoOfFallbacks++;
+    return __real_OpenGLCreateSurface( aFormat, aWidth, aHeight );
+  }
+
+  entry->X           = entry->CellX * ATLAS_CELL_SIZE + ATLAS_BORDER;
+  entry->Y           = entry->CellY * ATLAS_CELL_SIZE + ATLAS_BORDER;
+  entry->Page->Stamp = ++Stamp;
+  ClearEntry( entry );
+
+  if ( ++NoOfEntries > MaxNoOfEntries )
+    MaxNoOfEntries = NoOfEntries;
+
+  return (unsigned long)entry;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLDestroySurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLDestroySurface replaces OpenGLDestroySurface()
+*   of the OpenGL adaptation. The area of an atlas entry or the own surface of
+*   an evicted entry is released.
+*
+* ARGUMENTS:
+*   aHandle - Handle of the surface.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLDestroySurface( unsigned long aHandle )
+{
+  XAtlasEntry* entry = GetEntry( aHandle );
+
+  if ( !entry )
+  {
+    __real_OpenGLDestroySurface( aHandle );
+    return;
+  }
+
+  if ( entry->Page )
+    MarkCells( entry->Page, entry, 0 );
+  else
+    __real_OpenGLDestroySurface( entry->Surface );
+
+  entry->Page    = NULL;
+  entry->Surface = 0;
+  NoOfEntries--;
+
+  ReleasePages();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLLockSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLLockSurface replaces OpenGLLockSurface() of the
+*   OpenGL adaptation. The lock of an atlas entry locks the area within its
+*   page.
+*
+* ARGUMENTS:
+*   See OpenGLLockSurface().
+*
+* RETURN VALUE:
+*   Returns the handle of the lock or 0 if failed.
+*
+*******************************************************************************/
+unsigned long __wrap_OpenGLLockSurface( unsigned long aHandle, int aX, int aY,
+  int aWidth, int aHeight, int aIndex, int aCount, int aReadPixel,
+  int aWritePixel, int aReadClut, int aWriteClut, XSurfaceMemory* aMemory )
+{
+  XAtlasEntry* entry = GetEntry( aHandle );
+
+  if ( entry )
+    aHandle = GetSurface( entry, &aX, &aY );
+
+  return __real_OpenGLLockSurface( aHandle, aX, aY, aWidth, aHeight, aIndex,
+    aCount, aReadPixel, aWritePixel, aReadClut, aWriteClut, aMemory );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLUnlockSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLUnlockSurface replaces OpenGLUnlockSurface() of
+*   the OpenGL adaptation. The area of an atlas entry is updated within its
+*   page.
+*
+* ARGUMENTS:
+*   See OpenGLUnlockSurface().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLUnlockSurface( unsigned long aSurfaceHandle,
+  unsigned long aLockHandle, int aX, int aY, int aWidth, int aHeight, int aIndex,
+  int aCount, int aWritePixel, int aWriteClut )
+{
+  XAtlasEntry* entry = GetEntry( aSurfaceHandle );
+
+  if ( entry )
+    aSurfaceHandle = GetSurface( entry, &aX, &aY );
+
+  __real_OpenGLUnlockSurface( aSurfaceHandle, aLockHandle, aX, aY, aWidth,
+    aHeight, aIndex, aCount, aWritePixel, aWriteClut );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLCopyDriver
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLCopyDriver replaces OpenGLCopyDriver() of the
+*   OpenGL adaptation. An atlas entry as source is copied from its page.
+*
+* ARGUMENTS:
+*   See OpenGLCopyDriver().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLCopyDriver( unsigned long aDstHandle, unsigned long aSrcHandle,
+  int aDstX, int aDstY, int aSrcX, int aSrcY, int aWidth, int aHeight,
+  int aBlend, unsigned long* aColors )
+{
+  XAtlasEntry* entry = GetEntry( aSrcHandle );
+
+  if ( entry && entry->Page )
+    entry->Page->Stamp = ++Stamp;
+
+  if ( entry )
+    aSrcHandle = GetSurface( entry, &aSrcX, &aSrcY );
+
+  __real_OpenGLCopyDriver( aDstHandle, aSrcHandle, aDstX, aDstY, aSrcX, aSrcY,
+    aWidth, aHeight, aBlend, aColors );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLWarpDriver
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLWarpDriver replaces OpenGLWarpDriver() of the
+*   OpenGL adaptation. An atlas entry as source is warped from its page.
+*
+* ARGUMENTS:
+*   See OpenGLWarpDriver().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLWarpDriver( unsigned long aDstHandle, unsigned long aSrcHandle,
+  float aDstX1, float aDstY1, float aDstW1, float aDstX2, float aDstY2,
+  float aDstW2, float aDstX3, float aDstY3, float aDstW3, float aDstX4,
+  float aDstY4, float aDstW4, int aSrcX, int aSrcY, int aSrcWidth,
+  int aSrcHeight, int aClipX, int aClipY, int aClipWidth, int aClipHeight,
+  int aBlend, int aFilter, unsigned long* aColors )
+{
+  XAtlasEntry* entry = GetEntry( aSrcHandle );
+
+  if ( entry && entry->Page )
+    entry->Page->Stamp = ++Stamp;
+
+  if ( entry )
+    aSrcHandle = GetSurface( entry, &aSrcX, &aSrcY );
+
+  __real_OpenGLWarpDriver( aDstHandle, aSrcHandle, aDstX1, aDstY1, aDstW1,
+    aDstX2, aDstY2, aDstW2, aDstX3, aDstY3, aDstW3, aDstX4, aDstY4, aDstW4,
+    aSrcX, aSrcY, aSrcWidth, aSrcHeight, aClipX, aClipY, aClipWidth,
+    aClipHeight, aBlend, aFilter, aColors );
+}
+
+
+/* msy */
@@ -0,0 +1,354 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the operating system.
+*
+*   This template packs the small bitmap resources into shared textures (atlas
+*   pages). Otherwise, every icon loaded by EwLoadBitmap() gets its own surface
+*   and texture - drawing a list of icons binds a new texture per icon and the
+*   draw calls can not be batched (see gpu_batch.h).
+*
+*   While a bitmap resource is loaded, the native surfaces up to the size of
+*   EW_ATLAS_MAX_BITMAP_SIZE are placed within an atlas page by a first-fit 2D
+*   allocator working on cells of ATLAS_CELL_SIZE pixel. Each bitmap keeps a
+*   transparent border, so the bi-linear filtering of warped bitmaps does not
+*   pick up the neighbours. The surface handle seen by the Graphics Engine
+*   refers to the atlas entry - the lock, copy and warp operations are
+*   redirected to the page with translated coordinates.
+*
+*   The pages are searched in the order of their recent use, so the icons used
+*   together share the same texture. Up to EW_ATLAS_MAX_PAGES pages of the size
+*   EW_ATLAS_PAGE_SIZE are created. If all pages are full, the bitmap gets its
+*   own texture as before. The entries are released together with their
+*   surfaces, when the surface cache of the Graphics Engine discards them.
+*   From the empty pages only the recently used one is kept.
+*
+*   The functions EwLoadBitmap(), OpenGLCreateSurface(), OpenGLDestroySurface(),
+*   OpenGLLockSurface(), OpenGLUnlockSurface(), OpenGLCopyDriver() and
+*   OpenGLWarpDriver() are redirected by the linker (option --wrap) to the
+*   respective __wrap_ functions.
+*
+*   The atlas is selected by EW_TEXTURE_ATLAS or at runtime by the environment
+*   variable EW_TEXTURE_ATLAS ("off" or "on").
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*
+*******************************************************************************/
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "ewgfx.h"
+#include "ewgfxdriver.h"
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasInit
+*
+* DESCRIPTION:
+*   The function TextureAtlasInit selects whether the small bitmap resources
+*   are packed into atlas pages and resets the statistic. It has to be called
+*   before the Graphics Engine is initialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void TextureAtlasInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasDone
+*
+* DESCRIPTION:
+*   The function TextureAtlasDone prints the statistic of the atlas. Afterwards
+*   the pages are released as soon as their last bitmap is released. It has to
+*   be called before the Graphics Engine is deinitialized.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void TextureAtlasDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   TextureAtlasGetTexture
+*
+* DESCRIPTION:
+*   The function TextureAtlasGetTexture returns the surface of the OpenGL
+*   adaptation, that contains the pixel of the given surface. Surfaces with
+*   the same texture can be drawn with one draw call.
+*
+* ARGUMENTS:
+*   aHandle - Handle of the surface as stored in XSurface.
+*
+* RETURN VALUE:
+*   Returns the handle of the atlas page or aHandle, if the surface has its own
+*   texture.
+*
+*******************************************************************************/
+unsigned long TextureAtlasGetTexture
+(
+  unsigned long               aHandle
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_EwLoadBitmap
+*
+* DESCRIPTION:
+*   The function __wrap_EwLoadBitmap replaces EwLoadBitmap() of the Graphics
+*   Engine. The surfaces created while the resource is loaded are candidates
+*   for the atlas. Afterwards the opaque bitmaps outside the atlas are
+*   converted to the RGB565 format (see opaque_bitmap.h).
+*
+* ARGUMENTS:
+*   aResource - Descriptor of the bitmap resource to load.
+*
+* RETURN VALUE:
+*   If successful, returns the new bitmap, otherwise NULL.
+*
+*******************************************************************************/
+XBitmap* __wrap_EwLoadBitmap
+(
+  const struct XBmpRes*       aResource
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLCreateSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLCreateSurface replaces OpenGLCreateSurface() of
+*   the OpenGL adaptation. Small native surfaces of bitmap resources are placed
+*   within an atlas page. Otherwise the surface gets its own texture.
+*
+* ARGUMENTS:
+*   aFormat - Pixel format of the surface.
+*   aWidth,
+*   aHeight - Size of the surface in pixel.
+*
+* RETURN VALUE:
+*   Returns the handle of the surface or 0 if failed.
+*
+*******************************************************************************/
+unsigned long __wrap_OpenGLCreateSurface
+(
+  int                         aFormat,
+  int                         aWidth,
+  int                         aHeight
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLDestroySurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLDestroySurface replaces OpenGLDestroySurface()
+*   of the OpenGL adaptation. The area of an atlas entry is released.
+*
+* ARGUMENTS:
+*   aHandle - Handle of the surface.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLDestroySurface
+(
+  unsigned long               aHandle
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLLockSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLLockSurface replaces OpenGLLockSurface() of the
+*   OpenGL adaptation. The lock of an atlas entry locks the area within its
+*   page.
+*
+* ARGUMENTS:
+*   See OpenGLLockSurface().
+*
+* RETURN VALUE:
+*   Returns the handle of the lock or 0 if failed.
+*
+*******************************************************************************/
+unsigned long __wrap_OpenGLLockSurface
+(
+  unsigned long               aHandle,
+  int                         aX,
+  int                         aY,
+  int                         aWidth,
+  int                         aHeight,
+  int                         aIndex,
+  int                         aCount,
+  int                         aReadPixel,
+  int                         aWritePixel,
+  int                         aReadClut,
+  int                         aWriteClut,
+  XSurfaceMemory*             aMemory
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLUnlockSurface
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLUnlockSurface replaces OpenGLUnlockSurface() of
+*   the OpenGL adaptation. The area of an atlas entry is updated within its
+*   page.
+*
+* ARGUMENTS:
+*   See OpenGLUnlockSurface().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLUnlockSurface
+(
+  unsigned long               aSurfaceHandle,
+  unsigned long               aLockHandle,
+  int                         aX,
+  int                         aY,
+  int                         aWidth,
+  int                         aHeight,
+  int                         aIndex,
+  int                         aCount,
+  int                         aWritePixel,
+  int                         aWriteClut
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLCopyDriver
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLCopyDriver replaces OpenGLCopyDriver() of the
+*   OpenGL adaptation. An atlas entry as source is copied from its page.
+*
+* ARGUMENTS:
+*   See OpenGLCopyDriver().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLCopyDriver
+(
+  unsigned long               aDstHandle,
+  unsigned long               aSrcHandle,
+  int                         aDstX,
+  int                         aDstY,
+  int                         aSrcX,
+  int                         aSrcY,
+  int                         aWidth,
+  int                         aHeight,
+  int                         aBlend,
+  unsigned long*              aColors
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   __wrap_OpenGLWarpDriver
+*
+* DESCRIPTION:
+*   The function __wrap_OpenGLWarpDriver replaces OpenGLWarpDriver() of the
+*   OpenGL adaptation. An atlas entry as source is warped from its page.
+*
+* ARGUMENTS:
+*   See OpenGLWarpDriver().
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void __wrap_OpenGLWarpDriver
+(
+  unsigned long               aDstHandle,
+  unsigned long               aSrcHandle,
+  float                       aDstX1,
+  float                       aDstY1,
+  float                       aDstW1,
+  float                       aDstX2,
+  float                       aDstY2,
+  float                       aDstW2,
+  float                       aDstX3,
+  float                       aDstY3,
+  float                       aDstW3,
+  float                       aDstX4,
+  float                       aDstY4,
+  float                       aDstW4,
+  int                         aSrcX,
+  int                         aSrcY,
+  int                         aSrcWidth,
+  int                         aSrcHeight,
+  int                         aClipX,
+  int                         aClipY,
+  int                         aClipWidth,
+  int                         aClipHeight,
+  int                         aBlend,
+  int                         aFilter,
+  unsigned long*              aColors
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* TEXTURE_ATLAS_H */
+
+
+/* msy */
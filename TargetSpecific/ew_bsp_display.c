@@ -30,15 +30,31 @@
 *   This implementation is prepared for using an embedded Linux system.
 *   The display is accessed by using EGL. The color format of the framebuffer
 *   has to correspond to the color format of the Graphics Engine.
+*   If the headless mode is selected (see gfx_system_headless.h), an off-screen
+*   EGL surface is used instead of the display.
 *
 *******************************************************************************/
 
+#include <time.h>
+
 #include "ewrte.h"
 #include "ewgfx.h"
 
 #include "ew_bsp_display.h"
+#include "ew_bsp_event.h"
 
 #include "gfx_system_drm.h"
+#include "gfx_system_headless.h"
+
+
+static int       Headless    = 0;
+static long long FrameVBlank = 0;  /* vblank the recent frame is drawn for */
+static int       HeadlessWidth  = 0;
+static int       HeadlessHeight = 0;
+
+#ifndef EW_FRAME_DEADLINE_OFFSET
+  #define EW_FRAME_DEADLINE_OFFSET  8
+#endif
 
 
 /*******************************************************************************
@@ -63,7 +79,33 @@
 int EwBspDisplayInit( void** aDisplay, void** aSurface, int* aFrameBuffer,
   int* aWidth, int* aHeight )
 {
-  return DrmEglInit( aDisplay, aSurface, aFrameBuffer, aWidth, aHeight );
+  Headless    = HeadlessSystemIsEnabled();
+  FrameVBlank = 0;
+
+  if ( Headless )
+  {
+    if ( !HeadlessEglInit( aDisplay, aSurface, aFrameBuffer, aWidth, aHeight ))
+      return 0;
+
+    HeadlessWidth  = *aWidth;
+    HeadlessHeight = *aHeight;
+
+    /* resume the GUI thread when the headless run is over */
+    EwBspEventAddSource( HeadlessSystemGetEventFd());
+    return 1;
+  }
+
+  if ( !DrmEglInit( aDisplay, aSurface, aFrameBuffer, aWidth, aHeight ))
+    return 0;
+
+  /* resume the GUI thread when the display reports an event (e.g. page flip)
+     or a display is connected or disconnected */
+  EwBspEventAddSource( GfxSystemGetEventFd());
+
+  if ( GfxSystemGetHotplugFd() >= 0 )
+    EwBspEventAddSource( GfxSystemGetHotplugFd());
+
+  return 1;
 }
 
 
@@ -84,6 +126,17 @@ int EwBspDisplayInit( void** aDisplay, void** aSurface, int* aFrameBuffer,
 *******************************************************************************/
 void EwBspDisplayDone( void* aDisplay, void* aSurface )
 {
+  if ( Headless )
+  {
+    EwBspEventRemoveSource( HeadlessSystemGetEventFd());
+    HeadlessEglDone( aDisplay, aSurface );
+    return;
+  }
+
+  EwBspEventRemoveSource( GfxSystemGetEventFd());
+
+  if ( GfxSystemGetHotplugFd() >= 0 )
+    EwBspEventRemoveSource( GfxSystemGetHotplugFd());
 
   DrmEglDone( aDisplay, aSurface );
 }
@@ -108,7 +161,437 @@ void EwBspDisplayDone( void* aDisplay, void* aSurface )
 *******************************************************************************/
 void EwBspDisplaySwapBuffers( void* aDisplay, void* aSurface )
 {
-  DrmEglSwapBuffers( aDisplay, aSurface );
+  if ( Headless )
+    HeadlessEglSwapBuffers( aDisplay, aSurface );
+  else
+    DrmEglSwapBuffers( aDisplay, aSurface );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplaySwapBuffersWithDamage
+*
+* DESCRIPTION:
+*   The function EwBspDisplaySwapBuffersWithDamage works like the function
+*   EwBspDisplaySwapBuffers, but passes the area that has changed since the
+*   previous frame to the display.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aArea       - Changed area relative to the top-left corner of the display.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspDisplaySwapBuffersWithDamage( void* aDisplay, void* aSurface,
+  XRect aArea )
+{
+  if ( Headless )
+  {
+    HeadlessEglSwapBuffers( aDisplay, aSurface );
+    return;
+  }
+
+  DrmEglSwapBuffersWithDamage( aDisplay, aSurface, aArea.Point1.X, aArea.Point1.Y,
+    aArea.Point2.X - aArea.Point1.X, aArea.Point2.Y - aArea.Point1.Y );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetNoOfDisplays
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetNoOfDisplays returns the number of displays
+*   initialized by EwBspDisplayInit(). The first display is the one returned
+*   by EwBspDisplayInit().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the number of displays.
+*
+*******************************************************************************/
+int EwBspDisplayGetNoOfDisplays( void )
+{
+  if ( Headless )
+    return 1;
+
+  return GfxSystemGetNoOfDisplays();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetSurface
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetSurface returns the EGL surface of a display.
+*   All displays share the EGL display returned by EwBspDisplayInit(). Before
+*   drawing on the surface, it has to be selected by the function
+*   EwBspDisplayMakeCurrent().
+*
+* ARGUMENTS:
+*   aIndex       - Index of the display (0 .. EwBspDisplayGetNoOfDisplays() - 1).
+*   aSurface     - Pointer to return EGL surface.
+*   aFrameBuffer - Pointer to return the framebuffer.
+*   aWidth       - Pointer to return the width of the framebuffer in pixel.
+*   aHeight      - Pointer to return the height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspDisplayGetSurface( int aIndex, void** aSurface, int* aFrameBuffer,
+  int* aWidth, int* aHeight )
+{
+  /* the headless mode provides one off-screen surface only */
+  if ( Headless )
+    return 0;
+
+  return DrmEglGetSurface( aIndex, aSurface, aFrameBuffer, aWidth, aHeight );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetSize
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetSize returns the size of a display. If the UI is
+*   rendered at reduced resolution (see EwBspDisplaySetRenderScale()), the
+*   framebuffer is smaller than the display.
+*
+* ARGUMENTS:
+*   aIndex   - Index of the display (0 .. EwBspDisplayGetNoOfDisplays() - 1).
+*   aWidth   - Pointer to return the width of the display in pixel.
+*   aHeight  - Pointer to return the height of the display in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspDisplayGetSize( int aIndex, int* aWidth, int* aHeight )
+{
+  /* the off-screen surface is never scaled */
+  if ( Headless )
+  {
+    if ( aIndex )
+      return 0;
+
+    *aWidth  = HeadlessWidth;
+    *aHeight = HeadlessHeight;
+    return 1;
+  }
+
+  return GfxSystemGetDisplaySize( aIndex, aWidth, aHeight );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplaySetRenderScale
+*
+* DESCRIPTION:
+*   The function EwBspDisplaySetRenderScale changes the resolution, the UI of a
+*   display is rendered with. The display controller scales the framebuffer up
+*   to the size of the display. The surface is replaced by a new one, that is
+*   selected for the following drawing operations - its content is undefined.
+*
+* ARGUMENTS:
+*   aDisplay - EGL display.
+*   aSurface - Pointer to the EGL surface of the display. Returns the new EGL
+*     surface.
+*   aScale   - Render resolution in percent of the display size (25 .. 100).
+*   aWidth   - Pointer to return the new width of the framebuffer in pixel.
+*   aHeight  - Pointer to return the new height of the framebuffer in pixel.
+*
+* RETURN VALUE:
+*   Returns 1 if the surface has been replaced, 0 if the scale is unchanged or
+*   not supported by the display.
+*
+*******************************************************************************/
+int EwBspDisplaySetRenderScale( void* aDisplay, void** aSurface, int aScale,
+  int* aWidth, int* aHeight )
+{
+  if ( Headless )
+    return 0;
+
+  return DrmEglSetRenderScale( aDisplay, aSurface, aScale, aWidth, aHeight );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayProcessHotplug
+*
+* DESCRIPTION:
+*   The function EwBspDisplayProcessHotplug evaluates, whether displays have
+*   been connected, disconnected or have changed their mode. A reconnected
+*   display may get a new surface with a new size, the other resources of the
+*   GPU (e.g. textures and glyph caches) are kept.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if the surfaces have to be queried again by the function
+*   EwBspDisplayGetSurface() and the displays have to be redrawn, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspDisplayProcessHotplug( void )
+{
+  if ( Headless )
+    return 0;
+
+  return DrmEglProcessHotplug();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetBackgroundSurface
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetBackgroundSurface returns the EGL surface of the
+*   background layer, that is shown by its own hardware plane below the UI.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the EGL surface or NULL if there is no background layer.
+*
+*******************************************************************************/
+void* EwBspDisplayGetBackgroundSurface( void )
+{
+  if ( Headless )
+    return 0;
+
+  return DrmEglGetBackgroundSurface();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayMakeCurrent
+*
+* DESCRIPTION:
+*   The function EwBspDisplayMakeCurrent selects the EGL surface for the
+*   following drawing operations - the UI surface of a display or the surface
+*   of the background layer.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface to draw on.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspDisplayMakeCurrent( void* aDisplay, void* aSurface )
+{
+  if ( !Headless )
+    DrmEglMakeCurrent( aDisplay, aSurface );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplaySwapBackground
+*
+* DESCRIPTION:
+*   The function EwBspDisplaySwapBackground shows the recently drawn content of
+*   the background layer.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface of the background layer.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspDisplaySwapBackground( void* aDisplay, void* aSurface )
+{
+  if ( !Headless )
+    DrmEglSwapBackground( aDisplay, aSurface );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetBufferAge
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetBufferAge returns the number of frames since
+*   the content of the current back buffer was shown on the display. This
+*   information is used to redraw only the areas changed in the meantime.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*
+* RETURN VALUE:
+*   Returns the age of the back buffer, 0 if its content is undefined or -1 if
+*   the display does not support the buffer age.
+*
+*******************************************************************************/
+int EwBspDisplayGetBufferAge( void* aDisplay, void* aSurface )
+{
+  /* the off-screen surface is always redrawn completely */
+  if ( Headless )
+    return -1;
+
+  return DrmEglGetBufferAge( aDisplay, aSurface );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplaySetDamage
+*
+* DESCRIPTION:
+*   The function EwBspDisplaySetDamage informs the display about the area of
+*   the back buffer that will be redrawn within the current frame. The rest of
+*   the back buffer remains untouched. The function has to be called before the
+*   screen update starts.
+*
+* ARGUMENTS:
+*   aEglDisplay - EGL display.
+*   aEglSurface - EGL surface.
+*   aArea       - Area to redraw relative to the top-left corner of the display.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspDisplaySetDamage( void* aDisplay, void* aSurface, XRect aArea )
+{
+  if ( Headless )
+    return;
+
+  DrmEglSetDamage( aDisplay, aSurface, aArea.Point1.X, aArea.Point1.Y,
+    aArea.Point2.X - aArea.Point1.X, aArea.Point2.Y - aArea.Point1.Y );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetNextVBlank
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetNextVBlank returns the expected time, when a
+*   frame that is rendered now will appear on the display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the time in microseconds (CLOCK_MONOTONIC) or 0 if unknown.
+*
+*******************************************************************************/
+long long EwBspDisplayGetNextVBlank( void )
+{
+  if ( Headless )
+    return HeadlessSystemGetNextVBlank();
+
+  return GfxSystemGetNextVBlank();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetFramePeriod
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetFramePeriod returns the duration of one frame,
+*   i.e. the distance between two vblanks of the display.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the frame duration in microseconds or 0 if unknown.
+*
+*******************************************************************************/
+long long EwBspDisplayGetFramePeriod( void )
+{
+  if ( Headless )
+    return HeadlessSystemGetFramePeriod();
+
+  return GfxSystemGetFramePeriod();
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayGetFrameTimeout
+*
+* DESCRIPTION:
+*   The function EwBspDisplayGetFrameTimeout returns the time until the next
+*   frame should be drawn. The drawing starts EW_FRAME_DEADLINE_OFFSET ms before
+*   the vblank, the frame is presented with. All changes arriving until then
+*   are drawn together and only one frame is drawn per vblank.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns the time in milliseconds or 0 if the frame should be drawn now.
+*
+*******************************************************************************/
+int EwBspDisplayGetFrameTimeout( void )
+{
+  struct timespec ts;
+  long long       vblank = EwBspDisplayGetNextVBlank();
+  long long       start;
+  long long       now;
+
+  /* without known refresh timing, the frame is drawn immediately */
+  if ( !vblank )
+    return 0;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  now = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+
+  /* the recent frame still waits for its vblank - no further frame until then,
+     otherwise start the drawing at the deadline before the next vblank */
+  if ( vblank <= FrameVBlank )
+    start = FrameVBlank;
+  else
+    start = vblank - EW_FRAME_DEADLINE_OFFSET * 1000LL;
+
+  if ( now >= start )
+    return 0;
+
+  return (int)(( start - now + 999 ) / 1000 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspDisplayBeginFrame
+*
+* DESCRIPTION:
+*   The function EwBspDisplayBeginFrame has to be called before a frame is
+*   drawn. It assigns the frame to the next vblank, so no further frame is
+*   drawn for this vblank.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspDisplayBeginFrame( void )
+{
+  FrameVBlank = EwBspDisplayGetNextVBlank();
 }
 
 
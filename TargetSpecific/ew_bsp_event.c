@@ -0,0 +1,272 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the board support package (BSP) of a dedicated
+*   target.
+*   This template is responsible to suspend the GUI thread as long as nothing
+*   has to be done and to resume it as soon as an event source (e.g. input
+*   device, display, console or worker thread) has new data or the next
+*   Embedded Wizard timer expires.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*   In order to provide a starting point for you, the current implementation
+*   is prepared for using an embedded Linux system.
+*   All event sources are file descriptors observed by one epoll instance. The
+*   timer is realized by a timerfd and worker threads can wake up the GUI thread
+*   via an eventfd.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "ewrte.h"
+
+#include "ew_bsp_event.h"
+
+
+/* maximum number of event sources reported by one call of epoll_wait() */
+#define MAX_EVENTS                      16
+
+static int EpollFd = -1;  /* epoll instance observing all event sources */
+static int EventFd = -1;  /* eventfd used by EwBspEventTrigger() */
+static int TimerFd = -1;  /* timerfd armed for the next timer expiration */
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventInit
+*
+* DESCRIPTION:
+*   The function EwBspEventInit initializes the event handling of the GUI
+*   thread. Afterwards event sources can be registered by EwBspEventAddSource().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspEventInit( void )
+{
+  EpollFd = epoll_create1( EPOLL_CLOEXEC );
+  EventFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+  TimerFd = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+
+  if (( EpollFd < 0 ) || ( EventFd < 0 ) || ( TimerFd < 0 ) ||
+      !EwBspEventAddSource( EventFd ) || !EwBspEventAddSource( TimerFd ))
+  {
+    EwBspEventDone();
+    return 0;
+  }
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventDone
+*
+* DESCRIPTION:
+*   The function EwBspEventDone terminates the event handling of the GUI thread
+*   and releases all used resources.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventDone( void )
+{
+  if ( TimerFd >= 0 )
+    close( TimerFd );
+
+  if ( EventFd >= 0 )
+    close( EventFd );
+
+  if ( EpollFd >= 0 )
+    close( EpollFd );
+
+  TimerFd = -1;
+  EventFd = -1;
+  EpollFd = -1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventAddSource
+*
+* DESCRIPTION:
+*   The function EwBspEventAddSource registers the given file descriptor as
+*   event source. As soon as the file descriptor becomes readable, a pending
+*   EwBspEventWait() returns. Reading the data remains the job of the owner of
+*   the file descriptor.
+*
+* ARGUMENTS:
+*   aFd - File descriptor to observe.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspEventAddSource( int aFd )
+{
+  struct epoll_event event;
+
+  if (( EpollFd < 0 ) || ( aFd < 0 ))
+    return 0;
+
+  memset( &event, 0, sizeof( event ));
+  event.events  = EPOLLIN;
+  event.data.fd = aFd;
+
+  if ( epoll_ctl( EpollFd, EPOLL_CTL_ADD, aFd, &event ) < 0 )
+  {
+    EwPrint( "EwBspEventAddSource: Cannot observe fd %d (errno %d)!\n", aFd, errno );
+    return 0;
+  }
+
+  return 1;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventRemoveSource
+*
+* DESCRIPTION:
+*   The function EwBspEventRemoveSource removes a file descriptor previously
+*   registered by EwBspEventAddSource().
+*
+* ARGUMENTS:
+*   aFd - File descriptor to remove.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventRemoveSource( int aFd )
+{
+  if (( EpollFd >= 0 ) && ( aFd >= 0 ))
+    epoll_ctl( EpollFd, EPOLL_CTL_DEL, aFd, NULL );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventTrigger
+*
+* DESCRIPTION:
+*   The function EwBspEventTrigger wakes up the GUI thread from a pending
+*   EwBspEventWait(). The function can be called from any thread, e.g. from
+*   a worker thread that has new data for the GUI application.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventTrigger( void )
+{
+  uint64_t value = 1;
+
+  /* the counter of the eventfd is reset by the GUI thread - a failing write
+     means that the counter is saturated and a wakeup is pending anyway */
+  if (( EventFd >= 0 ) && ( write( EventFd, &value, sizeof( value )) != sizeof( value )))
+    value = 0;
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventWait
+*
+* DESCRIPTION:
+*   The function EwBspEventWait suspends the GUI thread until one of the
+*   registered event sources becomes readable, EwBspEventTrigger() is called or
+*   the given timeout expires.
+*
+* ARGUMENTS:
+*   aTimeout - Maximum time to wait in milliseconds. If 0, the function returns
+*     immediately. If negative, the function waits without timeout.
+*
+* RETURN VALUE:
+*   Returns the number of signalled event sources (including the expired timer
+*   and the trigger), 0 in case of a timeout without any event.
+*
+*******************************************************************************/
+int EwBspEventWait( int aTimeout )
+{
+  struct epoll_event events[ MAX_EVENTS ];
+  struct itimerspec  timer;
+  uint64_t           value;
+  int                noOfEvents;
+  int                i;
+
+  if ( EpollFd < 0 )
+    return 0;
+
+  /* arm the timer for the next expiration - a zero value disarms the timer */
+  memset( &timer, 0, sizeof( timer ));
+
+  if ( aTimeout > 0 )
+  {
+    timer.it_value.tv_sec  = aTimeout / 1000;
+    timer.it_value.tv_nsec = ( aTimeout % 1000 ) * 1000000;
+  }
+
+  timerfd_settime( TimerFd, 0, &timer, NULL );
+
+  /* suspend the GUI thread until something happens */
+  noOfEvents = epoll_wait( EpollFd, events, MAX_EVENTS, ( aTimeout == 0 ) ? 0 : -1 );
+
+  /* interrupted by a signal - let the caller process the current state */
+  if ( noOfEvents < 0 )
+    return 0;
+
+  /* consume the internal events - all other sources are read by their owner */
+  for ( i = 0; i < noOfEvents; i++ )
+  {
+    if ((( events[ i ].data.fd == EventFd ) || ( events[ i ].data.fd == TimerFd )) &&
+        ( read( events[ i ].data.fd, &value, sizeof( value )) != sizeof( value )))
+      value = 0;
+  }
+
+  return noOfEvents;
+}
+
+
+/* msy */
@@ -0,0 +1,189 @@
+/*******************************************************************************
+*
+* E M B E D D E D   W I Z A R D   P R O J E C T
+*
+*                                                Copyright (c) TARA Systems GmbH
+*                                    written by Paul Banach and Manfred Schweyer
+*
+********************************************************************************
+*
+* This software is delivered "as is" and shows the usage of other software
+* components. It is provided as an example software which is intended to be
+* modified and extended according to particular requirements.
+*
+* TARA Systems hereby disclaims all warranties and conditions with regard to the
+* software, including all implied warranties and conditions of merchantability
+* and non-infringement of any third party IPR or other rights which may result
+* from the use or the inability to use the software.
+*
+********************************************************************************
+*
+* DESCRIPTION:
+*   This file is part of the interface (glue layer) between an Embedded Wizard
+*   generated UI application and the board support package (BSP) of a dedicated
+*   target.
+*   This template is responsible to suspend the GUI thread as long as nothing
+*   has to be done and to resume it as soon as an event source (e.g. input
+*   device, display, console or worker thread) has new data or the next
+*   Embedded Wizard timer expires.
+*
+*   Important: This file is intended to be used as a template. Please adapt the
+*   implementation and declarations according your particular hardware.
+*   In order to provide a starting point for you, the current implementation
+*   is prepared for using an embedded Linux system.
+*   All event sources are file descriptors observed by one epoll instance. The
+*   timer is realized by a timerfd and worker threads can wake up the GUI thread
+*   via an eventfd.
+*
+*******************************************************************************/
+
+#ifndef EW_BSP_EVENT_H
+#define EW_BSP_EVENT_H
+
+
+#ifdef __cplusplus
+  extern "C"
+  {
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventInit
+*
+* DESCRIPTION:
+*   The function EwBspEventInit initializes the event handling of the GUI
+*   thread. Afterwards event sources can be registered by EwBspEventAddSource().
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspEventInit
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventDone
+*
+* DESCRIPTION:
+*   The function EwBspEventDone terminates the event handling of the GUI thread
+*   and releases all used resources.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventDone
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventAddSource
+*
+* DESCRIPTION:
+*   The function EwBspEventAddSource registers the given file descriptor as
+*   event source. As soon as the file descriptor becomes readable, a pending
+*   EwBspEventWait() returns. Reading the data remains the job of the owner of
+*   the file descriptor.
+*
+* ARGUMENTS:
+*   aFd - File descriptor to observe.
+*
+* RETURN VALUE:
+*   Returns 1 if successful, 0 otherwise.
+*
+*******************************************************************************/
+int EwBspEventAddSource
+(
+  int                         aFd
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventRemoveSource
+*
+* DESCRIPTION:
+*   The function EwBspEventRemoveSource removes a file descriptor previously
+*   registered by EwBspEventAddSource().
+*
+* ARGUMENTS:
+*   aFd - File descriptor to remove.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventRemoveSource
+(
+  int                         aFd
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventTrigger
+*
+* DESCRIPTION:
+*   The function EwBspEventTrigger wakes up the GUI thread from a pending
+*   EwBspEventWait(). The function can be called from any thread, e.g. from
+*   a worker thread that has new data for the GUI application.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspEventTrigger
+(
+  void
+);
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspEventWait
+*
+* DESCRIPTION:
+*   The function EwBspEventWait suspends the GUI thread until one of the
+*   registered event sources becomes readable, EwBspEventTrigger() is called or
+*   the given timeout expires.
+*
+* ARGUMENTS:
+*   aTimeout - Maximum time to wait in milliseconds. If 0, the function returns
+*     immediately. If negative, the function waits without timeout.
+*
+* RETURN VALUE:
+*   Returns the number of signalled event sources (including the expired timer
+*   and the trigger), 0 in case of a timeout without any event.
+*
+*******************************************************************************/
+int EwBspEventWait
+(
+  int                         aTimeout
+);
+
+
+#ifdef __cplusplus
+  }
+#endif
+
+#endif /* EW_BSP_EVENT_H */
+
+
+/* msy */
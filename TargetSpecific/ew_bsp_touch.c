@@ -30,7 +30,13 @@
 *   In order to provide a starting point for you, the current implementation
 *   is prepared for using an embedded Linux system.
 *   The touch positions are read in a separate thread from the touch input device
-*   (e.g. /dev/input/event0).
+*   (e.g. /dev/input/event0). With every SYN_REPORT the thread publishes the
+*   complete state of all fingers as timestamped touch frame in a lock-free
+*   single-producer/single-consumer ring. The GUI thread drains the ring and
+*   derives the touch events frame by frame - in this manner no begin or end of
+*   a touch cycle gets lost, even if it occurs between two calls.
+*   The positions of moving fingers are extrapolated to the time the next frame
+*   appears on the display (see EW_TOUCH_PREDICTION_HORIZON).
 *
 *******************************************************************************/
 
@@ -39,16 +45,21 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/fcntl.h>
+#include <sys/ioctl.h>
 
 #include <linux/input.h>
 
 #include "ewrte.h"
 
 #include "ew_bsp_touch.h"
+#include "boot_trace.h"
+#include "ew_bsp_event.h"
 
 
 #define DEFAULT_TOUCH_DEVICE  "/dev/input/event0"
@@ -57,6 +68,21 @@
 #define DELTA_TOUCH                     16
 #define DELTA_TIME                      500
 
+/* capacity of the touch frame ring - has to be a power of two */
+#define NO_OF_TOUCH_FRAMES              64
+
+/* maximum number of touch events returned by one EwBspTouchGetEvents() call */
+#define MAX_TOUCH_EVENTS                ( 4 * NO_OF_FINGERS )
+
+/* number of recent touch positions per finger and their maximum age in us
+   used to estimate the velocity of a finger */
+#define NO_OF_TOUCH_SAMPLES             4
+#define VELOCITY_TIME_SPAN              50000
+
+#ifndef EW_TOUCH_PREDICTION_HORIZON
+  #define EW_TOUCH_PREDICTION_HORIZON   0
+#endif
+
 /* additional touch flag to indicate idle state */
 #define EW_BSP_TOUCH_IDLE               0
 
@@ -71,22 +97,68 @@ typedef struct
   unsigned long Ticks;     /* time of recent touch event */
   int           TouchId;   /* constant touch ID provided by touch controller */
   unsigned char State;     /* current state within a touch cycle */
+  int           NoOfSamples;                       /* recent positions, newest first */
+  long long     SampleTime[ NO_OF_TOUCH_SAMPLES ]; /* kernel timestamp in us */
+  int           SampleX[ NO_OF_TOUCH_SAMPLES ];
+  int           SampleY[ NO_OF_TOUCH_SAMPLES ];
 } XTouchData;
 
-static int           ShutDown        = 0;
+/* structure to store the state of all slots of the touch controller at the
+   time of a SYN_REPORT */
+typedef struct
+{
+  long long     Time;                     /* kernel timestamp in microseconds */
+  int           TouchX[ NO_OF_FINGERS ];  /* position as read from the device */
+  int           TouchY[ NO_OF_FINGERS ];
+  int           TouchId[ NO_OF_FINGERS ]; /* tracking ID or -1 if not touched */
+} XTouchFrame;
+
+static volatile int  ShutDown        = 0;
 
 static int           GuiSizeWidth    = 0; /* width of the GUI application (EwScreenSize.X) */
 static int           GuiSizeHeight   = 0; /* height of the GUI application (EwScreenSize.Y) */
 static int           TouchAreaWidth  = 0; /* width of the window or framebuffer */
 static int           TouchAreaHeight = 0; /* height of the window or framebuffer */
 
-static XTouchEvent   TouchEvent[ NO_OF_FINGERS ];
+static XTouchEvent   TouchEvent[ MAX_TOUCH_EVENTS ];
 static XTouchData    TouchData[ NO_OF_FINGERS ];
+static long long     PresentationTime = 0; /* target time of the touch prediction */
+
+/* ring of touch frames - written by the touch event thread at TouchFrameHead
+   and read by the GUI thread at TouchFrameTail */
+static XTouchFrame   TouchFrames[ NO_OF_TOUCH_FRAMES ];
+static atomic_uint   TouchFrameHead;
+static atomic_uint   TouchFrameTail;
+
+
+/*******************************************************************************
+* FUNCTION:
+*   PublishTouchFrame
+*
+* DESCRIPTION:
+*   The function PublishTouchFrame stores a copy of the given touch frame in
+*   the ring and makes it visible for the GUI thread. If the ring is full, the
+*   function waits until the GUI thread has taken over a frame - no frame gets
+*   lost. Meanwhile the touch input device buffers the further events.
+*
+* ARGUMENTS:
+*   aFrame - Touch frame to publish.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void PublishTouchFrame( const XTouchFrame* aFrame )
+{
+  unsigned int head = atomic_load_explicit( &TouchFrameHead, memory_order_relaxed );
 
-/* current touch information read from input device within touch event thread */
-static int           TouchX[ NO_OF_FINGERS ];
-static int           TouchY[ NO_OF_FINGERS ];
-static int           TouchId[ NO_OF_FINGERS ];
+  while (( head - atomic_load_explicit( &TouchFrameTail, memory_order_acquire ) >= NO_OF_TOUCH_FRAMES )
+         && !ShutDown )
+    usleep( 1000 );
+
+  TouchFrames[ head % NO_OF_TOUCH_FRAMES ] = *aFrame;
+  atomic_store_explicit( &TouchFrameHead, head + 1, memory_order_release );
+}
 
 
 /*******************************************************************************
@@ -95,7 +167,7 @@ static int           TouchId[ NO_OF_FINGERS ];
 *
 * DESCRIPTION:
 *   The function TouchEventThread implements an independend thread to read data
-*   from the touch controller and to provide them as touch events for the
+*   from the touch controller and to provide them as touch frames for the
 *   EmWi application. The thread is running until the flag ShutDown is set.
 *   This function may be adapted to the touch driver of your hardware.
 *
@@ -109,6 +181,7 @@ static int           TouchId[ NO_OF_FINGERS ];
 static void* TouchEventThread( void* aArg )
 {
   struct input_event events[ 64 ];
+  XTouchFrame        frame;
   int                i;
   int                rd;
   int                touchDev;
@@ -117,25 +190,36 @@ static void* TouchEventThread( void* aArg )
   int                touchY = 0;
   int                touchSlot = 0;
   int                touchId = 0;
+  int                clockId = CLOCK_MONOTONIC;
+  int                bootPhase;
+  int                report;
+
+  /* suppress 'unused parameter' warnings */
+  (void)aArg;
 
   if (( touchDevName = getenv( "EW_TOUCHDEVICE" )) == NULL )
     touchDevName = DEFAULT_TOUCH_DEVICE;
 
-  /* get access to touch events from input device */
-  touchDev = open( touchDevName, O_RDONLY );
+  /* get access to touch events from input device - concurrently to the
+     initialization of the GUI thread */
+  bootPhase = BootTraceBegin( "Touch device open" );
+  touchDev  = open( touchDevName, O_RDONLY );
+  BootTraceEnd( bootPhase );
+
   if ( touchDev < 0 )
   {
     EwPrint( "Error: failed to open touch input device %s.\n", touchDevName );
     return 0;
   }
 
+  /* timestamp the events with the same clock as the display */
+  ioctl( touchDev, EVIOCSCLOCKID, &clockId );
+
   /* clear all current touch state variables */
+  memset( &frame, 0, sizeof( frame ));
+
   for ( i = 0; i < NO_OF_FINGERS; i++ )
-  {
-    TouchX[ i ]  = 0;
-    TouchY[ i ]  = 0;
-    TouchId[ i ] = -1;
-  }
+    frame.TouchId[ i ] = -1;
 
   /* loop forever until main application is finished */
   while ( !ShutDown )
@@ -147,7 +231,9 @@ static void* TouchEventThread( void* aArg )
     if ( rd < (int) sizeof( struct input_event ) )
       break;
 
-    for ( i = 0; i < rd / sizeof( struct input_event ); i++ )
+    report = 0;
+
+    for ( i = 0; i < rd / (int)sizeof( struct input_event ); i++ )
     {
       unsigned int type;
       unsigned int code;
@@ -162,13 +248,21 @@ static void* TouchEventThread( void* aArg )
       {
         if (( touchSlot >= 0 ) && ( touchSlot < NO_OF_FINGERS ))
         {
-          TouchX[ touchSlot ]  = touchX;
-          TouchY[ touchSlot ]  = touchY;
-          TouchId[ touchSlot ] = touchId;
+          frame.TouchX[ touchSlot ]  = touchX;
+          frame.TouchY[ touchSlot ]  = touchY;
+          frame.TouchId[ touchSlot ] = touchId;
           // EwPrint( "Touch Event slot %d, id %d, x %d, y %d\n", touchSlot, touchId, touchX, touchY );
         }
       }
 
+      /* the state of all slots is complete - pass it to the GUI thread */
+      if ( type == SYN_REPORT )
+      {
+        frame.Time = events[ i ].time.tv_sec * 1000000LL + events[ i ].time.tv_usec;
+        PublishTouchFrame( &frame );
+        report = 1;
+      }
+
       /* read next touch parameters */
       if ( type == EV_ABS )
       {
@@ -185,13 +279,17 @@ static void* TouchEventThread( void* aArg )
           /* read back all current values when slot has changed */
           if (( touchSlot >= 0 ) && ( touchSlot < NO_OF_FINGERS ))
           {
-            touchX  = TouchX[ touchSlot ];
-            touchY  = TouchY[ touchSlot ];
-            touchId = TouchId[ touchSlot ];
+            touchX  = frame.TouchX[ touchSlot ];
+            touchY  = frame.TouchY[ touchSlot ];
+            touchId = frame.TouchId[ touchSlot ];
           }
         }
       }
     }
+
+    /* wake up the GUI thread to take over the new touch frames */
+    if ( report )
+      EwBspEventTrigger();
   }
 
   /* finally, close the input device */
@@ -203,129 +301,72 @@ static void* TouchEventThread( void* aArg )
 
 /*******************************************************************************
 * FUNCTION:
-*   EwBspTouchInit
-*
-* DESCRIPTION:
-*   Initalizes the touch driver interface.
-*
-* ARGUMENTS:
-*   aGuiWidth - Width of the GUI application in pixel.
-*   aGuiHeight - Height of the GUI application in pixel.
-*   aTouchWidth - Width of the window or framebuffer (touchable area) in pixel.
-*   aTouchHeight - Height of the window or framebuffer (touchable area) in pixel.
-*
-* RETURN VALUE:
-*   None
-*
-*******************************************************************************/
-void EwBspTouchInit( int aGuiWidth, int aGuiHeight, int aTouchWidth, int aTouchHeight )
-{
-  pthread_t      touchEventThread;
-  pthread_attr_t threadAttr;
-
-  GuiSizeWidth    = aGuiWidth;
-  GuiSizeHeight   = aGuiHeight;
-  TouchAreaWidth  = aTouchWidth;
-  TouchAreaHeight = aTouchHeight;
-  ShutDown = 0;
-
-  /* clear all touch state variables */
-  memset( TouchData, 0, sizeof( TouchData ));
-
-  /* create thread for touch events */
-  pthread_attr_init( &threadAttr );
-  pthread_attr_setdetachstate( &threadAttr, PTHREAD_CREATE_JOINABLE );
-  pthread_create( &touchEventThread, &threadAttr, TouchEventThread, NULL );
-  pthread_attr_destroy( &threadAttr );
-  usleep( 100 );
-}
-
-
-/*******************************************************************************
-* FUNCTION:
-*   EwBspTouchDone
-*
-* DESCRIPTION:
-*   Terminates the touch driver.
-*
-* ARGUMENTS:
-*   None
-*
-* RETURN VALUE:
-*   None
-*
-*******************************************************************************/
-void EwBspTouchDone( void )
-{
-  ShutDown = 1;
-  usleep( 100 );
-}
-
-
-/*******************************************************************************
-* FUNCTION:
-*   EwBspTouchGetEvents
+*   ProcessTouchFrame
 *
 * DESCRIPTION:
-*   The function EwBspTouchGetEvents reads the current touch positions from the
-*   touch driver and returns the current touch position and touch status of the
-*   different fingers. The returned number of touch events indicates the number
-*   of XTouchEvent that contain position and status information.
-*   The orientation of the touch positions is adjusted to match GUI coordinates.
-*   If the hardware supports only single touch, the finger number is always 0.
+*   The function ProcessTouchFrame assigns the touch positions of the given
+*   touch frame to the fingers and appends the resulting touch events to the
+*   array TouchEvent. Consecutive move events of a finger are combined into one
+*   event with the latest position. Begin and end of a touch cycle are always
+*   reported.
 *
 * ARGUMENTS:
-*   aTouchEvent - Pointer to return array of XTouchEvent.
+*   aFrame      - Touch frame to process.
+*   aNoOfEvents - Number of touch events already stored in TouchEvent.
+*   aMoveEvent  - Array with the index of the pending move event of each finger
+*     within TouchEvent or -1 if there is none.
 *
 * RETURN VALUE:
-*   Returns the number of detected touch events, otherwise 0.
+*   Returns the new number of touch events stored in TouchEvent.
 *
 *******************************************************************************/
-int EwBspTouchGetEvents( XTouchEvent** aTouchEvent )
+static int ProcessTouchFrame( const XTouchFrame* aFrame, int aNoOfEvents,
+  int* aMoveEvent )
 {
   int           x, y;
   int           t;
   int           f;
+  int           s;
   unsigned long ticks;
-  int           noOfEvents = 0;
   int           finger;
+  int           state;
   char          identified[ NO_OF_FINGERS ];
   XTouchData*   touch;
 
   /* all fingers have the state unidentified */
   memset( identified, 0, sizeof( identified ));
 
-  /* get current time in ms */
-  ticks = EwGetTicks();
+  /* get time of the touch frame in ms */
+  ticks = (unsigned long)( aFrame->Time / 1000 );
 
-  /* iterate through all potential touch events from the touch event thread */
+  /* iterate through all potential touch events of the touch frame */
   for ( t = 0; t < NO_OF_FINGERS; t++ )
   {
     /* check for valid coordinates */
-    if (( TouchId[ t ] < 0 ) ||
-        ( TouchX[ t ] <= 0 ) || ( TouchX[ t ] > TouchAreaWidth ) ||
-        ( TouchY[ t ] <= 0 ) || ( TouchY[ t ] > TouchAreaHeight ))
+    if (( aFrame->TouchId[ t ] < 0 ) ||
+        ( aFrame->TouchX[ t ] <= 0 ) || ( aFrame->TouchX[ t ] > TouchAreaWidth ) ||
+        ( aFrame->TouchY[ t ] <= 0 ) || ( aFrame->TouchY[ t ] > TouchAreaHeight ))
       continue;
 
     #if ( EW_ROTATION == 90 )
 
-      x = TouchY[ t ] * GuiSizeWidth / TouchAreaHeight;
-      y = ( TouchAreaWidth - TouchX[ t ] ) * GuiSizeHeight / TouchAreaWidth;
+      x = aFrame->TouchY[ t ] * GuiSizeWidth / TouchAreaHeight;
+      y = ( TouchAreaWidth - aFrame->TouchX[ t ] ) * GuiSizeHeight / TouchAreaWidth;
 
     #elif ( EW_ROTATION == 270 )
 
-      x = ( TouchAreaHeight - TouchY[ t ] ) * GuiSizeWidth / TouchAreaHeight;
-      y = TouchX[ t ] * GuiSizeHeight / TouchAreaWidth;
+      x = ( TouchAreaHeight - aFrame->TouchY[ t ] ) * GuiSizeWidth / TouchAreaHeight;
+      y = aFrame->TouchX[ t ] * GuiSizeHeight / TouchAreaWidth;
 
     #elif ( EW_ROTATION == 180 )
 
-      x = ( TouchAreaWidth - TouchX[ t ] ) * GuiSizeWidth / TouchAreaWidth;
-      y = ( TouchAreaHeight - TouchY[ t ] ) * GuiSizeHeight / TouchAreaHeight;
+      x = ( TouchAreaWidth - aFrame->TouchX[ t ] ) * GuiSizeWidth / TouchAreaWidth;
+      y = ( TouchAreaHeight - aFrame->TouchY[ t ] ) * GuiSizeHeight / TouchAreaHeight;
 
     #else
 
-      x = TouchX[ t ] * GuiSizeWidth / TouchAreaWidth;
-      y = TouchY[ t ] * GuiSizeHeight / TouchAreaHeight;
+      x = aFrame->TouchX[ t ] * GuiSizeWidth / TouchAreaWidth;
+      y = aFrame->TouchY[ t ] * GuiSizeHeight / TouchAreaHeight;
 
     #endif
 
@@ -335,7 +376,7 @@ int EwBspTouchGetEvents( XTouchEvent** aTouchEvent )
       touch = &TouchData[ f ];
 
       /* check if the finger is already active */
-      if (( touch->State != EW_BSP_TOUCH_IDLE ) && ( touch->TouchId == TouchId[ t ]))
+      if (( touch->State != EW_BSP_TOUCH_IDLE ) && ( touch->TouchId == aFrame->TouchId[ t ]))
       {
         finger = f;
         break;
@@ -373,42 +414,258 @@ int EwBspTouchGetEvents( XTouchEvent** aTouchEvent )
       /* store current touch parameter */
       touch->XPos    = x;
       touch->YPos    = y;
-      touch->TouchId = TouchId[ t ];
+      touch->TouchId = aFrame->TouchId[ t ];
       touch->Ticks   = ticks;
+
+      /* keep the recent positions with their timestamps for the prediction */
+      if ( touch->State == EW_BSP_TOUCH_DOWN )
+        touch->NoOfSamples = 0;
+
+      if ( touch->NoOfSamples < NO_OF_TOUCH_SAMPLES )
+        touch->NoOfSamples++;
+
+      for ( s = touch->NoOfSamples - 1; s > 0; s-- )
+      {
+        touch->SampleTime[ s ] = touch->SampleTime[ s - 1 ];
+        touch->SampleX[ s ]    = touch->SampleX[ s - 1 ];
+        touch->SampleY[ s ]    = touch->SampleY[ s - 1 ];
+      }
+
+      touch->SampleTime[ 0 ] = aFrame->Time;
+      touch->SampleX[ 0 ]    = x;
+      touch->SampleY[ 0 ]    = y;
     }
   }
 
-  /* prepare sequence of touch events suitable for Embedded Wizard GUI application */
+  /* append the touch events of this frame to the sequence of touch events */
   for ( f = 0; f < NO_OF_FINGERS; f++ )
   {
     touch = &TouchData[ f ];
 
     /* begin of a touch cycle */
     if ( identified[ f ] && ( touch->State == EW_BSP_TOUCH_DOWN ))
-      TouchEvent[ noOfEvents ].State = EW_BSP_TOUCH_DOWN;
+      state = EW_BSP_TOUCH_DOWN;
 
     /* move within a touch cycle */
     else if ( identified[ f ] && ( touch->State == EW_BSP_TOUCH_MOVE ))
-      TouchEvent[ noOfEvents ].State = EW_BSP_TOUCH_MOVE;
+      state = EW_BSP_TOUCH_MOVE;
 
     /* end of a touch cycle */
     else if ( !identified[ f ] && ( touch->State != EW_BSP_TOUCH_IDLE ))
     {
-      TouchEvent[ noOfEvents ].State = EW_BSP_TOUCH_UP;
+      state = EW_BSP_TOUCH_UP;
       touch->State = EW_BSP_TOUCH_IDLE;
     }
     else
       continue;
 
-    TouchEvent[ noOfEvents ].XPos   = touch->XPos;
-    TouchEvent[ noOfEvents ].YPos   = touch->YPos;
-    TouchEvent[ noOfEvents ].Finger = f;
+    /* combine the movement with the pending move event of the same finger */
+    if (( state == EW_BSP_TOUCH_MOVE ) && ( aMoveEvent[ f ] >= 0 ))
+    {
+      TouchEvent[ aMoveEvent[ f ]].XPos = touch->XPos;
+      TouchEvent[ aMoveEvent[ f ]].YPos = touch->YPos;
+      continue;
+    }
+
+    aMoveEvent[ f ] = ( state == EW_BSP_TOUCH_MOVE ) ? aNoOfEvents : -1;
+
+    TouchEvent[ aNoOfEvents ].State  = state;
+    TouchEvent[ aNoOfEvents ].XPos   = touch->XPos;
+    TouchEvent[ aNoOfEvents ].YPos   = touch->YPos;
+    TouchEvent[ aNoOfEvents ].Finger = f;
+
+    // EwPrint( "Touch event for finger %d with state %d ( %4d, %4d )\n", f, state, touch->XPos, touch->YPos );
+
+    aNoOfEvents++;
+  }
+
+  return aNoOfEvents;
+}
+
 
-    // EwPrint( "Touch event for finger %d with state %d ( %4d, %4d )\n", f, TouchEvent[ noOfEvents ].State, TouchEvent[ noOfEvents ].XPos, TouchEvent[ noOfEvents ].YPos );
+#if EW_TOUCH_PREDICTION_HORIZON > 0
+/*******************************************************************************
+* FUNCTION:
+*   PredictTouchEvent
+*
+* DESCRIPTION:
+*   The function PredictTouchEvent extrapolates the position of the given move
+*   event to the time PresentationTime. The velocity of the finger is estimated
+*   from its recent positions and kernel timestamps. The extrapolation is
+*   limited to EW_TOUCH_PREDICTION_HORIZON milliseconds.
+*
+* ARGUMENTS:
+*   aEvent - Move event to adjust.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+static void PredictTouchEvent( XTouchEvent* aEvent )
+{
+  XTouchData*     touch = &TouchData[ aEvent->Finger ];
+  struct timespec ts;
+  long long       target = PresentationTime;
+  long long       horizon;
+  long long       span;
+  int             x, y;
+  int             s;
+
+  /* the finger has been lifted meanwhile - keep its real position */
+  if ( touch->State == EW_BSP_TOUCH_IDLE )
+    return;
+
+  /* find the oldest position within the time span to estimate the velocity */
+  for ( s = touch->NoOfSamples - 1; ( s > 0 ) &&
+        ( touch->SampleTime[ 0 ] - touch->SampleTime[ s ] > VELOCITY_TIME_SPAN ); s-- )
+    ;
+
+  span = touch->SampleTime[ 0 ] - touch->SampleTime[ s ];
+  if (( s == 0 ) || ( span <= 0 ))
+    return;
+
+  /* without known presentation time, the position is predicted for now */
+  if ( !target )
+  {
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    target = ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+  }
+
+  horizon = target - touch->SampleTime[ 0 ];
+
+  if ( horizon <= 0 )
+    return;
+  if ( horizon > EW_TOUCH_PREDICTION_HORIZON * 1000 )
+    horizon = EW_TOUCH_PREDICTION_HORIZON * 1000;
+
+  x = touch->SampleX[ 0 ] + (int)(( touch->SampleX[ 0 ] - touch->SampleX[ s ]) * horizon / span );
+  y = touch->SampleY[ 0 ] + (int)(( touch->SampleY[ 0 ] - touch->SampleY[ s ]) * horizon / span );
+
+  /* keep the predicted position within the GUI */
+  aEvent->XPos = ( x < 0 ) ? 0 : ( x >= GuiSizeWidth  ) ? GuiSizeWidth  - 1 : x;
+  aEvent->YPos = ( y < 0 ) ? 0 : ( y >= GuiSizeHeight ) ? GuiSizeHeight - 1 : y;
+}
+#endif
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspTouchInit
+*
+* DESCRIPTION:
+*   Initalizes the touch driver interface.
+*
+* ARGUMENTS:
+*   aGuiWidth - Width of the GUI application in pixel.
+*   aGuiHeight - Height of the GUI application in pixel.
+*   aTouchWidth - Width of the window or framebuffer (touchable area) in pixel.
+*   aTouchHeight - Height of the window or framebuffer (touchable area) in pixel.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspTouchInit( int aGuiWidth, int aGuiHeight, int aTouchWidth, int aTouchHeight )
+{
+  pthread_t      touchEventThread;
+  pthread_attr_t threadAttr;
+
+  GuiSizeWidth    = aGuiWidth;
+  GuiSizeHeight   = aGuiHeight;
+  TouchAreaWidth  = aTouchWidth;
+  TouchAreaHeight = aTouchHeight;
+  ShutDown = 0;
+
+  /* clear all touch state variables */
+  memset( TouchData, 0, sizeof( TouchData ));
+  atomic_store( &TouchFrameHead, 0 );
+  atomic_store( &TouchFrameTail, 0 );
+
+  /* create thread for touch events */
+  pthread_attr_init( &threadAttr );
+  pthread_attr_setdetachstate( &threadAttr, PTHREAD_CREATE_JOINABLE );
+  pthread_create( &touchEventThread, &threadAttr, TouchEventThread, NULL );
+  pthread_attr_destroy( &threadAttr );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspTouchDone
+*
+* DESCRIPTION:
+*   Terminates the touch driver.
+*
+* ARGUMENTS:
+*   None
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspTouchDone( void )
+{
+  ShutDown = 1;
+  usleep( 100 );
+}
+
+
+/*******************************************************************************
+* FUNCTION:
+*   EwBspTouchGetEvents
+*
+* DESCRIPTION:
+*   The function EwBspTouchGetEvents reads the touch frames received from the
+*   touch driver since the last call and returns the resulting touch positions
+*   and touch status of the different fingers. Several movements of a finger
+*   are combined into one event, begin and end of a touch cycle are never
+*   dropped. The returned number of touch events indicates the number
+*   of XTouchEvent that contain position and status information.
+*   The orientation of the touch positions is adjusted to match GUI coordinates.
+*   If the hardware supports only single touch, the finger number is always 0.
+*
+* ARGUMENTS:
+*   aTouchEvent - Pointer to return array of XTouchEvent.
+*
+* RETURN VALUE:
+*   Returns the number of detected touch events, otherwise 0.
+*
+*******************************************************************************/
+int EwBspTouchGetEvents( XTouchEvent** aTouchEvent )
+{
+  unsigned int head;
+  unsigned int tail;
+  int          noOfEvents = 0;
+  int          moveEvent[ NO_OF_FINGERS ];
+  int          f;
+
+  /* no finger has a pending move event */
+  for ( f = 0; f < NO_OF_FINGERS; f++ )
+    moveEvent[ f ] = -1;
+
+  tail = atomic_load_explicit( &TouchFrameTail, memory_order_relaxed );
+  head = atomic_load_explicit( &TouchFrameHead, memory_order_acquire );
 
-    noOfEvents++;
+  /* process the touch frames in the order of their occurrence - every frame
+     results in one event per finger at most */
+  while (( tail != head ) && ( noOfEvents + NO_OF_FINGERS <= MAX_TOUCH_EVENTS ))
+  {
+    noOfEvents = ProcessTouchFrame( &TouchFrames[ tail % NO_OF_TOUCH_FRAMES ],
+      noOfEvents, moveEvent );
+    atomic_store_explicit( &TouchFrameTail, ++tail, memory_order_release );
   }
 
+  /* the remaining touch frames are processed within the next cycle */
+  if ( tail != head )
+    EwBspEventTrigger();
+
+  /* compensate the latency between touch controller and display */
+  #if EW_TOUCH_PREDICTION_HORIZON > 0
+    for ( f = 0; f < noOfEvents; f++ )
+      if ( TouchEvent[ f ].State == EW_BSP_TOUCH_MOVE )
+        PredictTouchEvent( &TouchEvent[ f ]);
+  #endif
+
   /* return the prepared touch events and the number of prepared touch events */
   if ( aTouchEvent )
     *aTouchEvent = TouchEvent;
@@ -417,4 +674,28 @@ int EwBspTouchGetEvents( XTouchEvent** aTouchEvent )
 }
 
 
+/*******************************************************************************
+* FUNCTION:
+*   EwBspTouchSetPresentationTime
+*
+* DESCRIPTION:
+*   The function EwBspTouchSetPresentationTime informs the touch driver about
+*   the time, when the next frame will appear on the display. The positions of
+*   moving fingers returned by the following EwBspTouchGetEvents() call are
+*   extrapolated to this time.
+*
+* ARGUMENTS:
+*   aTime - Expected presentation time in microseconds (CLOCK_MONOTONIC) or 0
+*     if unknown.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspTouchSetPresentationTime( long long aTime )
+{
+  PresentationTime = aTime;
+}
+
+
 /* msy */
@@ -124,9 +124,11 @@ void EwBspTouchDone
 *   EwBspTouchGetEvents
 *
 * DESCRIPTION:
-*   The function EwBspTouchGetEvents reads the current touch positions from the
-*   touch driver and returns the current touch position and touch status of the
-*   different fingers. The returned number of touch events indicates the number
+*   The function EwBspTouchGetEvents reads the touch frames received from the
+*   touch driver since the last call and returns the resulting touch positions
+*   and touch status of the different fingers. Several movements of a finger
+*   are combined into one event, begin and end of a touch cycle are never
+*   dropped. The returned number of touch events indicates the number
 *   of XTouchEvent that contain position and status information.
 *   The orientation of the touch positions is adjusted to match GUI coordinates.
 *   If the hardware supports only single touch, the finger number is always 0.
@@ -144,6 +146,30 @@ int EwBspTouchGetEvents
 );
 
 
+/*******************************************************************************
+* FUNCTION:
+*   EwBspTouchSetPresentationTime
+*
+* DESCRIPTION:
+*   The function EwBspTouchSetPresentationTime informs the touch driver about
+*   the time, when the next frame will appear on the display. The positions of
+*   moving fingers returned by the following EwBspTouchGetEvents() call are
+*   extrapolated to this time.
+*
+* ARGUMENTS:
+*   aTime - Expected presentation time in microseconds (CLOCK_MONOTONIC) or 0
+*     if unknown.
+*
+* RETURN VALUE:
+*   None
+*
+*******************************************************************************/
+void EwBspTouchSetPresentationTime
+(
+  long long                   aTime
+);
+
+
 /*******************************************************************************
 * FUNCTION:
 *   EwBspTouchEventHandler